@@ -1,5 +1,8 @@
 // baseglwidget.cpp
 #include "baseglwidget.h"
+#include "shaderregistry.h"
+#include "bufferupload.h"
+#include "../meshutils/simd_convert.h"
 #include <QFile>
 #include <QDebug>
 #include <QMouseEvent>
@@ -14,6 +17,9 @@
 #include <QPainter>
 #include <QFont>
 #include <cfloat>
+#include <climits>
+#include <cstddef>
+#include <chrono>
 
 BaseGLWidget::BaseGLWidget(QWidget *parent) : QOpenGLWidget(parent),
     vbo(QOpenGLBuffer::VertexBuffer),
@@ -53,6 +59,12 @@ BaseGLWidget::BaseGLWidget(QWidget *parent) : QOpenGLWidget(parent),
     
     showAxis = false;  // 修改为false，默认不显示坐标轴
     specularEnabled = false;  // 添加这行，默认不显示高光
+
+    GpuMemoryBudget::instance().registerWidget(this, [this]() {
+        makeCurrent();
+        releaseGpuBuffers();
+        doneCurrent();
+    });
 }
 
 void BaseGLWidget::setShowAxis(bool show) {
@@ -81,6 +93,7 @@ void BaseGLWidget::setWireframeColor(const QVector4D& color) {
 }
 
 BaseGLWidget::~BaseGLWidget() {
+    GpuMemoryBudget::instance().unregisterWidget(this);
     makeCurrent();
     vao.destroy();
     vbo.destroy();
@@ -147,30 +160,16 @@ void BaseGLWidget::initializeGL() {
     axisEbo.bind();
     axisEbo.allocate(axisIndices, sizeof(axisIndices));
     
-    axisProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/axis.vert");
-    axisProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/axis.frag");
-    axisProgram.link();
+    axisProgram = ShaderRegistry::instance().axis();
 
     initializeShaders();
 }
 
 void BaseGLWidget::initializeShaders() {
-    wireframeProgram.removeAllShaders();
-    blinnPhongProgram.removeAllShaders();
-    flatProgram.removeAllShaders();  // 确保清除旧的着色器
-
-    wireframeProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/wireframe.vert");
-    wireframeProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/wireframe.frag");
-    wireframeProgram.link();
-    
-    blinnPhongProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/blinnphong.vert");
-    blinnPhongProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/blinnphong.frag");
-    blinnPhongProgram.link();
-    
-    // 添加Flat Shading着色器
-    flatProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/flat.vert");
-    flatProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/flat.frag");
-    flatProgram.link();
+    // 着色器程序由注册表统一编译，各窗口共享同一份
+    wireframeProgram = ShaderRegistry::instance().wireframe();
+    blinnPhongProgram = ShaderRegistry::instance().blinnPhong();
+    flatProgram = ShaderRegistry::instance().flat();
 
     if (modelLoaded) {
         updateBuffersFromOpenMesh();
@@ -180,55 +179,35 @@ void BaseGLWidget::initializeShaders() {
 void BaseGLWidget::updateBuffersFromOpenMesh() {
     if (openMesh.n_vertices() == 0) return;
     
-    std::vector<float> vertices(openMesh.n_vertices() * 3);
-    std::vector<float> normals(openMesh.n_vertices() * 3);
-    std::vector<float> curvatures(openMesh.n_vertices());
+    // 缓冲区可能已被显存预算回收，create()对已创建的缓冲区无影响
+    vbo.create();
+    ebo.create();
+    faceEbo.create();
+    
+    const size_t vertexCount = openMesh.n_vertices();
     
-    for (auto vh : openMesh.vertices()) {
-        int idx = vh.idx();
-        const auto& p = openMesh.point(vh);
-        vertices[idx*3]   = p[0];
-        vertices[idx*3+1] = p[1];
-        vertices[idx*3+2] = p[2];
-        
-        const auto& n = openMesh.normal(vh);
-        normals[idx*3]   = n[0];
-        normals[idx*3+1] = n[1];
-        normals[idx*3+2] = n[2];
-        
-        curvatures[idx] = openMesh.data(vh).curvature;
-    }
+    // 压缩为12字节顶点：位置相对包围盒量化为16位，法线八面体编码
+    Mesh::Point min, max;
+    computeBoundingBox(min, max);
+    packingBounds = packingBoundsFromBox(min.data(), max.data());
     
     vao.bind();
     vbo.bind();
     
-    int vertexSize = vertices.size() * sizeof(float);
-    int normalSize = normals.size() * sizeof(float);
-    int curvatureSize = curvatures.size() * sizeof(float);
-    vbo.allocate(vertexSize + normalSize + curvatureSize);
-    vbo.write(0, vertices.data(), vertexSize);
-    vbo.write(vertexSize, normals.data(), normalSize);
-    vbo.write(vertexSize + normalSize, curvatures.data(), curvatureSize);
-    
-    wireframeProgram.bind();
-    int posLoc = wireframeProgram.attributeLocation("aPos");
-    if (posLoc != -1) {
-        wireframeProgram.enableAttributeArray(posLoc);
-        wireframeProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
-    }
-    
-    blinnPhongProgram.bind();
-    posLoc = blinnPhongProgram.attributeLocation("aPos");
-    if (posLoc != -1) {
-        blinnPhongProgram.enableAttributeArray(posLoc);
-        blinnPhongProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
-    }
-    
-    int normalLoc = blinnPhongProgram.attributeLocation("aNormal");
-    if (normalLoc != -1) {
-        blinnPhongProgram.enableAttributeArray(normalLoc);
-        blinnPhongProgram.setAttributeBuffer(normalLoc, GL_FLOAT, vertexSize, 3, 3 * sizeof(float));
-    }
+    // 从网格连续的点/法线属性数组直接打包进映射的VBO（SIMD内核，运行时选择指令集）
+    auto packStart = std::chrono::high_resolution_clock::now();
+    const double* points = openMesh.points()->data();
+    const double* normals = openMesh.has_vertex_normals() ? openMesh.vertex_normals()->data() : nullptr;
+    uploadMappedBuffer(vbo, static_cast<int>(vertexCount * sizeof(PackedVertex)), [&](void* dst) {
+        simd::packVertices(points, normals, nullptr, vertexCount, packingBounds,
+                           static_cast<PackedVertex*>(dst));
+    });
+    auto packEnd = std::chrono::high_resolution_clock::now();
+    qDebug() << "Vertex packing (" << simd::levelName(simd::detectedLevel()) << "):" << vertexCount << "vertices in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(packEnd - packStart).count() << "us";
+    
+    setupPackedVertexAttributes(wireframeProgram);
+    setupPackedVertexAttributes(blinnPhongProgram);
 
     ebo.bind();
     ebo.allocate(edges.data(), edges.size() * sizeof(unsigned int));
@@ -237,6 +216,52 @@ void BaseGLWidget::updateBuffersFromOpenMesh() {
     faceEbo.allocate(faces.data(), faces.size() * sizeof(unsigned int));
     
     vao.release();
+
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "vbo", vbo.size());
+    budget.track(this, "ebo", ebo.size());
+    budget.track(this, "faceEbo", faceEbo.size());
+    buffersResident = true;
+}
+
+void BaseGLWidget::setupPackedVertexAttributes(QOpenGLShaderProgram* program) {
+    // setAttributeBuffer以normalized=GL_TRUE设置属性，整型分量在着色器中读出为[0,1]/[-1,1]
+    program->bind();
+    int posLoc = program->attributeLocation("aPos");
+    if (posLoc != -1) {
+        program->enableAttributeArray(posLoc);
+        program->setAttributeBuffer(posLoc, GL_UNSIGNED_SHORT, offsetof(PackedVertex, pos), 3, sizeof(PackedVertex));
+    }
+    
+    int normalLoc = program->attributeLocation("aNormal");
+    if (normalLoc != -1) {
+        program->enableAttributeArray(normalLoc);
+        program->setAttributeBuffer(normalLoc, GL_SHORT, offsetof(PackedVertex, normal), 2, sizeof(PackedVertex));
+    }
+}
+
+void BaseGLWidget::setPositionDequantization(QOpenGLShaderProgram* program) {
+    program->setUniformValue("posOffset", QVector3D(packingBounds.offset[0], packingBounds.offset[1], packingBounds.offset[2]));
+    program->setUniformValue("posScale", QVector3D(packingBounds.scale[0], packingBounds.scale[1], packingBounds.scale[2]));
+}
+
+void BaseGLWidget::releaseGpuBuffers() {
+    vbo.destroy();
+    ebo.destroy();
+    faceEbo.destroy();
+    buffersResident = false;
+
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "vbo", 0);
+    budget.track(this, "ebo", 0);
+    budget.track(this, "faceEbo", 0);
+}
+
+void BaseGLWidget::ensureBuffersResident() {
+    GpuMemoryBudget::instance().touch(this);
+    if (modelLoaded && !buffersResident) {
+        updateBuffersFromOpenMesh();
+    }
 }
 
 void BaseGLWidget::resizeGL(int w, int h) {
@@ -250,6 +275,8 @@ void BaseGLWidget::paintGL() {
         return;
     }
 
+    ensureBuffersResident();
+
     QMatrix4x4 model, view, projection;
     
     model.rotate(rotation);
@@ -258,7 +285,7 @@ void BaseGLWidget::paintGL() {
     QVector3D eyePosition(0, 0, viewDistance * viewScale);
     view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
     
-    projection.perspective(45.0f, width() / float(height()), 0.1f, 100.0f);
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
     
     QMatrix3x3 normalMatrix = model.normalMatrix();
 
@@ -282,58 +309,60 @@ void BaseGLWidget::paintGL() {
     } else {
         // 基类只实现BlinnPhong渲染，曲率渲染在派生类中实现
         if (currentRenderMode == BlinnPhong) {
-            blinnPhongProgram.bind();
+            blinnPhongProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            blinnPhongProgram.setUniformValue("model", model);
-            blinnPhongProgram.setUniformValue("view", view);
-            blinnPhongProgram.setUniformValue("projection", projection);
-            blinnPhongProgram.setUniformValue("normalMatrix", normalMatrix);
+            blinnPhongProgram->setUniformValue("model", model);
+            setPositionDequantization(blinnPhongProgram);
+            blinnPhongProgram->setUniformValue("view", view);
+            blinnPhongProgram->setUniformValue("projection", projection);
+            blinnPhongProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                blinnPhongProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                blinnPhongProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                blinnPhongProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                blinnPhongProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            blinnPhongProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            blinnPhongProgram.setUniformValue("objectColor", surfaceColor);
-            blinnPhongProgram.setUniformValue("specularEnabled", specularEnabled);
+            blinnPhongProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            blinnPhongProgram->setUniformValue("objectColor", surfaceColor);
+            blinnPhongProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            blinnPhongProgram.release();
+            blinnPhongProgram->release();
         } else if (currentRenderMode == FlatShading) {
             // Flat Shading渲染
-            flatProgram.bind();
+            flatProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            flatProgram.setUniformValue("model", model);
-            flatProgram.setUniformValue("view", view);
-            flatProgram.setUniformValue("projection", projection);
-            flatProgram.setUniformValue("normalMatrix", normalMatrix);
+            flatProgram->setUniformValue("model", model);
+            setPositionDequantization(flatProgram);
+            flatProgram->setUniformValue("view", view);
+            flatProgram->setUniformValue("projection", projection);
+            flatProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                flatProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                flatProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                flatProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                flatProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            flatProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            flatProgram.setUniformValue("objectColor", surfaceColor);
-            flatProgram.setUniformValue("specularEnabled", specularEnabled);
+            flatProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            flatProgram->setUniformValue("objectColor", surfaceColor);
+            flatProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            flatProgram.release();
+            flatProgram->release();
         }
 
         if (showWireframeOverlay) {
@@ -477,21 +506,22 @@ void BaseGLWidget::centerView() {
 }
 
 void BaseGLWidget::drawWireframe(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection) {
-    wireframeProgram.bind();
+    wireframeProgram->bind();
     vao.bind();
     ebo.bind();
 
     glLineWidth(1.5f);
-    wireframeProgram.setUniformValue("model", model);
-    wireframeProgram.setUniformValue("view", view);
-    wireframeProgram.setUniformValue("projection", projection);
-    wireframeProgram.setUniformValue("lineColor", wireframeColor);
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("lineColor", wireframeColor);
 
     glDrawElements(GL_LINES, edges.size(), GL_UNSIGNED_INT, 0);
     
     ebo.release();
     vao.release();
-    wireframeProgram.release();
+    wireframeProgram->release();
 }
 
 void BaseGLWidget::drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection) {
@@ -500,20 +530,21 @@ void BaseGLWidget::drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     glLineWidth(1.5f);
     
-    wireframeProgram.bind();
+    wireframeProgram->bind();
     vao.bind();
     ebo.bind();
 
-    wireframeProgram.setUniformValue("model", model);
-    wireframeProgram.setUniformValue("view", view);
-    wireframeProgram.setUniformValue("projection", projection);
-    wireframeProgram.setUniformValue("lineColor", wireframeColor);
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("lineColor", wireframeColor);
 
     glDrawElements(GL_LINES, edges.size(), GL_UNSIGNED_INT, 0);
     
     ebo.release();
     vao.release();
-    wireframeProgram.release();
+    wireframeProgram->release();
     glDisable(GL_POLYGON_OFFSET_LINE);
 }
 
@@ -523,27 +554,27 @@ void BaseGLWidget::drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& project
     
     glDisable(GL_DEPTH_TEST);
     
-    axisProgram.bind();
+    axisProgram->bind();
     
     QMatrix4x4 model;
     model.translate(modelCenter);
     model.scale(0.8f);
     model.rotate(rotation);
     
-    axisProgram.setUniformValue("model", model);
-    axisProgram.setUniformValue("view", view);
-    axisProgram.setUniformValue("projection", projection);
+    axisProgram->setUniformValue("model", model);
+    axisProgram->setUniformValue("view", view);
+    axisProgram->setUniformValue("projection", projection);
     
     axisVbo.bind();
     axisEbo.bind();
     
-    int posLoc = axisProgram.attributeLocation("aPos");
-    axisProgram.enableAttributeArray(posLoc);
-    axisProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 6 * sizeof(float));
+    int posLoc = axisProgram->attributeLocation("aPos");
+    axisProgram->enableAttributeArray(posLoc);
+    axisProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 6 * sizeof(float));
     
-    int colorLoc = axisProgram.attributeLocation("aColor");
-    axisProgram.enableAttributeArray(colorLoc);
-    axisProgram.setAttributeBuffer(colorLoc, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
+    int colorLoc = axisProgram->attributeLocation("aColor");
+    axisProgram->enableAttributeArray(colorLoc);
+    axisProgram->setAttributeBuffer(colorLoc, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
     
     glLineWidth(3.0f);
     glDrawElements(GL_LINES, 6, GL_UNSIGNED_INT, 0);
@@ -552,18 +583,194 @@ void BaseGLWidget::drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& project
         glEnable(GL_DEPTH_TEST);
     }
     
-    axisProgram.disableAttributeArray(posLoc);
-    axisProgram.disableAttributeArray(colorLoc);
+    axisProgram->disableAttributeArray(posLoc);
+    axisProgram->disableAttributeArray(colorLoc);
     axisEbo.release();
     axisVbo.release();
-    axisProgram.release();
+    axisProgram->release();
 }
 
 void BaseGLWidget::clearMeshData() {
     openMesh.clear();
     faces.clear();
+    triangleToFace.clear();
     edges.clear();
+    edgeSlots.clear();
+    geometryCache.clear();
     modelLoaded = false;
+    ++geometryVersion;
+}
+
+bool BaseGLWidget::moveVertex(Mesh::VertexHandle vh, const Mesh::Point& position) {
+    if (!modelLoaded || !vh.is_valid() || vh.idx() >= static_cast<int>(openMesh.n_vertices())) return false;
+
+    openMesh.set_point(vh, position);
+    applyLocalEdit({ vh });
+    return true;
+}
+
+bool BaseGLWidget::flipEdge(Mesh::EdgeHandle eh) {
+    if (!modelLoaded || !eh.is_valid() || eh.idx() >= static_cast<int>(openMesh.n_edges())) return false;
+
+    // flip_openmesh按两侧各三条半边重连，只能用于两个三角形之间的边（多边形网格中的四边形等不能翻转）
+    auto h0 = openMesh.halfedge_handle(eh, 0);
+    auto h1 = openMesh.halfedge_handle(eh, 1);
+    if (openMesh.is_boundary(eh) || openMesh.valence(openMesh.face_handle(h0)) != 3 ||
+        openMesh.valence(openMesh.face_handle(h1)) != 3) {
+        return false;
+    }
+
+    if (!flip_openmesh(eh, openMesh)) return false;
+
+    Mesh::FaceHandle changedFaces[2] = { openMesh.face_handle(h0), openMesh.face_handle(h1) };
+    std::vector<Mesh::VertexHandle> dirty;
+    for (auto fh : changedFaces) {
+        for (auto vh : openMesh.fv_range(fh)) {
+            dirty.push_back(vh);
+        }
+    }
+
+    // 边索引：原位替换被翻转的边（边列表只用于绘制，顺序无关）
+    unsigned int newFrom = openMesh.from_vertex_handle(h0).idx();
+    unsigned int newTo = openMesh.to_vertex_handle(h0).idx();
+    if (newFrom > newTo) std::swap(newFrom, newTo);
+    int edgeSlot = eh.idx() < static_cast<int>(edgeSlots.size()) ? edgeSlots[eh.idx()] : -1;
+    if (edgeSlot >= 0) {
+        edges[edgeSlot * 2] = newFrom;
+        edges[edgeSlot * 2 + 1] = newTo;
+    }
+
+    // 三角形索引：triangleToFace按面序递增，二分查找两个面对应的三角形
+    int triangleSlots[2] = { -1, -1 };
+    for (int k = 0; k < 2; ++k) {
+        auto it = std::lower_bound(triangleToFace.begin(), triangleToFace.end(), changedFaces[k].idx());
+        if (it == triangleToFace.end() || *it != changedFaces[k].idx()) continue;
+        size_t t = it - triangleToFace.begin();
+        auto fv = openMesh.fv_ccwbegin(changedFaces[k]);
+        for (int c = 0; c < 3; ++c, ++fv) {
+            faces[t * 3 + c] = (*fv).idx();
+        }
+        triangleSlots[k] = static_cast<int>(t);
+    }
+
+    if (buffersResident) {
+        makeCurrent();
+        if (edgeSlot >= 0) {
+            ebo.bind();
+            ebo.write(edgeSlot * 2 * sizeof(unsigned int), &edges[edgeSlot * 2], 2 * sizeof(unsigned int));
+            ebo.release();
+        }
+        faceEbo.bind();
+        for (int t : triangleSlots) {
+            if (t < 0) continue;
+            faceEbo.write(t * 3 * sizeof(unsigned int), &faces[t * 3], 3 * sizeof(unsigned int));
+        }
+        faceEbo.release();
+        doneCurrent();
+    }
+
+    applyLocalEdit(dirty);
+    return true;
+}
+
+// 局部编辑后的增量更新：
+// 脏顶点的1环面 -> 重算面法线和几何缓存；这些面的顶点(ring1) -> 重算顶点法线；
+// ring1的1环(ring2)供依赖法线的量（主曲率）使用。之后只上传ring1覆盖的顶点区间
+void BaseGLWidget::applyLocalEdit(const std::vector<Mesh::VertexHandle>& dirtyVertices) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    auto sortUnique = [](auto& handles) {
+        std::sort(handles.begin(), handles.end());
+        handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+    };
+
+    LocalEdit edit;
+    edit.previousVersion = geometryVersion;
+    for (auto vh : dirtyVertices) {
+        for (auto fh : openMesh.vf_range(vh)) {
+            edit.faces.push_back(fh);
+        }
+    }
+    sortUnique(edit.faces);
+    edit.ring1 = dirtyVertices;
+    for (auto fh : edit.faces) {
+        for (auto vh : openMesh.fv_range(fh)) {
+            edit.ring1.push_back(vh);
+        }
+    }
+    sortUnique(edit.ring1);
+    for (auto vh : edit.ring1) {
+        for (auto fh : openMesh.vf_range(vh)) {
+            for (auto fv : openMesh.fv_range(fh)) {
+                edit.ring2.push_back(fv);
+            }
+        }
+    }
+    sortUnique(edit.ring2);
+
+    if (openMesh.has_face_normals()) {
+        for (auto fh : edit.faces) {
+            openMesh.set_normal(fh, openMesh.calc_face_normal(fh));
+        }
+    }
+    if (openMesh.has_vertex_normals()) {
+        for (auto vh : edit.ring1) {
+            openMesh.set_normal(vh, openMesh.calc_vertex_normal(vh));
+        }
+    }
+
+    // 缓存在编辑前有效时只做局部更新，否则留给下次geometry()整体重建
+    bool cacheCurrent = geometryCache.valid() && geometryCache.version() == geometryVersion;
+    ++geometryVersion;
+    if (cacheCurrent) {
+        geometryCache.updateFaces(openMesh, edit.faces, geometryVersion);
+    }
+
+    uploadVertexRange(edit.ring1);
+    onLocalEdit(edit);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    qDebug() << "Local edit:" << edit.faces.size() << "faces," << edit.ring2.size() << "vertices updated in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() << "us";
+    update();
+}
+
+// 只重新打包并上传[最小索引, 最大索引]区间内的顶点；
+// 顶点移出量化包围盒时无法局部更新，标记为需要整体重传
+void BaseGLWidget::uploadVertexRange(const std::vector<Mesh::VertexHandle>& vertices) {
+    if (!buffersResident || vertices.empty()) return;
+
+    int first = INT_MAX, last = -1;
+    for (auto vh : vertices) {
+        const Mesh::Point& p = openMesh.point(vh);
+        for (int k = 0; k < 3; ++k) {
+            if (p[k] < packingBounds.offset[k] || p[k] > packingBounds.offset[k] + packingBounds.scale[k]) {
+                buffersResident = false;
+                return;
+            }
+        }
+        first = std::min(first, vh.idx());
+        last = std::max(last, vh.idx());
+    }
+
+    const size_t count = static_cast<size_t>(last - first + 1);
+    std::vector<PackedVertex> packed(count);
+    const double* points = openMesh.points()->data() + size_t(first) * 3;
+    const double* normals = openMesh.has_vertex_normals() ? openMesh.vertex_normals()->data() + size_t(first) * 3 : nullptr;
+    simd::packVertices(points, normals, nullptr, count, packingBounds, packed.data());
+
+    makeCurrent();
+    vbo.bind();
+    vbo.write(first * static_cast<int>(sizeof(PackedVertex)), packed.data(), static_cast<int>(count * sizeof(PackedVertex)));
+    vbo.release();
+    doneCurrent();
+}
+
+const GeometryCache& BaseGLWidget::geometry() {
+    if (geometryCache.update(openMesh, geometryVersion)) {
+        qDebug() << "Geometry cache rebuilt for" << openMesh.n_faces() << "faces";
+    }
+    return geometryCache;
 }
 
 bool BaseGLWidget::loadOBJToOpenMesh(const QString &path) {
@@ -602,6 +809,7 @@ void BaseGLWidget::prepareFaceIndices() {
             faces.push_back((*fv_it).idx()); ++fv_it;
             faces.push_back((*fv_it).idx()); ++fv_it;
             faces.push_back((*fv_it).idx());
+            triangleToFace.push_back(fh.idx());
         } else {
             unsigned int centerIdx = (*fv_it).idx();
             ++fv_it;
@@ -613,6 +821,7 @@ void BaseGLWidget::prepareFaceIndices() {
                 faces.push_back(centerIdx);
                 faces.push_back(prevIdx);
                 faces.push_back(currentIdx);
+                triangleToFace.push_back(fh.idx());
                 prevIdx = currentIdx;
                 ++fv_it;
             }
@@ -636,6 +845,28 @@ void BaseGLWidget::prepareEdgeIndices() {
         edges.push_back(edge.first);
         edges.push_back(edge.second);
     }
+
+    // 线段按顶点对排序，二分查找每条网格边所在的线段
+    edgeSlots.assign(openMesh.n_edges(), -1);
+    const size_t slotCount = edges.size() / 2;
+    for (auto eh : openMesh.edges()) {
+        auto heh = openMesh.halfedge_handle(eh, 0);
+        unsigned int from = openMesh.from_vertex_handle(heh).idx();
+        unsigned int to = openMesh.to_vertex_handle(heh).idx();
+        if (from > to) std::swap(from, to);
+        size_t lo = 0, hi = slotCount;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (edges[mid * 2] < from || (edges[mid * 2] == from && edges[mid * 2 + 1] < to)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < slotCount && edges[lo * 2] == from && edges[lo * 2 + 1] == to) {
+            edgeSlots[eh.idx()] = static_cast<int>(lo);
+        }
+    }
 }
 
 void BaseGLWidget::saveOriginalMesh() {
@@ -683,6 +914,7 @@ void BaseGLWidget::loadOBJ(const QString &path) {
     
     saveOriginalMesh();
     modelLoaded = true;
+    ++geometryVersion;
     
     makeCurrent();
     initializeShaders();
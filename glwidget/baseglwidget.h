@@ -13,6 +13,9 @@
 #include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
 #include <QQuaternion>
 #include "../meshutils/my_traits.h"
+#include "../meshutils/vertex_packing.h"
+#include "../meshutils/geometry_cache.h"
+#include "gpumemorybudget.h"
 
 class BaseGLWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -27,9 +30,16 @@ public:
         FlatShading,  // 添加Flat Shading模式
         GaussianCurvature,
         MeanCurvature,
-        MaxCurvature
+        MaxCurvature,
+        PrincipalMaxCurvature,  // 主曲率k1
+        PrincipalMinCurvature   // 主曲率k2
     };
 
+    // 透视投影的视场角和近/远裁剪面，所有绘制、拾取和深度还原共用
+    static constexpr float FieldOfView = 45.0f;
+    static constexpr float NearPlane = 0.1f;
+    static constexpr float FarPlane = 100.0f;
+
     void setBackgroundColor(const QColor& color);
     void setWireframeColor(const QVector4D& color);
     void setSurfaceColor(const QVector3D& color);
@@ -43,6 +53,10 @@ public:
     void clearMeshData();
     void setViewScale(float scale);
 
+    // 局部编辑：只在受影响的1环/2环内更新法线、几何缓存和曲率，并只上传变化的顶点区间
+    bool moveVertex(Mesh::VertexHandle vh, const Mesh::Point& position);
+    bool flipEdge(Mesh::EdgeHandle eh);
+
     QVector3D surfaceColor = QVector3D(1.0f, 1.0f, 0.0f);
     bool specularEnabled = true;
     QVector4D wireframeColor;
@@ -54,7 +68,9 @@ public:
     bool hasOriginalMesh = false;
     
     std::vector<unsigned int> faces;
+    std::vector<int> triangleToFace;   // 三角化后每个三角形对应的原始面索引
     std::vector<unsigned int> edges;
+    std::vector<int> edgeSlots;        // 网格边索引 -> edges中的线段序号，翻转边时原位改写
     
     QQuaternion rotation;
     float zoom;
@@ -62,6 +78,10 @@ public:
     bool showWireframeOverlay;
     bool hideFaces;
     bool modelLoaded;
+    quint64 geometryVersion = 0;   // 网格几何每次变化时递增，供CPU侧缓存（BVH等）判断失效
+
+    // 面积/内角/余切缓存，按geometryVersion失效后惰性重算
+    const GeometryCache& geometry();
 
     QVector3D modelCenter;
     float viewDistance;
@@ -84,13 +104,31 @@ protected:
     void prepareFaceIndices();
     void prepareEdgeIndices();
     void saveOriginalMesh();
-    void updateBuffersFromOpenMesh();
+    virtual void updateBuffersFromOpenMesh();
     void initializeShaders();
+    // 显存预算：回收时释放缓冲区，绘制前按需重新上传
+    virtual void releaseGpuBuffers();
+    void ensureBuffersResident();
+    // 压缩顶点格式的属性绑定和位置反量化uniform
+    void setupPackedVertexAttributes(QOpenGLShaderProgram* program);
+    void setPositionDequantization(QOpenGLShaderProgram* program);
     void drawWireframe(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
     void drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
     void drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& projection);
     QVector3D projectToTrackball(const QPoint& screenPos);
 
+    // 一次局部编辑影响的区域
+    struct LocalEdit {
+        std::vector<Mesh::FaceHandle> faces;       // 几何或连接关系变化的面（脏顶点的1环面）
+        std::vector<Mesh::VertexHandle> ring1;     // 法线、内角、面积变化的顶点
+        std::vector<Mesh::VertexHandle> ring2;     // 依赖ring1法线的顶点（主曲率）
+        quint64 previousVersion = 0;               // 编辑前的geometryVersion
+    };
+    void applyLocalEdit(const std::vector<Mesh::VertexHandle>& dirtyVertices);
+    // 派生类在此更新自己的逐顶点数据（曲率等）
+    virtual void onLocalEdit(const LocalEdit& edit) { Q_UNUSED(edit); }
+    void uploadVertexRange(const std::vector<Mesh::VertexHandle>& vertices);
+
     // 初始视图状态
     QQuaternion initialRotation;
     float rotationSensitivity = 2.0f;
@@ -100,7 +138,7 @@ protected:
     float initialViewScale = 2.0f;
 
     // XYZ坐标轴相关成员
-    QOpenGLShaderProgram axisProgram;
+    QOpenGLShaderProgram *axisProgram = nullptr;
     QOpenGLBuffer axisVbo;
     QOpenGLBuffer axisEbo;
     bool showAxis;
@@ -109,14 +147,18 @@ protected:
     bool isDragging;
     QPoint lastMousePos;
 
-    QOpenGLShaderProgram wireframeProgram;
-    QOpenGLShaderProgram blinnPhongProgram;
-    QOpenGLShaderProgram flatProgram;
+    GeometryCache geometryCache;
+
+    QOpenGLShaderProgram *wireframeProgram = nullptr;
+    QOpenGLShaderProgram *blinnPhongProgram = nullptr;
+    QOpenGLShaderProgram *flatProgram = nullptr;
 
     QOpenGLVertexArrayObject vao;
     QOpenGLBuffer vbo;
     QOpenGLBuffer ebo;
     QOpenGLBuffer faceEbo;
+    bool buffersResident = false;
+    PackingBounds packingBounds;
 };
 
 #endif // BASEGLWIDGET_H
\ No newline at end of file
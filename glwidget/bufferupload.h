@@ -0,0 +1,31 @@
+// bufferupload.h
+#ifndef BUFFERUPLOAD_H
+#define BUFFERUPLOAD_H
+
+#include <QOpenGLBuffer>
+#include <QDebug>
+#include <vector>
+
+// 分配缓冲区并把数据直接写入映射的GPU内存，省去CPU端暂存数组和一次拷贝。
+// fill(void* dst)负责写满bytes字节；映射失败（驱动不支持或unmap报告数据损坏）时
+// 退回到暂存数组 + write()。调用时缓冲区须已bind且有当前上下文。
+template <typename Fill>
+void uploadMappedBuffer(QOpenGLBuffer& buffer, int bytes, Fill fill) {
+    buffer.allocate(bytes);
+    if (bytes == 0) return;
+
+    void* mapped = buffer.mapRange(0, bytes, QOpenGLBuffer::RangeWrite | QOpenGLBuffer::RangeInvalidateBuffer);
+    if (mapped) {
+        fill(mapped);
+        if (buffer.unmap()) {
+            return;
+        }
+        qDebug() << "Buffer contents lost during unmap, re-uploading";
+    }
+
+    std::vector<char> staging(bytes);
+    fill(staging.data());
+    buffer.write(0, staging.data(), bytes);
+}
+
+#endif // BUFFERUPLOAD_H
@@ -1,5 +1,8 @@
 // cgalglwidget.cpp
 #include "cgalglwidget.h"
+#include "shaderregistry.h"
+#include "bufferupload.h"
+#include "../meshutils/simd_convert.h"
 #include <QFile>
 #include <QDebug>
 #include <QMouseEvent>
@@ -13,6 +16,8 @@
 #include <QPainter>
 #include <QFont>
 #include <cfloat>
+#include <cstddef>
+#include <chrono>
 #include <fstream>
 #include <CGAL/IO/OBJ.h>
 #include <CGAL/Polygon_mesh_processing/compute_normal.h>
@@ -56,6 +61,12 @@ CGALGLWidget::CGALGLWidget(QWidget *parent) : QOpenGLWidget(parent),
     initialViewScale = 1.0f;
     showAxis = false;  // 修改为false，默认不显示坐标轴
     specularEnabled = false;  // 添加这行，默认不显示高光
+
+    GpuMemoryBudget::instance().registerWidget(this, [this]() {
+        makeCurrent();
+        releaseGpuBuffers();
+        doneCurrent();
+    });
 }
 
 void CGALGLWidget::setShowAxis(bool show) {
@@ -84,6 +95,7 @@ void CGALGLWidget::setWireframeColor(const QVector4D& color) {
 }
 
 CGALGLWidget::~CGALGLWidget() {
+    GpuMemoryBudget::instance().unregisterWidget(this);
     makeCurrent();
     vao.destroy();
     vbo.destroy();
@@ -148,9 +160,7 @@ void CGALGLWidget::initializeGL() {
     axisEbo.bind();
     axisEbo.allocate(axisIndices, sizeof(axisIndices));
     
-    axisProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/axis.vert");
-    axisProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/axis.frag");
-    axisProgram.link();
+    axisProgram = ShaderRegistry::instance().axis();
 
     initializeShaders();
 }
@@ -201,22 +211,10 @@ void CGALGLWidget::computeNormals() {
 }
 
 void CGALGLWidget::initializeShaders() {
-    wireframeProgram.removeAllShaders();
-    blinnPhongProgram.removeAllShaders();
-    flatProgram.removeAllShaders();  // 确保清除旧的着色器
-
-    wireframeProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/wireframe.vert");
-    wireframeProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/wireframe.frag");
-    wireframeProgram.link();
-    
-    blinnPhongProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/blinnphong.vert");
-    blinnPhongProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/blinnphong.frag");
-    blinnPhongProgram.link();
-    
-    // 添加Flat Shading着色器
-    flatProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/flat.vert");
-    flatProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/flat.frag");
-    flatProgram.link();
+    // 着色器程序由注册表统一编译，各窗口共享同一份
+    wireframeProgram = ShaderRegistry::instance().wireframe();
+    blinnPhongProgram = ShaderRegistry::instance().blinnPhong();
+    flatProgram = ShaderRegistry::instance().flat();
 
     if (modelLoaded) {
         updateBuffersFromCGALMesh();
@@ -226,57 +224,60 @@ void CGALGLWidget::initializeShaders() {
 void CGALGLWidget::updateBuffersFromCGALMesh() {
     if (mesh.number_of_vertices() == 0) return;
     
-    std::vector<float> vertices;
-    std::vector<float> normals;
+    // 缓冲区可能已被显存预算回收，create()对已创建的缓冲区无影响
+    vbo.create();
+    ebo.create();
+    faceEbo.create();
+    
+    // Surface_mesh按索引存放顶点，先收集为连续的xyz再打包
+    const size_t vertexCount = mesh.number_of_vertices();
+    std::vector<double> points(vertexCount * 3);
+    std::vector<double> normals(vertexCount * 3);
     
     // 提取顶点数据
+    size_t i = 0;
     for(auto v : mesh.vertices()) {
         const Point& p = mesh.point(v);
-        vertices.push_back(p.x());
-        vertices.push_back(p.y());
-        vertices.push_back(p.z());
+        points[i * 3]     = p.x();
+        points[i * 3 + 1] = p.y();
+        points[i * 3 + 2] = p.z();
         
         // 使用计算的法线
         if(v.idx() < vertex_normals.size()) {
             const Vector& n = vertex_normals[v.idx()];
-            normals.push_back(n.x());
-            normals.push_back(n.y());
-            normals.push_back(n.z());
+            normals[i * 3]     = n.x();
+            normals[i * 3 + 1] = n.y();
+            normals[i * 3 + 2] = n.z();
         } else {
-            normals.push_back(0.0f);
-            normals.push_back(1.0f);
-            normals.push_back(0.0f);
+            normals[i * 3]     = 0.0;
+            normals[i * 3 + 1] = 1.0;
+            normals[i * 3 + 2] = 0.0;
         }
+        ++i;
     }
     
+    // 与BaseGLWidget相同的12字节压缩顶点格式（着色器共享）
+    Point min, max;
+    computeBoundingBox(min, max);
+    const double boxMin[3] = {min.x(), min.y(), min.z()};
+    const double boxMax[3] = {max.x(), max.y(), max.z()};
+    packingBounds = packingBoundsFromBox(boxMin, boxMax);
+    
     vao.bind();
     vbo.bind();
     
-    int vertexSize = vertices.size() * sizeof(float);
-    int normalSize = normals.size() * sizeof(float);
-    vbo.allocate(vertexSize + normalSize);
-    vbo.write(0, vertices.data(), vertexSize);
-    vbo.write(vertexSize, normals.data(), normalSize);
-    
-    wireframeProgram.bind();
-    int posLoc = wireframeProgram.attributeLocation("aPos");
-    if (posLoc != -1) {
-        wireframeProgram.enableAttributeArray(posLoc);
-        wireframeProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
-    }
-    
-    blinnPhongProgram.bind();
-    posLoc = blinnPhongProgram.attributeLocation("aPos");
-    if (posLoc != -1) {
-        blinnPhongProgram.enableAttributeArray(posLoc);
-        blinnPhongProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
-    }
+    // 打包直接写入映射的VBO（SIMD内核，运行时选择指令集）
+    auto packStart = std::chrono::high_resolution_clock::now();
+    uploadMappedBuffer(vbo, static_cast<int>(vertexCount * sizeof(PackedVertex)), [&](void* dst) {
+        simd::packVertices(points.data(), normals.data(), nullptr, vertexCount, packingBounds,
+                           static_cast<PackedVertex*>(dst));
+    });
+    auto packEnd = std::chrono::high_resolution_clock::now();
+    qDebug() << "Vertex packing (" << simd::levelName(simd::detectedLevel()) << "):" << vertexCount << "vertices in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(packEnd - packStart).count() << "us";
     
-    int normalLoc = blinnPhongProgram.attributeLocation("aNormal");
-    if (normalLoc != -1) {
-        blinnPhongProgram.enableAttributeArray(normalLoc);
-        blinnPhongProgram.setAttributeBuffer(normalLoc, GL_FLOAT, vertexSize, 3, 3 * sizeof(float));
-    }
+    setupPackedVertexAttributes(wireframeProgram);
+    setupPackedVertexAttributes(blinnPhongProgram);
 
     ebo.bind();
     ebo.allocate(edges.data(), edges.size() * sizeof(unsigned int));
@@ -285,6 +286,52 @@ void CGALGLWidget::updateBuffersFromCGALMesh() {
     faceEbo.allocate(faces.data(), faces.size() * sizeof(unsigned int));
     
     vao.release();
+
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "vbo", vbo.size());
+    budget.track(this, "ebo", ebo.size());
+    budget.track(this, "faceEbo", faceEbo.size());
+    buffersResident = true;
+}
+
+void CGALGLWidget::setupPackedVertexAttributes(QOpenGLShaderProgram* program) {
+    // setAttributeBuffer以normalized=GL_TRUE设置属性，整型分量在着色器中读出为[0,1]/[-1,1]
+    program->bind();
+    int posLoc = program->attributeLocation("aPos");
+    if (posLoc != -1) {
+        program->enableAttributeArray(posLoc);
+        program->setAttributeBuffer(posLoc, GL_UNSIGNED_SHORT, offsetof(PackedVertex, pos), 3, sizeof(PackedVertex));
+    }
+    
+    int normalLoc = program->attributeLocation("aNormal");
+    if (normalLoc != -1) {
+        program->enableAttributeArray(normalLoc);
+        program->setAttributeBuffer(normalLoc, GL_SHORT, offsetof(PackedVertex, normal), 2, sizeof(PackedVertex));
+    }
+}
+
+void CGALGLWidget::setPositionDequantization(QOpenGLShaderProgram* program) {
+    program->setUniformValue("posOffset", QVector3D(packingBounds.offset[0], packingBounds.offset[1], packingBounds.offset[2]));
+    program->setUniformValue("posScale", QVector3D(packingBounds.scale[0], packingBounds.scale[1], packingBounds.scale[2]));
+}
+
+void CGALGLWidget::releaseGpuBuffers() {
+    vbo.destroy();
+    ebo.destroy();
+    faceEbo.destroy();
+    buffersResident = false;
+
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "vbo", 0);
+    budget.track(this, "ebo", 0);
+    budget.track(this, "faceEbo", 0);
+}
+
+void CGALGLWidget::ensureBuffersResident() {
+    GpuMemoryBudget::instance().touch(this);
+    if (modelLoaded && !buffersResident) {
+        updateBuffersFromCGALMesh();
+    }
 }
 
 void CGALGLWidget::resizeGL(int w, int h) {
@@ -298,6 +345,8 @@ void CGALGLWidget::paintGL() {
         return;
     }
 
+    ensureBuffersResident();
+
     QMatrix4x4 model, view, projection;
     
     model.rotate(rotation);
@@ -329,58 +378,60 @@ void CGALGLWidget::paintGL() {
         drawWireframe(model, view, projection);
     } else {
         if (currentRenderMode == BlinnPhong) {
-            blinnPhongProgram.bind();
+            blinnPhongProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            blinnPhongProgram.setUniformValue("model", model);
-            blinnPhongProgram.setUniformValue("view", view);
-            blinnPhongProgram.setUniformValue("projection", projection);
-            blinnPhongProgram.setUniformValue("normalMatrix", normalMatrix);
+            blinnPhongProgram->setUniformValue("model", model);
+            setPositionDequantization(blinnPhongProgram);
+            blinnPhongProgram->setUniformValue("view", view);
+            blinnPhongProgram->setUniformValue("projection", projection);
+            blinnPhongProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                blinnPhongProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                blinnPhongProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                blinnPhongProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                blinnPhongProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            blinnPhongProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            blinnPhongProgram.setUniformValue("objectColor", surfaceColor);
-            blinnPhongProgram.setUniformValue("specularEnabled", specularEnabled);
+            blinnPhongProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            blinnPhongProgram->setUniformValue("objectColor", surfaceColor);
+            blinnPhongProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            blinnPhongProgram.release();
+            blinnPhongProgram->release();
         } else if (currentRenderMode == FlatShading) {
             // Flat Shading渲染
-            flatProgram.bind();
+            flatProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            flatProgram.setUniformValue("model", model);
-            flatProgram.setUniformValue("view", view);
-            flatProgram.setUniformValue("projection", projection);
-            flatProgram.setUniformValue("normalMatrix", normalMatrix);
+            flatProgram->setUniformValue("model", model);
+            setPositionDequantization(flatProgram);
+            flatProgram->setUniformValue("view", view);
+            flatProgram->setUniformValue("projection", projection);
+            flatProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                flatProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                flatProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                flatProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                flatProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            flatProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            flatProgram.setUniformValue("objectColor", surfaceColor);
-            flatProgram.setUniformValue("specularEnabled", specularEnabled);
+            flatProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            flatProgram->setUniformValue("objectColor", surfaceColor);
+            flatProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            flatProgram.release();
+            flatProgram->release();
         }
 
         if (showWireframeOverlay) {
@@ -524,21 +575,22 @@ void CGALGLWidget::centerView() {
 }
 
 void CGALGLWidget::drawWireframe(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection) {
-    wireframeProgram.bind();
+    wireframeProgram->bind();
     vao.bind();
     ebo.bind();
 
     glLineWidth(1.5f);
-    wireframeProgram.setUniformValue("model", model);
-    wireframeProgram.setUniformValue("view", view);
-    wireframeProgram.setUniformValue("projection", projection);
-    wireframeProgram.setUniformValue("lineColor", wireframeColor);
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("lineColor", wireframeColor);
 
     glDrawElements(GL_LINES, edges.size(), GL_UNSIGNED_INT, 0);
     
     ebo.release();
     vao.release();
-    wireframeProgram.release();
+    wireframeProgram->release();
 }
 
 void CGALGLWidget::drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection) {
@@ -547,20 +599,21 @@ void CGALGLWidget::drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     glLineWidth(1.5f);
     
-    wireframeProgram.bind();
+    wireframeProgram->bind();
     vao.bind();
     ebo.bind();
 
-    wireframeProgram.setUniformValue("model", model);
-    wireframeProgram.setUniformValue("view", view);
-    wireframeProgram.setUniformValue("projection", projection);
-    wireframeProgram.setUniformValue("lineColor", wireframeColor);
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("lineColor", wireframeColor);
 
     glDrawElements(GL_LINES, edges.size(), GL_UNSIGNED_INT, 0);
     
     ebo.release();
     vao.release();
-    wireframeProgram.release();
+    wireframeProgram->release();
     glDisable(GL_POLYGON_OFFSET_LINE);
 }
 
@@ -570,27 +623,27 @@ void CGALGLWidget::drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& project
     
     glDisable(GL_DEPTH_TEST);
     
-    axisProgram.bind();
+    axisProgram->bind();
     
     QMatrix4x4 model;
     model.translate(modelCenter);
     model.scale(0.8f);
     model.rotate(rotation);
     
-    axisProgram.setUniformValue("model", model);
-    axisProgram.setUniformValue("view", view);
-    axisProgram.setUniformValue("projection", projection);
+    axisProgram->setUniformValue("model", model);
+    axisProgram->setUniformValue("view", view);
+    axisProgram->setUniformValue("projection", projection);
     
     axisVbo.bind();
     axisEbo.bind();
     
-    int posLoc = axisProgram.attributeLocation("aPos");
-    axisProgram.enableAttributeArray(posLoc);
-    axisProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 6 * sizeof(float));
+    int posLoc = axisProgram->attributeLocation("aPos");
+    axisProgram->enableAttributeArray(posLoc);
+    axisProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 6 * sizeof(float));
     
-    int colorLoc = axisProgram.attributeLocation("aColor");
-    axisProgram.enableAttributeArray(colorLoc);
-    axisProgram.setAttributeBuffer(colorLoc, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
+    int colorLoc = axisProgram->attributeLocation("aColor");
+    axisProgram->enableAttributeArray(colorLoc);
+    axisProgram->setAttributeBuffer(colorLoc, GL_FLOAT, 3 * sizeof(float), 3, 6 * sizeof(float));
     
     glLineWidth(3.0f);
     glDrawElements(GL_LINES, 6, GL_UNSIGNED_INT, 0);
@@ -599,11 +652,11 @@ void CGALGLWidget::drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& project
         glEnable(GL_DEPTH_TEST);
     }
     
-    axisProgram.disableAttributeArray(posLoc);
-    axisProgram.disableAttributeArray(colorLoc);
+    axisProgram->disableAttributeArray(posLoc);
+    axisProgram->disableAttributeArray(colorLoc);
     axisEbo.release();
     axisVbo.release();
-    axisProgram.release();
+    axisProgram->release();
 }
 
 void CGALGLWidget::clearMeshData() {
@@ -12,6 +12,8 @@
 #include <QColor>
 #include <vector>
 #include <QQuaternion>
+#include "../meshutils/vertex_packing.h"
+#include "gpumemorybudget.h"
 #include <CGAL/Simple_cartesian.h>
 #include <CGAL/Surface_mesh.h>
 #include <CGAL/Polygon_mesh_processing/compute_normal.h>
@@ -102,6 +104,12 @@ protected:
     void saveOriginalMesh();
     void updateBuffersFromCGALMesh();
     void initializeShaders();
+    // 显存预算：回收时释放缓冲区，绘制前按需重新上传
+    void releaseGpuBuffers();
+    void ensureBuffersResident();
+    // 压缩顶点格式的属性绑定和位置反量化uniform
+    void setupPackedVertexAttributes(QOpenGLShaderProgram* program);
+    void setPositionDequantization(QOpenGLShaderProgram* program);
     void drawWireframe(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
     void drawWireframeOverlay(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
     void drawXYZAxis(const QMatrix4x4& view, const QMatrix4x4& projection);
@@ -118,7 +126,7 @@ protected:
     float initialViewScale = 2.0f;
 
     // XYZ坐标轴相关成员
-    QOpenGLShaderProgram axisProgram;
+    QOpenGLShaderProgram *axisProgram = nullptr;
     QOpenGLBuffer axisVbo;
     QOpenGLBuffer axisEbo;
     bool showAxis;
@@ -127,14 +135,16 @@ protected:
     bool isDragging;
     QPoint lastMousePos;
 
-    QOpenGLShaderProgram wireframeProgram;
-    QOpenGLShaderProgram blinnPhongProgram;
-    QOpenGLShaderProgram flatProgram;
+    QOpenGLShaderProgram *wireframeProgram = nullptr;
+    QOpenGLShaderProgram *blinnPhongProgram = nullptr;
+    QOpenGLShaderProgram *flatProgram = nullptr;
 
     QOpenGLVertexArrayObject vao;
     QOpenGLBuffer vbo;
     QOpenGLBuffer ebo;
     QOpenGLBuffer faceEbo;
+    bool buffersResident = false;
+    PackingBounds packingBounds;
 };
 
 #endif // CGALGLWIDGET_H
\ No newline at end of file
@@ -0,0 +1,130 @@
+// gpumemorybudget.cpp
+#include "gpumemorybudget.h"
+#include <QDebug>
+#include <QMetaObject>
+
+GpuMemoryBudget& GpuMemoryBudget::instance() {
+    static GpuMemoryBudget budget;
+    return budget;
+}
+
+GpuMemoryBudget::GpuMemoryBudget() {
+    budgetBytes = 512LL * 1024 * 1024;
+    bool ok = false;
+    qint64 mb = qEnvironmentVariable("OBJVIEWER_GPU_BUDGET_MB").toLongLong(&ok);
+    if (ok && mb > 0) {
+        budgetBytes = mb * 1024 * 1024;
+    }
+}
+
+void GpuMemoryBudget::setBudget(qint64 bytes) {
+    budgetBytes = bytes;
+    scheduleEnforce();
+}
+
+qint64 GpuMemoryBudget::widgetBytes(QWidget* widget) const {
+    qint64 total = 0;
+    auto it = entries.constFind(widget);
+    if (it != entries.constEnd()) {
+        for (qint64 bytes : it->buffers) {
+            total += bytes;
+        }
+    }
+    return total;
+}
+
+qint64 GpuMemoryBudget::residentBytes() const {
+    qint64 total = 0;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        total += widgetBytes(it.key());
+    }
+    return total;
+}
+
+void GpuMemoryBudget::registerWidget(QWidget* widget, std::function<void()> evict) {
+    Entry& entry = entries[widget];
+    entry.evict = std::move(evict);
+    entry.lastUse = ++useClock;
+}
+
+void GpuMemoryBudget::unregisterWidget(QWidget* widget) {
+    entries.remove(widget);
+}
+
+void GpuMemoryBudget::track(QWidget* widget, const QString& buffer, qint64 bytes) {
+    auto it = entries.find(widget);
+    if (it == entries.end()) return;
+
+    if (bytes > 0) {
+        it->buffers.insert(buffer, bytes);
+        scheduleEnforce();
+    } else {
+        it->buffers.remove(buffer);
+    }
+}
+
+void GpuMemoryBudget::touch(QWidget* widget) {
+    auto it = entries.find(widget);
+    if (it != entries.end()) {
+        it->lastUse = ++useClock;
+    }
+}
+
+void GpuMemoryBudget::scheduleEnforce() {
+    if (enforcePending) return;
+    enforcePending = true;
+    QMetaObject::invokeMethod(this, "enforce", Qt::QueuedConnection);
+}
+
+void GpuMemoryBudget::enforce() {
+    enforcePending = false;
+
+    qint64 total = residentBytes();
+    if (total <= budgetBytes) return;
+
+    // 最近使用的窗口不回收，否则会在下一帧立即重新上传
+    QWidget* mostRecent = nullptr;
+    quint64 mostRecentUse = 0;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (it->lastUse >= mostRecentUse) {
+            mostRecentUse = it->lastUse;
+            mostRecent = it.key();
+        }
+    }
+
+    while (total > budgetBytes) {
+        // 选择回收对象：不可见窗口优先，其次按LRU
+        QWidget* victim = nullptr;
+        bool victimVisible = true;
+        quint64 victimUse = 0;
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            QWidget* widget = it.key();
+            if (widget == mostRecent || widgetBytes(widget) == 0) continue;
+
+            bool visible = widget->isVisible();
+            if (!victim || (victimVisible && !visible) ||
+                (visible == victimVisible && it->lastUse < victimUse)) {
+                victim = widget;
+                victimVisible = visible;
+                victimUse = it->lastUse;
+            }
+        }
+        if (!victim) break;
+
+        qint64 freed = widgetBytes(victim);
+        qDebug() << "GpuMemoryBudget: evicting" << victim->metaObject()->className()
+                 << (victimVisible ? "(visible)" : "(hidden)") << freed / 1024 << "KB";
+
+        Entry& entry = entries[victim];
+        if (entry.evict) {
+            entry.evict();
+        }
+        entry.buffers.clear();
+        total -= freed;
+    }
+
+    if (total > budgetBytes) {
+        qDebug() << "GpuMemoryBudget: resident" << total / (1024 * 1024) << "MB still exceeds budget"
+                 << budgetBytes / (1024 * 1024) << "MB";
+    }
+}
@@ -0,0 +1,57 @@
+// gpumemorybudget.h
+#ifndef GPUMEMORYBUDGET_H
+#define GPUMEMORYBUDGET_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QWidget>
+#include <functional>
+
+// 显存预算管理器
+// 各GL窗口登记自己分配的缓冲区对象及其字节数，总量超出预算时按LRU顺序回收，
+// 优先回收当前不可见（隐藏标签页中）的窗口。被回收的窗口在下次绘制时
+// 从CPU端网格数据重新上传，对使用者透明。
+// 回收通过排队调用执行，避免在其他窗口的paintGL中切换上下文。
+class GpuMemoryBudget : public QObject
+{
+    Q_OBJECT
+
+public:
+    static GpuMemoryBudget& instance();
+
+    // 预算（字节），默认512MB，可由环境变量OBJVIEWER_GPU_BUDGET_MB覆盖
+    void setBudget(qint64 bytes);
+    qint64 budget() const { return budgetBytes; }
+    qint64 residentBytes() const;
+
+    // 窗口登记/注销；evict回调中窗口需自行makeCurrent并释放全部登记的缓冲区
+    void registerWidget(QWidget* widget, std::function<void()> evict);
+    void unregisterWidget(QWidget* widget);
+
+    // 记录某个缓冲区当前的字节数，bytes为0表示已释放
+    void track(QWidget* widget, const QString& buffer, qint64 bytes);
+    // 窗口绘制时调用，更新LRU时间戳
+    void touch(QWidget* widget);
+
+private slots:
+    void enforce();
+
+private:
+    GpuMemoryBudget();
+    void scheduleEnforce();
+    qint64 widgetBytes(QWidget* widget) const;
+
+    struct Entry {
+        std::function<void()> evict;
+        QHash<QString, qint64> buffers;
+        quint64 lastUse = 0;
+    };
+
+    QHash<QWidget*, Entry> entries;
+    qint64 budgetBytes;
+    quint64 useClock = 0;
+    bool enforcePending = false;
+};
+
+#endif // GPUMEMORYBUDGET_H
@@ -1,35 +1,166 @@
 #include "modelglwidget.h"
+#include "shaderregistry.h"
+#include "../meshutils/curvature.h"
+#include "../meshutils/parallel_utils.h"
+#include <QDebug>
+#include <QMouseEvent>
+#include <QVector2D>
+#include <QVector4D>
 #include <cmath>
 #include <algorithm>
-
-#define EPSILON 1E-4F
+#include <chrono>
 
 ModelGLWidget::ModelGLWidget(QWidget *parent) : BaseGLWidget(parent)
 {
 }
 
 void ModelGLWidget::setRenderMode(RenderMode mode) {
+    // 所有曲率通道已在GPU上，切换模式只改变curvatureType uniform
     currentRenderMode = mode;
-    if (modelLoaded) {
-        calculateCurvatures();
-        makeCurrent();
-        initializeShaders();
-        doneCurrent();
-    }
     update();
 }
 
-void ModelGLWidget::initializeShaders() {
-    BaseGLWidget::initializeShaders();
-    
-    curvatureProgram.removeAllShaders();
-    curvatureProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/curvature.vert");
-    curvatureProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/curvature.frag");
-    curvatureProgram.link();
+void ModelGLWidget::setShowPrincipalDirections(bool show) {
+    showPrincipalDirections = show;
+    update();
+}
+
+void ModelGLWidget::setEditTool(EditTool tool) {
+    editTool = tool;
+    draggedVertex = Mesh::VertexHandle();
+    setCursor(tool == NoEditTool ? Qt::ArrowCursor : Qt::CrossCursor);
+}
+
+// 与paintGL相同的MVP矩阵
+QMatrix4x4 ModelGLWidget::modelViewProjection() const {
+    QMatrix4x4 model, view, projection;
+    model.rotate(rotation);
+    model.scale(zoom);
+    view.lookAt(QVector3D(0, 0, viewDistance * viewScale), modelCenter, QVector3D(0, 1, 0));
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+    return projection * view * model;
+}
+
+QVector3D ModelGLWidget::eyeInModelSpace() const {
+    QMatrix4x4 model, view;
+    model.rotate(rotation);
+    model.scale(zoom);
+    view.lookAt(QVector3D(0, 0, viewDistance * viewScale), modelCenter, QVector3D(0, 1, 0));
+    return (view * model).inverted().map(QVector3D(0, 0, 0));
+}
+
+// 屏幕上离光标最近（12像素内）且法线朝向相机的顶点
+Mesh::VertexHandle ModelGLWidget::pickVertex(const QPoint& pos, float& ndcDepth) const {
+    const QMatrix4x4 mvp = modelViewProjection();
+    const QVector3D eye = eyeInModelSpace();
+    float bestDistance = 12.0f * 12.0f;
+    Mesh::VertexHandle best;
+    for (auto vh : openMesh.vertices()) {
+        const Mesh::Point& p = openMesh.point(vh);
+        QVector3D point(float(p[0]), float(p[1]), float(p[2]));
+        const Mesh::Normal& n = openMesh.normal(vh);
+        if (QVector3D::dotProduct(QVector3D(float(n[0]), float(n[1]), float(n[2])), eye - point) <= 0.0f) continue;
+
+        QVector4D clip = mvp.map(QVector4D(point, 1.0f));
+        if (clip.w() <= 0.0f) continue;
+        float dx = (clip.x() / clip.w() * 0.5f + 0.5f) * width() - pos.x();
+        float dy = (0.5f - clip.y() / clip.w() * 0.5f) * height() - pos.y();
+        if (dx * dx + dy * dy < bestDistance) {
+            bestDistance = dx * dx + dy * dy;
+            best = vh;
+            ndcDepth = clip.z() / clip.w();
+        }
+    }
+    return best;
+}
+
+// 屏幕上离光标最近（8像素内）的边，至少一侧的面朝向相机
+Mesh::EdgeHandle ModelGLWidget::pickEdge(const QPoint& pos) const {
+    const QMatrix4x4 mvp = modelViewProjection();
+    const QVector3D eye = eyeInModelSpace();
+    const QVector2D cursor(pos);
+    auto toScreen = [&](const Mesh::Point& p, QVector2D& screen) {
+        QVector4D clip = mvp.map(QVector4D(float(p[0]), float(p[1]), float(p[2]), 1.0f));
+        if (clip.w() <= 0.0f) return false;
+        screen = QVector2D((clip.x() / clip.w() * 0.5f + 0.5f) * width(), (0.5f - clip.y() / clip.w() * 0.5f) * height());
+        return true;
+    };
+    auto facesEye = [&](Mesh::FaceHandle fh, const Mesh::Point& p) {
+        if (!fh.is_valid()) return false;
+        const Mesh::Normal& n = openMesh.normal(fh);
+        Mesh::Point toEye = Mesh::Point(eye.x(), eye.y(), eye.z()) - p;
+        return (n | toEye) > 0.0;
+    };
+
+    float bestDistance = 8.0f;
+    Mesh::EdgeHandle best;
+    for (auto eh : openMesh.edges()) {
+        auto h0 = openMesh.halfedge_handle(eh, 0);
+        const Mesh::Point& a = openMesh.point(openMesh.from_vertex_handle(h0));
+        const Mesh::Point& b = openMesh.point(openMesh.to_vertex_handle(h0));
+        Mesh::Point mid = (a + b) * 0.5;
+        if (!facesEye(openMesh.face_handle(h0), mid) &&
+            !facesEye(openMesh.face_handle(openMesh.opposite_halfedge_handle(h0)), mid)) continue;
+
+        QVector2D sa, sb;
+        if (!toScreen(a, sa) || !toScreen(b, sb)) continue;
+        QVector2D ab = sb - sa;
+        float t = ab.lengthSquared() > 0.0f ? QVector2D::dotProduct(cursor - sa, ab) / ab.lengthSquared() : 0.0f;
+        t = std::max(0.0f, std::min(1.0f, t));
+        float distance = (sa + ab * t - cursor).length();
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = eh;
+        }
+    }
+    return best;
+}
+
+// 编辑工具下左键用于编辑，不再旋转视图
+void ModelGLWidget::mousePressEvent(QMouseEvent *event) {
+    if (editTool == NoEditTool || event->button() != Qt::LeftButton || !modelLoaded) {
+        BaseGLWidget::mousePressEvent(event);
+        return;
+    }
+
+    if (editTool == MoveVertexTool) {
+        draggedVertex = pickVertex(event->pos(), dragDepth);
+    } else if (editTool == FlipEdgeTool) {
+        Mesh::EdgeHandle eh = pickEdge(event->pos());
+        if (eh.is_valid() && !flipEdge(eh)) {
+            qDebug() << "Edge" << eh.idx() << "cannot be flipped (boundary, non-triangle face or duplicate edge)";
+        }
+    }
+}
 
-    if (modelLoaded) {
-        updateBuffersFromOpenMesh();
+// 拖动时顶点保持原来的NDC深度，即在过该点的视平面内跟随光标
+void ModelGLWidget::mouseMoveEvent(QMouseEvent *event) {
+    if (!draggedVertex.is_valid()) {
+        BaseGLWidget::mouseMoveEvent(event);
+        return;
     }
+
+    QVector4D ndc(2.0f * event->x() / width() - 1.0f, 1.0f - 2.0f * event->y() / height(), dragDepth, 1.0f);
+    QVector4D point = modelViewProjection().inverted().map(ndc);
+    if (point.w() == 0.0f) return;
+    point /= point.w();
+    moveVertex(draggedVertex, Mesh::Point(point.x(), point.y(), point.z()));
+}
+
+void ModelGLWidget::mouseReleaseEvent(QMouseEvent *event) {
+    if (draggedVertex.is_valid() && event->button() == Qt::LeftButton) {
+        draggedVertex = Mesh::VertexHandle();
+        return;
+    }
+    BaseGLWidget::mouseReleaseEvent(event);
+}
+
+// 曲率着色器只在上下文创建时取一次；基类初始化时若模型已加载会通过虚函数
+// 调用本类的updateBuffersFromOpenMesh，因此要先于基类就绪。之后加载模型直接走基类的loadOBJ
+void ModelGLWidget::initializeGL() {
+    curvatureProgram = ShaderRegistry::instance().program("curvature",
+        ":/glwidget/shaders/curvature.vert", ":/glwidget/shaders/curvature.frag");
+    BaseGLWidget::initializeGL();
 }
 
 // modelglwidget.cpp
@@ -37,48 +168,138 @@ void ModelGLWidget::updateBuffersFromOpenMesh() {
     // 首先调用基类的实现
     BaseGLWidget::updateBuffersFromOpenMesh();
     
-    if (openMesh.n_vertices() == 0) return;
+    if (openMesh.n_vertices() == 0 || !curvatureProgram) return;
     
     vao.bind();
     vbo.bind();
     
-    // 计算缓冲区偏移量（与基类保持一致）
-    int vertexSize = openMesh.n_vertices() * 3 * sizeof(float);
-    int normalSize = openMesh.n_vertices() * 3 * sizeof(float);
-    
-    // 设置 curvatureProgram 的属性
-    curvatureProgram.bind();
-    int posLoc = curvatureProgram.attributeLocation("aPos");
-    if (posLoc != -1) {
-        curvatureProgram.enableAttributeArray(posLoc);
-        curvatureProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
-    }
+    // 与基类使用相同的压缩顶点格式
+    setupPackedVertexAttributes(curvatureProgram);
+
+    vao.release();
     
-    int normalLoc = curvatureProgram.attributeLocation("aNormal");
-    if (normalLoc != -1) {
-        curvatureProgram.enableAttributeArray(normalLoc);
-        curvatureProgram.setAttributeBuffer(normalLoc, GL_FLOAT, vertexSize, 3, 3 * sizeof(float));
-    }
+    uploadCurvatureBuffer();
+}
+
+void ModelGLWidget::releaseGpuBuffers() {
+    BaseGLWidget::releaseGpuBuffers();
+    curvatureVbo.destroy();
+    glyphVbo.destroy();
+    glyphVertexCount = 0;
+    GpuMemoryBudget::instance().track(this, "curvatureVbo", 0);
+    GpuMemoryBudget::instance().track(this, "principalGlyphVbo", 0);
+}
 
-    int curvatureLoc = curvatureProgram.attributeLocation("aCurvature");
+// 上传曲率顶点缓冲并绑定到aCurvature，调用时需要当前上下文
+void ModelGLWidget::uploadCurvatureBuffer() {
+    calculateCurvatures();
+    
+    const size_t vertexCount = openMesh.n_vertices();
+    std::vector<uint16_t> channels(vertexCount * 6);
+    parallel::parallelFor(0, vertexCount, [&](size_t i) {
+        packCurvatureChannels(i, channels.data() + i * 6);
+    });
+    
+    curvatureVbo.create();
+    vao.bind();
+    curvatureVbo.bind();
+    curvatureVbo.allocate(channels.data(), static_cast<int>(channels.size() * sizeof(uint16_t)));
+    
+    curvatureProgram->bind();
+    int curvatureLoc = curvatureProgram->attributeLocation("aCurvature");
     if (curvatureLoc != -1) {
-        curvatureProgram.enableAttributeArray(curvatureLoc);
-        curvatureProgram.setAttributeBuffer(curvatureLoc, GL_FLOAT, vertexSize + normalSize, 1, sizeof(float));
+        curvatureProgram->enableAttributeArray(curvatureLoc);
+        curvatureProgram->setAttributeBuffer(curvatureLoc, GL_UNSIGNED_SHORT, 0, 3, 6 * sizeof(uint16_t));
     }
-
+    // 主曲率从第5个通道开始，保持4字节对齐
+    int principalLoc = curvatureProgram->attributeLocation("aPrincipal");
+    if (principalLoc != -1) {
+        curvatureProgram->enableAttributeArray(principalLoc);
+        curvatureProgram->setAttributeBuffer(principalLoc, GL_UNSIGNED_SHORT, 4 * sizeof(uint16_t), 2, 6 * sizeof(uint16_t));
+    }
+    curvatureProgram->release();
+    
+    curvatureVbo.release();
     vao.release();
+    
+    GpuMemoryBudget::instance().track(this, "curvatureVbo", curvatureVbo.size());
+    
+    uploadPrincipalDirectionGlyphs();
+}
+
+// 一个顶点的6个曲率通道（高斯、平均、最大、保留、k1、k2）
+void ModelGLWidget::packCurvatureChannels(size_t i, uint16_t* c) const {
+    auto quantize = [](float value) {
+        return static_cast<uint16_t>(std::lround(std::min(1.0f, std::max(0.0f, value)) * 65535.0f));
+    };
+    Mesh::VertexHandle vh(static_cast<int>(i));
+    c[0] = quantize(openMesh.property(gaussianCurvatureProp, vh));
+    c[1] = quantize(openMesh.property(meanCurvatureProp, vh));
+    c[2] = quantize(openMesh.property(maxCurvatureProp, vh));
+    c[3] = 0;
+    c[4] = quantize(openMesh.property(principalMaxProp, vh));
+    c[5] = quantize(openMesh.property(principalMinProp, vh));
 }
 
-void ModelGLWidget::loadOBJ(const QString &path) {
-    BaseGLWidget::loadOBJ(path); // 调用基类加载
-    if (modelLoaded) {
-        calculateCurvatures(); // 计算曲率
-        makeCurrent();
-        initializeShaders(); // 重新初始化着色器
-        doneCurrent();
+// 第g个抽样顶点的k1、k2两条线段
+void ModelGLWidget::writeGlyphSegments(size_t g, float* dir1Segment, float* dir2Segment) const {
+    Mesh::VertexHandle vh(static_cast<int>(g * glyphStep));
+    const Mesh::Point& p = openMesh.point(vh);
+    const Mesh::Normal& n = openMesh.normal(vh);
+    const PrincipalCurvature& pc = principalCurvatures[g * glyphStep];
+    
+    const float* dirs[2] = { pc.dir1, pc.dir2 };
+    float* segments[2] = { dir1Segment, dir2Segment };
+    for (int d = 0; d < 2; ++d) {
+        for (int k = 0; k < 3; ++k) {
+            float center = static_cast<float>(p[k] + n[k] * glyphHalfLength * 0.1);
+            segments[d][k] = center - dirs[d][k] * glyphHalfLength;
+            segments[d][3 + k] = center + dirs[d][k] * glyphHalfLength;
+        }
     }
 }
 
+// 由主方向生成线段：过密的网格按步长抽样，线段长度取平均边长的一半，
+// 沿法线略微抬高避免与表面深度冲突。调用时需要当前上下文
+void ModelGLWidget::uploadPrincipalDirectionGlyphs() {
+    const size_t vertexCount = principalCurvatures.size();
+    if (vertexCount == 0 || openMesh.n_edges() == 0) return;
+    
+    double edgeLengthSum = 0.0;
+    for (auto eh : openMesh.edges()) {
+        edgeLengthSum += openMesh.calc_edge_length(eh);
+    }
+    glyphHalfLength = static_cast<float>(0.25 * edgeLengthSum / openMesh.n_edges());
+    
+    const size_t maxGlyphs = 25000;
+    glyphStep = std::max<size_t>(1, (vertexCount + maxGlyphs - 1) / maxGlyphs);
+    const size_t glyphCount = (vertexCount + glyphStep - 1) / glyphStep;
+    
+    // 前半部分为k1方向线段，后半部分为k2方向线段，每条线段两个端点
+    std::vector<float> lines(glyphCount * 2 * 2 * 3);
+    parallel::parallelFor(0, glyphCount, [&](size_t g) {
+        writeGlyphSegments(g, lines.data() + g * 6, lines.data() + (glyphCount + g) * 6);
+    });
+    glyphVertexCount = static_cast<int>(glyphCount * 2);
+    
+    if (!glyphVao.isCreated()) {
+        glyphVao.create();
+    }
+    glyphVbo.create();
+    glyphVao.bind();
+    glyphVbo.bind();
+    glyphVbo.allocate(lines.data(), static_cast<int>(lines.size() * sizeof(float)));
+    
+    int posLoc = wireframeProgram->attributeLocation("aPos");
+    wireframeProgram->enableAttributeArray(posLoc);
+    wireframeProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
+    
+    glyphVbo.release();
+    glyphVao.release();
+    
+    GpuMemoryBudget::instance().track(this, "principalGlyphVbo", glyphVbo.size());
+}
+
 void ModelGLWidget::paintGL() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -86,6 +307,11 @@ void ModelGLWidget::paintGL() {
         return;
     }
 
+    ensureBuffersResident();
+    if (curvatureRangeDirty) {
+        renormalizeCurvatures();
+    }
+
     QMatrix4x4 model, view, projection;
     
     model.rotate(rotation);
@@ -94,7 +320,7 @@ void ModelGLWidget::paintGL() {
     QVector3D eyePosition(0, 0, viewDistance * viewScale);
     view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
     
-    projection.perspective(45.0f, width() / float(height()), 0.1f, 100.0f);
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
     
     QMatrix3x3 normalMatrix = model.normalMatrix();
 
@@ -120,63 +346,67 @@ void ModelGLWidget::paintGL() {
         case GaussianCurvature:
         case MeanCurvature:
         case MaxCurvature:
+        case PrincipalMaxCurvature:
+        case PrincipalMinCurvature:
             drawCurvature(model, view, projection, normalMatrix);
             break;
         case FlatShading:
             // Flat Shading渲染
-            flatProgram.bind();
+            flatProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            flatProgram.setUniformValue("model", model);
-            flatProgram.setUniformValue("view", view);
-            flatProgram.setUniformValue("projection", projection);
-            flatProgram.setUniformValue("normalMatrix", normalMatrix);
+            flatProgram->setUniformValue("model", model);
+            setPositionDequantization(flatProgram);
+            flatProgram->setUniformValue("view", view);
+            flatProgram->setUniformValue("projection", projection);
+            flatProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                flatProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                flatProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                flatProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                flatProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            flatProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            flatProgram.setUniformValue("objectColor", surfaceColor);
-            flatProgram.setUniformValue("specularEnabled", specularEnabled);
+            flatProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            flatProgram->setUniformValue("objectColor", surfaceColor);
+            flatProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            flatProgram.release();
+            flatProgram->release();
             break;
         default:
             // 调用基类的BlinnPhong渲染
-            blinnPhongProgram.bind();
+            blinnPhongProgram->bind();
             vao.bind();
             faceEbo.bind();
             
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            blinnPhongProgram.setUniformValue("model", model);
-            blinnPhongProgram.setUniformValue("view", view);
-            blinnPhongProgram.setUniformValue("projection", projection);
-            blinnPhongProgram.setUniformValue("normalMatrix", normalMatrix);
+            blinnPhongProgram->setUniformValue("model", model);
+            setPositionDequantization(blinnPhongProgram);
+            blinnPhongProgram->setUniformValue("view", view);
+            blinnPhongProgram->setUniformValue("projection", projection);
+            blinnPhongProgram->setUniformValue("normalMatrix", normalMatrix);
             
             // 设置三个光源的位置和颜色
             for (int i = 0; i < 3; i++) {
-                blinnPhongProgram.setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
-                blinnPhongProgram.setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
+                blinnPhongProgram->setUniformValue(QString("lightPositions[%1]").arg(i).toStdString().c_str(), lightPositions[i]);
+                blinnPhongProgram->setUniformValue(QString("lightColors[%1]").arg(i).toStdString().c_str(), lightColors[i]);
             }
             
-            blinnPhongProgram.setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
-            blinnPhongProgram.setUniformValue("objectColor", surfaceColor);
-            blinnPhongProgram.setUniformValue("specularEnabled", specularEnabled);
+            blinnPhongProgram->setUniformValue("viewPos", QVector3D(0, 0, viewDistance * viewScale));
+            blinnPhongProgram->setUniformValue("objectColor", surfaceColor);
+            blinnPhongProgram->setUniformValue("specularEnabled", specularEnabled);
 
             glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
 
             faceEbo.release();
             vao.release();
-            blinnPhongProgram.release();
+            blinnPhongProgram->release();
             break;
         }
 
@@ -185,6 +415,10 @@ void ModelGLWidget::paintGL() {
         }
     }
     
+    if (showPrincipalDirections) {
+        drawPrincipalDirections(model, view, projection);
+    }
+    
     if (showAxis) {
         drawXYZAxis(view, projection);
     }
@@ -194,155 +428,204 @@ void ModelGLWidget::paintGL() {
 }
 
 void ModelGLWidget::drawCurvature(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection, const QMatrix3x3& normalMatrix) {
-    curvatureProgram.bind();
+    curvatureProgram->bind();
     vao.bind();
     faceEbo.bind();
     
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    curvatureProgram.setUniformValue("model", model);
-    curvatureProgram.setUniformValue("view", view);
-    curvatureProgram.setUniformValue("projection", projection);
-    curvatureProgram.setUniformValue("normalMatrix", normalMatrix);
-    curvatureProgram.setUniformValue("curvatureType", static_cast<int>(currentRenderMode));
+    curvatureProgram->setUniformValue("model", model);
+    setPositionDequantization(curvatureProgram);
+    curvatureProgram->setUniformValue("view", view);
+    curvatureProgram->setUniformValue("projection", projection);
+    curvatureProgram->setUniformValue("normalMatrix", normalMatrix);
+    curvatureProgram->setUniformValue("curvatureType", static_cast<int>(currentRenderMode));
     
     glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
     
     faceEbo.release();
     vao.release();
-    curvatureProgram.release();
+    curvatureProgram->release();
 }
 
+// k1方向红色、k2方向蓝色；线段已是模型空间坐标，不需要反量化
+void ModelGLWidget::drawPrincipalDirections(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection) {
+    if (glyphVertexCount == 0) return;
+    
+    wireframeProgram->bind();
+    glyphVao.bind();
+    
+    wireframeProgram->setUniformValue("model", model);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("posOffset", QVector3D(0.0f, 0.0f, 0.0f));
+    wireframeProgram->setUniformValue("posScale", QVector3D(1.0f, 1.0f, 1.0f));
+    
+    glLineWidth(1.5f);
+    wireframeProgram->setUniformValue("lineColor", QVector4D(0.9f, 0.1f, 0.1f, 1.0f));
+    glDrawArrays(GL_LINES, 0, glyphVertexCount);
+    wireframeProgram->setUniformValue("lineColor", QVector4D(0.1f, 0.3f, 0.9f, 1.0f));
+    glDrawArrays(GL_LINES, glyphVertexCount, glyphVertexCount);
+    glLineWidth(1.0f);
+    
+    glyphVao.release();
+    wireframeProgram->release();
+}
+
+// 计算全部曲率通道（高斯、平均、最大、主曲率k1/k2）并分别归一化到[0,1]，几何未变化时直接返回
 void ModelGLWidget::calculateCurvatures() {
-    if (openMesh.n_vertices() == 0) return;
+    if (openMesh.n_vertices() == 0 || curvatureVersion == geometryVersion) return;
     
-    for (auto vh : openMesh.vertices()) {
-        if (openMesh.is_boundary(vh)) {
-            openMesh.data(vh).curvature = 0.0f;
-            continue;
-        }
-        
-        float angleDefect = 2 * M_PI;
-        float area = 0.0f;
-        
-        for (auto vf_it = openMesh.vf_begin(vh); vf_it != openMesh.vf_end(vh); ++vf_it) {
-            auto heh = openMesh.halfedge_handle(*vf_it);
-            while (openMesh.to_vertex_handle(heh) != vh) {
-                heh = openMesh.next_halfedge_handle(heh);
-            }
-            
-            auto v1 = openMesh.point(openMesh.from_vertex_handle(heh));
-            auto v2 = openMesh.point(openMesh.to_vertex_handle(heh));
-            auto heh_next = openMesh.next_halfedge_handle(heh);
-            auto v3 = openMesh.point(openMesh.to_vertex_handle(heh_next));
-            
-            auto vec1 = (v1 - v2).normalize();
-            auto vec2 = (v3 - v2).normalize();
-            float angle = acos(std::max(-1.0d, std::min(1.0d, dot(vec1, vec2))));
-            angleDefect -= angle;
-            
-            auto cross = (v1 - v2) % (v3 - v2);
-            area += cross.length() / 6.0f;
-        }
-        
-        float gaussianCurvature = 0.0f;
-        if (area > EPSILON) {
-            gaussianCurvature = angleDefect / area;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    if (!gaussianCurvatureProp.is_valid()) {
+        openMesh.add_property(gaussianCurvatureProp, "v:gaussian_curvature");
+        openMesh.add_property(meanCurvatureProp, "v:mean_curvature");
+        openMesh.add_property(maxCurvatureProp, "v:max_curvature");
+        openMesh.add_property(principalMaxProp, "v:principal_max_curvature");
+        openMesh.add_property(principalMinProp, "v:principal_min_curvature");
+    }
+    
+    // 高斯曲率与平均曲率在一次遍历中并行求出
+    computeVertexCurvatures(openMesh, geometry(), rawCurvatures);
+    // 主曲率：逐面拟合曲率张量后在顶点处特征分解
+    estimatePrincipalCurvatures(openMesh, principalCurvatures);
+    
+    computeCurvatureRanges();
+    parallel::parallelFor(0, rawCurvatures.size(), [&](size_t i) {
+        normalizeCurvatureAt(i);
+    });
+    curvatureVersion = geometryVersion;
+    curvatureRangeDirty = false;
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    qDebug() << "Curvature computed for" << openMesh.n_vertices() << "vertices on"
+             << parallel::threadCount() << "threads in"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
+}
+
+// 曲率通道0/1/2：高斯、平均、二者之和
+float ModelGLWidget::curvatureChannel(size_t i, int channel) const {
+    const VertexCurvature& c = rawCurvatures[i];
+    return channel == 0 ? c.gaussian : channel == 1 ? c.mean : c.gaussian + c.mean;
+}
+
+// 各通道在非边界顶点上的最小/最大值；k1/k2有正负，以0为中心，
+// 用|k|的95%分位数截断，避免尖锐特征压扁色带
+void ModelGLWidget::computeCurvatureRanges() {
+    const size_t vertexCount = rawCurvatures.size();
+    std::vector<float> values(vertexCount);
+    for (int channel = 0; channel < 3; ++channel) {
+        parallel::parallelFor(0, vertexCount, [&](size_t i) {
+            values[i] = curvatureChannel(i, channel);
+        });
+        curvatureHasInterior[channel] = curvatureRange(openMesh, values, curvatureMin[channel], curvatureMax[channel]);
+    }
+    
+    std::vector<float> magnitudes(vertexCount * 2);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        magnitudes[i * 2] = std::abs(principalCurvatures[i].k1);
+        magnitudes[i * 2 + 1] = std::abs(principalCurvatures[i].k2);
+    }
+    principalScale = 0.0f;
+    if (!magnitudes.empty()) {
+        auto nth = magnitudes.begin() + static_cast<std::ptrdiff_t>(magnitudes.size() * 95 / 100);
+        std::nth_element(magnitudes.begin(), nth, magnitudes.end());
+        principalScale = *nth;
+    }
+}
+
+// 按当前范围把第i个顶点的原始曲率归一化写入属性（边界顶点保持原值）
+void ModelGLWidget::normalizeCurvatureAt(size_t i) {
+    Mesh::VertexHandle vh(static_cast<int>(i));
+    OpenMesh::VPropHandleT<float> props[3] = { gaussianCurvatureProp, meanCurvatureProp, maxCurvatureProp };
+    bool boundary = openMesh.is_boundary(vh);
+    for (int channel = 0; channel < 3; ++channel) {
+        float value = curvatureChannel(i, channel);
+        float range = curvatureMax[channel] - curvatureMin[channel];
+        if (curvatureHasInterior[channel] && range > 0 && !boundary) {
+            value = (value - curvatureMin[channel]) / range;
         }
-        
-        float A_mixed = 0.f;
-        for (auto vv_it = openMesh.vv_begin(vh); vv_it != openMesh.vv_end(vh); ++vv_it) {
-            auto adjV = *vv_it;
-            auto heh = openMesh.find_halfedge(vh, adjV);
-            if (!heh.is_valid()) continue;
-            
-            Mesh::VertexHandle np;
-            if (!openMesh.is_boundary(heh)) {
-                auto next_heh = openMesh.next_halfedge_handle(heh);
-                np = openMesh.to_vertex_handle(next_heh);
-            } else {
-                auto opp_heh = openMesh.opposite_halfedge_handle(heh);
-                if (!openMesh.is_boundary(opp_heh)) {
-                    auto next_opp_heh = openMesh.next_halfedge_handle(opp_heh);
-                    np = openMesh.to_vertex_handle(next_opp_heh);
-                } else {
-                    continue;
-                }
-            }
+        openMesh.property(props[channel], vh) = value;
+    }
+    
+    float k1 = 0.5f, k2 = 0.5f;
+    if (principalScale > 0) {
+        k1 = 0.5f + 0.5f * principalCurvatures[i].k1 / principalScale;
+        k2 = 0.5f + 0.5f * principalCurvatures[i].k2 / principalScale;
+    }
+    openMesh.property(principalMaxProp, vh) = k1;
+    openMesh.property(principalMinProp, vh) = k2;
+}
 
-            auto p_v = openMesh.point(vh);
-            auto p_adjV = openMesh.point(adjV);
-            auto p_np = openMesh.point(np);
-            
-            auto vec_adjV = p_adjV - p_v;
-            auto vec_np = p_np - p_v;
-            
-            bool nonObtuse = 
-                (vec_adjV | vec_np) >= 0.0f &&
-                (p_v - p_adjV | p_np - p_adjV) >= 0.0f &&
-                (p_v - p_np | p_adjV - p_np) >= 0.0f;
-            
-            if (nonObtuse) {
-                float area = ((p_adjV - p_v) % (p_np - p_v)).length() / 2.0f;
-                if (area > EPSILON) {
-                    float cotB = dot(vec_np, vec_adjV) / cross(vec_np, vec_adjV).length();
-                    float cotA = dot(vec_adjV, vec_np) / cross(vec_adjV, vec_np).length();
-                    
-                    float dist2_adjV = vec_adjV.sqrnorm();
-                    float dist2_np = vec_np.sqrnorm();
-                    
-                    A_mixed += (dist2_adjV * cotB + dist2_np * cotA) / 8.0f;
-                }
-            } else {
-                float area = ((p_adjV - p_v) % (p_np - p_v)).length() / 2.0f;
-                if (area > EPSILON) {
-                    if ((vec_adjV | vec_np) < 0.0f) {
-                        A_mixed += area / 2.0f;
-                    } else {
-                        A_mixed += area / 4.0f;
-                    }
-                }
+// 局部编辑：ring1重算高斯/平均曲率，ring2重算主曲率。
+// 新值落在已有范围内时只归一化并上传变化的顶点区间；超出范围则扩展范围，
+// 推迟到下次绘制时整体重新归一化（范围只扩不缩，直到下次整体计算）
+void ModelGLWidget::onLocalEdit(const LocalEdit& edit) {
+    if (curvatureVersion != edit.previousVersion || rawCurvatures.size() != openMesh.n_vertices()) return;
+    if (edit.ring2.empty()) {
+        curvatureVersion = geometryVersion;
+        return;
+    }
+    
+    const GeometryCache& cache = geometry();
+    for (auto vh : edit.ring1) {
+        rawCurvatures[vh.idx()] = computeVertexCurvature(openMesh, cache, vh);
+        if (openMesh.is_boundary(vh)) continue;
+        for (int channel = 0; channel < 3; ++channel) {
+            float value = curvatureChannel(vh.idx(), channel);
+            if (!curvatureHasInterior[channel] || value < curvatureMin[channel] || value > curvatureMax[channel]) {
+                curvatureMin[channel] = curvatureHasInterior[channel] ? std::min(curvatureMin[channel], value) : value;
+                curvatureMax[channel] = curvatureHasInterior[channel] ? std::max(curvatureMax[channel], value) : value;
+                curvatureHasInterior[channel] = true;
+                curvatureRangeDirty = true;
             }
         }
-        
-        float meanCurvature = 0.0f;
-        if (A_mixed > EPSILON) {
-            meanCurvature = 0.5f * sqrt(A_mixed);
-        }
-        switch (currentRenderMode) {
-        case GaussianCurvature:
-            openMesh.data(vh).curvature = gaussianCurvature;
-            break;
-        case MeanCurvature:
-            openMesh.data(vh).curvature = meanCurvature;
-            break;
-        case MaxCurvature:
-            openMesh.data(vh).curvature = gaussianCurvature + meanCurvature;
-            break;
-        default:
-            openMesh.data(vh).curvature = 0.0f;
-            break;
-        }
-
     }
+    updatePrincipalCurvatures(openMesh, edit.ring2, principalCurvatures);
+    curvatureVersion = geometryVersion;
     
-    // Normalize curvatures
-    float minCurvature = FLT_MAX;
-    float maxCurvature = -FLT_MAX;
+    if (curvatureRangeDirty) return;
     
-    for (auto vh : openMesh.vertices()) {
-        if (!openMesh.is_boundary(vh)) {
-            minCurvature = std::min(minCurvature, openMesh.data(vh).curvature);
-            maxCurvature = std::max(maxCurvature, openMesh.data(vh).curvature);
-        }
+    for (auto vh : edit.ring2) {
+        normalizeCurvatureAt(vh.idx());
     }
+    if (!buffersResident || !curvatureVbo.isCreated()) return;
     
-    float range = maxCurvature - minCurvature;
-    if (range > 0) {
-        for (auto vh : openMesh.vertices()) {
-            if (!openMesh.is_boundary(vh)) {
-                openMesh.data(vh).curvature = 
-                    (openMesh.data(vh).curvature - minCurvature) / range;
-            }
+    int first = edit.ring2.front().idx();
+    int last = edit.ring2.back().idx();
+    std::vector<uint16_t> channels(size_t(last - first + 1) * 6);
+    for (int i = first; i <= last; ++i) {
+        packCurvatureChannels(i, channels.data() + size_t(i - first) * 6);
+    }
+    
+    makeCurrent();
+    curvatureVbo.bind();
+    curvatureVbo.write(first * 6 * static_cast<int>(sizeof(uint16_t)), channels.data(),
+                       static_cast<int>(channels.size() * sizeof(uint16_t)));
+    curvatureVbo.release();
+    
+    // 只改写落在抽样步长上的主方向线段
+    if (glyphVertexCount > 0 && glyphVbo.isCreated()) {
+        const size_t glyphCount = glyphVertexCount / 2;
+        glyphVbo.bind();
+        for (auto vh : edit.ring2) {
+            if (vh.idx() % glyphStep != 0) continue;
+            size_t g = vh.idx() / glyphStep;
+            float segments[12];
+            writeGlyphSegments(g, segments, segments + 6);
+            glyphVbo.write(static_cast<int>(g * 6 * sizeof(float)), segments, 6 * sizeof(float));
+            glyphVbo.write(static_cast<int>((glyphCount + g) * 6 * sizeof(float)), segments + 6, 6 * sizeof(float));
         }
+        glyphVbo.release();
     }
-}
\ No newline at end of file
+    doneCurrent();
+}
+
+// 局部编辑扩展了曲率范围后，在绘制前整体重新归一化并上传一次
+void ModelGLWidget::renormalizeCurvatures() {
+    parallel::parallelFor(0, rawCurvatures.size(), [&](size_t i) {
+        normalizeCurvatureAt(i);
+    });
+    curvatureRangeDirty = false;
+    uploadCurvatureBuffer();
+}
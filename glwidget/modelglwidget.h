@@ -3,6 +3,8 @@
 #define MODELGLWIDGET_H
 
 #include "baseglwidget.h"
+#include "../meshutils/curvature.h"
+#include "../meshutils/principal_curvature.h"
 #include <QOpenGLShaderProgram>
 
 class ModelGLWidget : public BaseGLWidget
@@ -14,17 +16,80 @@ public:
     ~ModelGLWidget() override = default;
 
     void setRenderMode(RenderMode mode) ;
-    void updateBuffersFromOpenMesh();
+    void setShowPrincipalDirections(bool show);
+    
+    // 编辑工具：拖动顶点（在视平面内移动）或点击翻转边，均走局部增量更新
+    enum EditTool {
+        NoEditTool,
+        MoveVertexTool,
+        FlipEdgeTool
+    };
+    void setEditTool(EditTool tool);
+    void updateBuffersFromOpenMesh() override;
+    void releaseGpuBuffers() override;
     void calculateCurvatures();
     void drawCurvature(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection, const QMatrix3x3& normalMatrix);
+    void drawPrincipalDirections(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
 
 public:
-    void initializeShaders();
     void paintGL() override;
-    void loadOBJ(const QString &path);
+
+protected:
+    void initializeGL() override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void onLocalEdit(const LocalEdit& edit) override;
 
 private:
-    QOpenGLShaderProgram curvatureProgram;
+    QOpenGLShaderProgram *curvatureProgram = nullptr;
+    
+    // 编辑拾取：CPU投影到屏幕，只考虑朝向相机的顶点/面，不需要GL上下文
+    EditTool editTool = NoEditTool;
+    Mesh::VertexHandle draggedVertex;
+    float dragDepth = 0.0f;             // 拖动顶点的NDC深度，拖动过程中保持不变
+    QMatrix4x4 modelViewProjection() const;
+    QVector3D eyeInModelSpace() const;
+    Mesh::VertexHandle pickVertex(const QPoint& pos, float& ndcDepth) const;
+    Mesh::EdgeHandle pickEdge(const QPoint& pos) const;
+    
+    // 三种曲率各存为一个顶点属性，每个几何版本只计算一次
+    OpenMesh::VPropHandleT<float> gaussianCurvatureProp;
+    OpenMesh::VPropHandleT<float> meanCurvatureProp;
+    OpenMesh::VPropHandleT<float> maxCurvatureProp;
+    OpenMesh::VPropHandleT<float> principalMaxProp;
+    OpenMesh::VPropHandleT<float> principalMinProp;
+    quint64 curvatureVersion = ~quint64(0);
+    
+    // 原始曲率与归一化范围，局部编辑时据此只更新受影响的顶点
+    std::vector<VertexCurvature> rawCurvatures;
+    float curvatureMin[3] = { 0, 0, 0 };
+    float curvatureMax[3] = { 0, 0, 0 };
+    bool curvatureHasInterior[3] = { false, false, false };
+    float principalScale = 0.0f;
+    bool curvatureRangeDirty = false;   // 局部编辑扩展了范围，需要整体重新归一化
+    float curvatureChannel(size_t i, int channel) const;
+    void computeCurvatureRanges();
+    void normalizeCurvatureAt(size_t i);
+    void renormalizeCurvatures();
+    
+    // 原始主曲率与主方向，用于生成方向线段
+    std::vector<PrincipalCurvature> principalCurvatures;
+    
+    // 曲率顶点缓冲：每顶点6个16位归一化通道（高斯、平均、最大、保留、k1、k2）
+    QOpenGLBuffer curvatureVbo;
+    void uploadCurvatureBuffer();
+    void packCurvatureChannels(size_t i, uint16_t* channels) const;
+    
+    // 主方向线段：k1方向在前、k2方向在后，模型空间float坐标
+    bool showPrincipalDirections = false;
+    QOpenGLVertexArrayObject glyphVao;
+    QOpenGLBuffer glyphVbo;
+    int glyphVertexCount = 0;
+    size_t glyphStep = 1;
+    float glyphHalfLength = 0.0f;
+    void uploadPrincipalDirectionGlyphs();
+    void writeGlyphSegments(size_t g, float* dir1Segment, float* dir2Segment) const;
 };
 
 #endif // MODELGLWIDGET_H
\ No newline at end of file
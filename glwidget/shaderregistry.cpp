@@ -0,0 +1,79 @@
+// shaderregistry.cpp
+#include "shaderregistry.h"
+#include <QDebug>
+
+ShaderRegistry& ShaderRegistry::instance() {
+    static ShaderRegistry registry;
+    return registry;
+}
+
+QOpenGLShaderProgram* ShaderRegistry::createProgram(QOpenGLContextGroup* group, const QString& name) {
+    // 程序挂在共享组下，组销毁时一并释放
+    QOpenGLShaderProgram* program = new QOpenGLShaderProgram(group);
+    program->setObjectName(name);
+
+    auto key = qMakePair(group, name);
+    programs.insert(key, program);
+    QObject::connect(program, &QObject::destroyed, [this, key]() {
+        programs.remove(key);
+    });
+    return program;
+}
+
+QOpenGLShaderProgram* ShaderRegistry::program(const QString& name, const QString& vertPath, const QString& fragPath) {
+    QOpenGLContext* ctx = QOpenGLContext::currentContext();
+    if (!ctx) {
+        qWarning() << "ShaderRegistry: no current context for program" << name;
+        return nullptr;
+    }
+
+    auto it = programs.constFind(qMakePair(ctx->shareGroup(), name));
+    if (it != programs.constEnd()) {
+        return it.value();
+    }
+
+    QOpenGLShaderProgram* program = createProgram(ctx->shareGroup(), name);
+    program->addCacheableShaderFromSourceFile(QOpenGLShader::Vertex, vertPath);
+    program->addCacheableShaderFromSourceFile(QOpenGLShader::Fragment, fragPath);
+    if (!program->link()) {
+        qWarning() << "ShaderRegistry: failed to link" << name << program->log();
+    }
+    return program;
+}
+
+QOpenGLShaderProgram* ShaderRegistry::programFromSource(const QString& name, const char* vertSrc, const char* fragSrc) {
+    QOpenGLContext* ctx = QOpenGLContext::currentContext();
+    if (!ctx) {
+        qWarning() << "ShaderRegistry: no current context for program" << name;
+        return nullptr;
+    }
+
+    auto it = programs.constFind(qMakePair(ctx->shareGroup(), name));
+    if (it != programs.constEnd()) {
+        return it.value();
+    }
+
+    QOpenGLShaderProgram* program = createProgram(ctx->shareGroup(), name);
+    program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertSrc);
+    program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragSrc);
+    if (!program->link()) {
+        qWarning() << "ShaderRegistry: failed to link" << name << program->log();
+    }
+    return program;
+}
+
+QOpenGLShaderProgram* ShaderRegistry::wireframe() {
+    return program("wireframe", ":/glwidget/shaders/wireframe.vert", ":/glwidget/shaders/wireframe.frag");
+}
+
+QOpenGLShaderProgram* ShaderRegistry::blinnPhong() {
+    return program("blinnphong", ":/glwidget/shaders/blinnphong.vert", ":/glwidget/shaders/blinnphong.frag");
+}
+
+QOpenGLShaderProgram* ShaderRegistry::flat() {
+    return program("flat", ":/glwidget/shaders/flat.vert", ":/glwidget/shaders/flat.frag");
+}
+
+QOpenGLShaderProgram* ShaderRegistry::axis() {
+    return program("axis", ":/glwidget/shaders/axis.vert", ":/glwidget/shaders/axis.frag");
+}
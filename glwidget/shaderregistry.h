@@ -0,0 +1,44 @@
+// shaderregistry.h
+#ifndef SHADERREGISTRY_H
+#define SHADERREGISTRY_H
+
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+// 进程级着色器程序注册表
+// 所有GL窗口位于同一个共享上下文组（Qt::AA_ShareOpenGLContexts），
+// 因此同名程序只需编译、链接一次即可在各窗口间复用。
+// 程序二进制通过Qt的可缓存着色器接口（glGetProgramBinary）写入磁盘缓存，
+// 缓存键由驱动字符串（GL_VENDOR/GL_RENDERER/GL_VERSION）和着色器源码哈希组成，
+// 再次启动时直接加载二进制，跳过GLSL编译。
+class ShaderRegistry
+{
+public:
+    static ShaderRegistry& instance();
+
+    // 从资源文件获取（首次调用时编译链接）着色器程序，调用时必须有当前上下文
+    QOpenGLShaderProgram* program(const QString& name, const QString& vertPath, const QString& fragPath);
+    // 从源码字符串获取着色器程序
+    QOpenGLShaderProgram* programFromSource(const QString& name, const char* vertSrc, const char* fragSrc);
+
+    // 常用程序的便捷入口
+    QOpenGLShaderProgram* wireframe();
+    QOpenGLShaderProgram* blinnPhong();
+    QOpenGLShaderProgram* flat();
+    QOpenGLShaderProgram* axis();
+
+private:
+    ShaderRegistry() = default;
+    ShaderRegistry(const ShaderRegistry&) = delete;
+    ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+    QOpenGLShaderProgram* createProgram(QOpenGLContextGroup* group, const QString& name);
+
+    // 按共享组区分，未开启上下文共享时每个组各自持有一份
+    QHash<QPair<QOpenGLContextGroup*, QString>, QOpenGLShaderProgram*> programs;
+};
+
+#endif // SHADERREGISTRY_H
@@ -1,8 +1,12 @@
 #version 420 core
 in vec3 FragPos;
 in vec3 Normal;
-in float Curvature;
+in vec3 Curvatures;
+in vec2 PrincipalCurvatures;
 out vec4 FragColor;
+// 渲染模式枚举值：GaussianCurvature=2, MeanCurvature=3, MaxCurvature=4,
+// PrincipalMaxCurvature=5, PrincipalMinCurvature=6（主曲率以0为中心映射，0.5对应k=0）
+// 切换模式只改变这个uniform，不需要重新计算或上传
 uniform int curvatureType;
 
 vec3 mapToColor(float c) {
@@ -39,6 +43,9 @@ vec3 mapToColor(float c) {
 }
 
 void main() {
-    vec3 color = mapToColor(Curvature);
+    float curvature = curvatureType >= 5
+        ? PrincipalCurvatures[clamp(curvatureType - 5, 0, 1)]
+        : Curvatures[clamp(curvatureType - 2, 0, 2)];
+    vec3 color = mapToColor(curvature);
     FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
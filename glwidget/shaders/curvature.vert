@@ -1,18 +1,33 @@
 #version 420 core
+// 压缩顶点格式：16位量化位置 + 八面体编码法线
+// 曲率来自独立的顶点缓冲：高斯、平均、最大三个16位归一化通道，另有主曲率k1、k2两个通道
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
-layout(location = 2) in float aCurvature;
+layout(location = 1) in vec2 aNormal;
+layout(location = 2) in vec3 aCurvature;
+layout(location = 3) in vec2 aPrincipal;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat3 normalMatrix;
+uniform vec3 posOffset;
+uniform vec3 posScale;
 out vec3 FragPos;
 out vec3 Normal;
-out float Curvature;
+out vec3 Curvatures;
+out vec2 PrincipalCurvatures;
+
+vec3 octDecode(vec2 e) {
+   vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+   float t = max(-n.z, 0.0);
+   n.x += n.x >= 0.0 ? -t : t;
+   n.y += n.y >= 0.0 ? -t : t;
+   return normalize(n);
+}
 
 void main() {
-   FragPos = vec3(model * vec4(aPos, 1.0));
-   Normal = normalMatrix * aNormal;
-   Curvature = aCurvature;
+   FragPos = vec3(model * vec4(posOffset + aPos * posScale, 1.0));
+   Normal = normalMatrix * octDecode(aNormal);
+   Curvatures = aCurvature;
+   PrincipalCurvatures = aPrincipal;
    gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
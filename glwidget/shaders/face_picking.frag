@@ -1,9 +1,9 @@
 #version 430 core
 
-out vec4 FragColor;
+// 三角形序号写入0号整数附件（ID+1，0表示背景），可用于面元拾取
+layout (location = 0) out uint FaceId;
 
 void main()
 {
-    // 面元绘制为黑色
-    FragColor = vec4(1.0, 1.0, 1.0, 1.0);
+    FaceId = uint(gl_PrimitiveID) + 1u;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #version 430 core
+// 压缩顶点格式：16位量化位置 + 八面体编码法线
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec2 aNormal;
 
 out vec3 FragPos;
 out vec3 Normal;
@@ -9,10 +10,21 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat3 normalMatrix;
+uniform vec3 posOffset;
+uniform vec3 posScale;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = normalMatrix * aNormal;
+    FragPos = vec3(model * vec4(posOffset + aPos * posScale, 1.0));
+    Normal = normalMatrix * octDecode(aNormal);
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
@@ -1,14 +1,10 @@
 #version 430 core
 flat in int vertexID;
 
-out vec4 FragColor;
+// 顶点ID写入1号整数附件（ID+1，0表示背景），不再受24位颜色编码的限制
+layout (location = 1) out uint VertexId;
 
 void main()
 {
-    // 将顶点ID编码为颜色
-    int r = (vertexID) & 0xFF;
-    int g = (vertexID >> 8) & 0xFF;
-    int b = (vertexID >> 16) & 0xFF;
-    
-    FragColor = vec4(float(r) / 255.0, float(g) / 255.0, float(b) / 255.0, 1.0);
+    VertexId = uint(vertexID) + 1u;
 }
\ No newline at end of file
@@ -1,17 +1,20 @@
 #version 430 core
+// 压缩顶点格式：16位量化位置
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 posOffset;
+uniform vec3 posScale;
 
 flat out int vertexID;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec4 worldPos = model * vec4(posOffset + aPos * posScale, 1.0);
     vec4 viewPos = view * worldPos;
     gl_Position = projection * viewPos;
     gl_PointSize = 15.0; // 可选：增加点大小以提高拾取精度
     vertexID = gl_VertexID;
-}
\ No newline at end of file
+}
@@ -0,0 +1,19 @@
+#version 430 core
+in vec3 ViewPos;
+
+out vec4 FragColor;
+
+// 每个三角形一个RGBA8颜色，按图元编号索引
+layout (std430, binding = 0) readonly buffer TriangleColors {
+    uint triangleColors[];
+};
+
+void main()
+{
+    // 观察空间的面法向量，朝向视线的面更亮
+    vec3 faceNormal = normalize(cross(dFdx(ViewPos), dFdy(ViewPos)));
+    float shade = 0.35 + 0.65 * abs(faceNormal.z);
+
+    vec4 color = unpackUnorm4x8(triangleColors[gl_PrimitiveID]);
+    FragColor = vec4(color.rgb * shade, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 430 core
+// 压缩顶点格式：16位量化位置
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 posOffset;
+uniform vec3 posScale;
+
+out vec3 ViewPos;
+
+void main()
+{
+    vec4 viewPos = view * model * vec4(posOffset + aPos * posScale, 1.0);
+    ViewPos = viewPos.xyz;
+    gl_Position = projection * viewPos;
+}
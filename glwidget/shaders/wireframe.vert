@@ -1,9 +1,12 @@
 #version 420 core
+// 压缩顶点格式：16位量化位置
 layout(location = 0) in vec3 aPos;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 posOffset;
+uniform vec3 posScale;
 
 void main() {
-   gl_Position = projection * view * model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+   gl_Position = projection * view * model * vec4(posOffset + aPos * posScale, 1.0);
+}
@@ -1,29 +1,51 @@
 #include "shortestpathglwidget.h"
+#include "shaderregistry.h"
+#include "../meshutils/parallel_utils.h"
 #include <QMouseEvent>
-#include <QOpenGLFramebufferObjectFormat>
+#include <QEvent>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLContext>
+#include <QImage>
 #include <QOpenGLPaintDevice>
 #include <QPainter>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
 #include <set>
 #include <chrono>
 
 
 ShortestPathGLWidget::ShortestPathGLWidget(QWidget *parent) 
-    : BaseGLWidget(parent), pickingFBO(nullptr), pathEdgeEbo(QOpenGLBuffer::IndexBuffer)
+    : BaseGLWidget(parent), pickPbo(QOpenGLBuffer::PixelPackBuffer),
+      pathEdgeEbo(QOpenGLBuffer::IndexBuffer), highlightEbo(QOpenGLBuffer::IndexBuffer),
+      selectionEbo(QOpenGLBuffer::IndexBuffer)
 {
-
+    // 悬停高亮需要在未按键时也收到鼠标移动事件
+    setMouseTracking(true);
 }
 
 // 在析构函数中销毁pathEdgeEbo
 ShortestPathGLWidget::~ShortestPathGLWidget()
 {
-    makeCurrent();
-    if (pickingFBO) {
-        delete pickingFBO;
+    // 等待后台的地标预处理结束，它投递的排队调用随本对象一起被丢弃
+    if (landmarkJob.valid()) {
+        landmarkJob.wait();
     }
-    pickingProgram.removeAllShaders();
+    makeCurrent();
+    destroyPickingFBO();
     pathEdgeEbo.destroy(); // 添加这行
+    pathPolylineVbo.destroy();
+    pathPolylineVao.destroy();
+    highlightEbo.destroy();
+    selectionEbo.destroy();
+    distanceVbo.destroy();
+    fieldTraceVbo.destroy();
+    fieldTraceVao.destroy();
+    voronoiColorBuffer.destroy();
+    pickPbo.destroy();
     doneCurrent();
 }
 
@@ -39,30 +61,235 @@ void ShortestPathGLWidget::initializeGL()
 void ShortestPathGLWidget::initializePickingShaders()
 {
     // 顶点拾取着色器
-    pickingProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/picking.vert");
-    pickingProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/picking.frag");
-    pickingProgram.link();
+    pickingProgram = ShaderRegistry::instance().program("picking",
+        ":/glwidget/shaders/picking.vert", ":/glwidget/shaders/picking.frag");
     
     // 面元拾取着色器
-    facePickingProgram.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/glwidget/shaders/picking.vert");
-    facePickingProgram.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/glwidget/shaders/face_picking.frag");
-    facePickingProgram.link();
+    facePickingProgram = ShaderRegistry::instance().program("face_picking",
+        ":/glwidget/shaders/picking.vert", ":/glwidget/shaders/face_picking.frag");
+    
+    // 距离场复用曲率着色器的颜色映射
+    distanceProgram = ShaderRegistry::instance().program("curvature",
+        ":/glwidget/shaders/curvature.vert", ":/glwidget/shaders/curvature.frag");
+    
+    // Voronoi单元按三角形着色
+    voronoiProgram = ShaderRegistry::instance().program("voronoi",
+        ":/glwidget/shaders/voronoi.vert", ":/glwidget/shaders/voronoi.frag");
+    
+    ensurePickingFBO();
+}
+
+void ShortestPathGLWidget::resizeGL(int w, int h)
+{
+    BaseGLWidget::resizeGL(w, h);
+    
+    // 拾取FBO需要与窗口同尺寸，否则窗口放大后外侧区域无法拾取
+    if (pickingFbo) {
+        ensurePickingFBO();
+    }
+}
+
+void ShortestPathGLWidget::ensurePickingFBO()
+{
+    QSize size(width(), height());
+    if (pickingFbo && pickingSize == size) return;
+    
+    destroyPickingFBO();
+    pickingSize = size;
+    
+    // 两个32位无符号整数颜色附件：0号存面元ID，1号存顶点ID（均为ID+1，0表示背景）
+    GLuint textures[2];
+    glGenTextures(2, textures);
+    pickingFaceTex = textures[0];
+    pickingVertexTex = textures[1];
+    for (GLuint tex : textures) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, size.width(), size.height(), 0,
+                     GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    glGenRenderbuffers(1, &pickingDepthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, pickingDepthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.width(), size.height());
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    
+    glGenFramebuffers(1, &pickingFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, pickingFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pickingFaceTex, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, pickingVertexTex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, pickingDepthRbo);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        qWarning() << "Picking framebuffer is incomplete";
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
     
-    // 创建帧缓冲对象用于颜色编码拾取
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    pickingFBO = new QOpenGLFramebufferObject(width(), height(), format);
+    // 两个R32UI附件 + 24位深度
+    GpuMemoryBudget::instance().track(this, "pickingFBO", qint64(size.width()) * size.height() * 12);
+}
+
+void ShortestPathGLWidget::destroyPickingFBO()
+{
+    if (!pickingFbo) return;
+    
+    glDeleteFramebuffers(1, &pickingFbo);
+    glDeleteRenderbuffers(1, &pickingDepthRbo);
+    GLuint textures[2] = {pickingFaceTex, pickingVertexTex};
+    glDeleteTextures(2, textures);
+    pickingFbo = pickingDepthRbo = pickingFaceTex = pickingVertexTex = 0;
+    pickingSize = QSize();
+    
+    GpuMemoryBudget::instance().track(this, "pickingFBO", 0);
+}
+
+void ShortestPathGLWidget::updateBuffersFromOpenMesh()
+{
+    BaseGLWidget::updateBuffersFromOpenMesh();
+    uploadPathEdges();
+    highlightDirty = true;
+    selectionDirty = true;
+}
+
+void ShortestPathGLWidget::releaseGpuBuffers()
+{
+    BaseGLWidget::releaseGpuBuffers();
+    pathEdgeEbo.destroy();
+    pathPolylineVbo.destroy();
+    highlightEbo.destroy();
+    selectionEbo.destroy();
+    distanceVbo.destroy();
+    fieldTraceVbo.destroy();
+    voronoiColorBuffer.destroy();
+    destroyPickingFBO();
+    highlightDirty = true;
+    selectionDirty = true;
+    distanceFieldDirty = true;
+    fieldTraceDirty = true;
+    voronoiDirty = true;
+    
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "pathEdgeEbo", 0);
+    budget.track(this, "pathPolylineVbo", 0);
+    budget.track(this, "highlightEbo", 0);
+    budget.track(this, "selectionEbo", 0);
+    budget.track(this, "distanceVbo", 0);
+    budget.track(this, "fieldTraceVbo", 0);
+    budget.track(this, "voronoiColorBuffer", 0);
+}
+
+// 上传路径边索引，调用时需要当前上下文
+void ShortestPathGLWidget::uploadPathEdges()
+{
+    pathEdgeEbo.create();
+    pathEdgeEbo.bind();
+    if (!pathEdgeIndices.empty()) {
+        pathEdgeEbo.allocate(pathEdgeIndices.data(), pathEdgeIndices.size() * sizeof(unsigned int));
+    } else {
+        pathEdgeEbo.allocate(0);
+    }
+    pathEdgeEbo.release();
+    pathEdgesDirty = false;
+    
+    GpuMemoryBudget::instance().track(this, "pathEdgeEbo", pathEdgeEbo.size());
+    
+    if (!wireframeProgram) return;
+    if (!pathPolylineVao.isCreated()) {
+        pathPolylineVao.create();
+    }
+    pathPolylineVbo.create();
+    pathPolylineVao.bind();
+    pathPolylineVbo.bind();
+    if (!pathPolyline.empty()) {
+        pathPolylineVbo.allocate(pathPolyline.data(), static_cast<int>(pathPolyline.size() * sizeof(float)));
+    } else {
+        pathPolylineVbo.allocate(0);
+    }
+    int posLoc = wireframeProgram->attributeLocation("aPos");
+    wireframeProgram->enableAttributeArray(posLoc);
+    wireframeProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
+    pathPolylineVbo.release();
+    pathPolylineVao.release();
+    
+    GpuMemoryBudget::instance().track(this, "pathPolylineVbo", pathPolylineVbo.size());
+}
+
+// 上传高亮点索引，调用时需要当前上下文
+void ShortestPathGLWidget::uploadHighlightIndices()
+{
+    unsigned int hoverIndex = hoveredVertex >= 0 ? static_cast<unsigned int>(hoveredVertex) : 0;
+    
+    highlightEbo.create();
+    highlightEbo.bind();
+    if (highlightDirty) {
+        std::vector<unsigned int> indices;
+        indices.reserve(1 + selectedVertices.size() + pathVertices.size());
+        indices.push_back(hoverIndex);
+        indices.insert(indices.end(), selectedVertices.begin(), selectedVertices.end());
+        indices.insert(indices.end(), pathVertices.begin(), pathVertices.end());
+        highlightEbo.allocate(indices.data(), indices.size() * sizeof(unsigned int));
+        highlightSelectedCount = static_cast<int>(selectedVertices.size());
+        highlightPathCount = static_cast<int>(pathVertices.size());
+        GpuMemoryBudget::instance().track(this, "highlightEbo", highlightEbo.size());
+    } else {
+        highlightEbo.write(0, &hoverIndex, sizeof(unsigned int));
+    }
+    highlightEbo.release();
+    
+    highlightDirty = false;
+    hoverDirty = false;
 }
 
 void ShortestPathGLWidget::paintGL()
 {
     BaseGLWidget::paintGL();
     
+    if (!modelLoaded || openMesh.n_vertices() == 0) {
+        return;
+    }
+    
+    syncSelectionToGeometry();
+    startLandmarkPreprocessing();
+    if (highlightDirty || hoverDirty) {
+        uploadHighlightIndices();
+    }
+    if (selectionDirty) {
+        uploadSelectionIndices();
+    }
+    if (pathEdgesDirty) {
+        uploadPathEdges();
+    }
+    
+    // 距离场或Voronoi单元覆盖在基类绘制的表面上；几何变化后旧的结果不再显示
+    if (hasDistanceField() && !hideFaces && distanceProgram) {
+        if (distanceFieldDirty || !distanceVbo.isCreated()) {
+            uploadDistanceField();
+        }
+        QMatrix4x4 model, view, projection;
+        model.rotate(rotation);
+        model.scale(zoom);
+        view.lookAt(QVector3D(0, 0, viewDistance * viewScale), modelCenter, QVector3D(0, 1, 0));
+        projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+        renderDistanceField(model, view, projection);
+    }
+    if (hasVoronoi() && !hideFaces && voronoiProgram) {
+        if (voronoiDirty || !voronoiColorBuffer.isCreated()) {
+            uploadVoronoiColors();
+        }
+        QMatrix4x4 model, view, projection;
+        model.rotate(rotation);
+        model.scale(zoom);
+        view.lookAt(QVector3D(0, 0, viewDistance * viewScale), modelCenter, QVector3D(0, 1, 0));
+        projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+        renderVoronoi(model, view, projection);
+    }
+    
+    bool hasHover = hoveredVertex >= 0;
+    bool hasRegion = selectionFaceIndexCount > 0 || selectionVertexIndexCount > 0;
+    
     // 如果有选中的顶点，绘制高亮
-    if (!selectedVertices.empty() || !pathVertices.empty() || !pathEdges.empty()) {
-        glPointSize(10.0f);
-        glEnable(GL_POINT_SMOOTH);
-        
+    if (highlightSelectedCount > 0 || highlightPathCount > 0 || !pathEdges.empty() || hasHover || hasRegion) {
         // 使用简单的着色器绘制高亮点
         QMatrix4x4 model, view, projection;
         
@@ -72,56 +299,69 @@ void ShortestPathGLWidget::paintGL()
         QVector3D eyePosition(0, 0, viewDistance * viewScale);
         view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
         
-        projection.perspective(45.0f, width() / float(height()), 0.1f, 100.0f);
+        projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+        
+        // 套索/笔刷选中的面元和顶点
+        if (hasRegion) {
+            renderRegionSelection(model, view, projection);
+        }
+        
+        glPointSize(10.0f);
+        glEnable(GL_POINT_SMOOTH);
+        
+        wireframeProgram->bind();
+        vao.bind();
+        highlightEbo.bind();
+        
+        wireframeProgram->setUniformValue("model", model);
+        setPositionDequantization(wireframeProgram);
+        wireframeProgram->setUniformValue("view", view);
+        wireframeProgram->setUniformValue("projection", projection);
         
         // 绘制选中的顶点
-        if (!selectedVertices.empty()) {
-            wireframeProgram.bind();
-            vao.bind();
-            
-            wireframeProgram.setUniformValue("model", model);
-            wireframeProgram.setUniformValue("view", view);
-            wireframeProgram.setUniformValue("projection", projection);
-            wireframeProgram.setUniformValue("lineColor", QVector4D(highlightColor, 1.0f));
-            
-            glDrawElements(GL_POINTS, selectedVertices.size(), GL_UNSIGNED_INT, selectedVertices.data());
-            
-            vao.release();
-            wireframeProgram.release();
+        if (highlightSelectedCount > 0) {
+            wireframeProgram->setUniformValue("lineColor", QVector4D(highlightColor, 1.0f));
+            glDrawElements(GL_POINTS, highlightSelectedCount, GL_UNSIGNED_INT,
+                           reinterpret_cast<const void*>(sizeof(unsigned int)));
         }
         
         // 绘制路径顶点（如果有）
-        if (!pathVertices.empty()) {
-            wireframeProgram.bind();
-            vao.bind();
-            
-            wireframeProgram.setUniformValue("model", model);
-            wireframeProgram.setUniformValue("view", view);
-            wireframeProgram.setUniformValue("projection", projection);
-            wireframeProgram.setUniformValue("lineColor", QVector4D(0.0f, 1.0f, 0.0f, 1.0f)); // 绿色路径
-            
-            glDrawElements(GL_POINTS, pathVertices.size(), GL_UNSIGNED_INT, pathVertices.data());
-            
-            vao.release();
-            wireframeProgram.release();
+        if (highlightPathCount > 0) {
+            wireframeProgram->setUniformValue("lineColor", QVector4D(0.0f, 1.0f, 0.0f, 1.0f)); // 绿色路径
+            glDrawElements(GL_POINTS, highlightPathCount, GL_UNSIGNED_INT,
+                           reinterpret_cast<const void*>((1 + size_t(highlightSelectedCount)) * sizeof(unsigned int)));
         }
         
+        // 绘制悬停顶点
+        if (hasHover) {
+            wireframeProgram->setUniformValue("lineColor", QVector4D(hoverColor, 1.0f));
+            glDrawElements(GL_POINTS, 1, GL_UNSIGNED_INT, nullptr);
+        }
+        
+        highlightEbo.release();
+        vao.release();
+        wireframeProgram->release();
+        
         // 绘制路径边（如果有）
-        if (!pathEdges.empty()) {
+        if (!pathEdges.empty() || !pathPolyline.empty()) {
             renderPathEdges();
         }
         
         glDisable(GL_POINT_SMOOTH);
     }
+    
+    // 套索轮廓/笔刷圆圈
+    drawSelectionOverlay();
 }
 
 void ShortestPathGLWidget::mouseDoubleClickEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton && modelLoaded) {
-        int vertexId = pickVertexAtPosition(event->x(), event->y());
-        std::cout << vertexId << std::endl;
-        if (vertexId != -1) {
-            selectedVertices.push_back(vertexId);
+        BvhHit hit = pickSurfaceAtPosition(event->x(), event->y());
+        std::cout << hit.nearestVertex << std::endl;
+        if (hit.valid()) {
+            selectedVertices.push_back(hit.nearestVertex);
+            highlightDirty = true;
             update();
         }
     }
@@ -129,22 +369,171 @@ void ShortestPathGLWidget::mouseDoubleClickEvent(QMouseEvent *event)
     QOpenGLWidget::mouseDoubleClickEvent(event);
 }
 
-int ShortestPathGLWidget::pickVertexAtPosition(int x, int y)
+void ShortestPathGLWidget::mousePressEvent(QMouseEvent *event)
 {
-    makeCurrent();
-    // 保存当前的清除颜色和深度测试状态
-    GLfloat oldClearColor[4];
-    glGetFloatv(GL_COLOR_CLEAR_VALUE, oldClearColor);
+    // 套索/笔刷工具下左键用于选择，不再旋转视图
+    if (selectionTool != PointTool && event->button() == Qt::LeftButton && modelLoaded) {
+        regionSelecting = true;
+        regionDeselect = event->modifiers().testFlag(Qt::ControlModifier);
+        if (selectionTool == LassoTool) {
+            lassoPolygon.clear();
+            lassoPolygon << event->pos();
+        } else {
+            brushPosition = event->pos();
+            selectWithBrush(event->pos(), event->pos());
+        }
+        update();
+        return;
+    }
+    
+    BaseGLWidget::mousePressEvent(event);
+}
+
+void ShortestPathGLWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (regionSelecting && event->button() == Qt::LeftButton) {
+        regionSelecting = false;
+        if (selectionTool == LassoTool) {
+            selectWithLasso();
+            lassoPolygon.clear();
+        }
+        update();
+        return;
+    }
+    
+    BaseGLWidget::mouseReleaseEvent(event);
+}
+
+void ShortestPathGLWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (regionSelecting) {
+        if (selectionTool == LassoTool) {
+            lassoPolygon << event->pos();
+        } else {
+            // 按线段涂抹，快速移动时笔迹也不会断开
+            selectWithBrush(brushPosition, event->pos());
+            brushPosition = event->pos();
+        }
+        update();
+        return;
+    }
+    
+    if (selectionTool == BrushTool) {
+        brushPosition = event->pos();
+        brushVisible = true;
+        update();
+    }
+    
+    BaseGLWidget::mouseMoveEvent(event);
+    if (isDragging || !modelLoaded) return;
+    
+    // 悬停高亮：每次鼠标移动做一次BVH求交，只在最近顶点变化时重绘
+    BvhHit hit = pickSurfaceAtPosition(event->x(), event->y());
+    int vertex = hit.valid() ? hit.nearestVertex : -1;
+    if (vertex != hoveredVertex) {
+        hoveredVertex = vertex;
+        hoverDirty = true;
+        if (hasDistanceField()) {
+            updateFieldTrace();
+        }
+        update();
+    }
+}
+
+void ShortestPathGLWidget::leaveEvent(QEvent *event)
+{
+    if (hoveredVertex >= 0 || brushVisible) {
+        hoveredVertex = -1;
+        hoverDirty = true;
+        brushVisible = false;
+        if (!fieldTrace.empty()) {
+            updateFieldTrace();
+        }
+        update();
+    }
+    BaseGLWidget::leaveEvent(event);
+}
+
+// 网格几何变化后重建BVH
+void ShortestPathGLWidget::ensurePickingBvh()
+{
+    if (pickingBvhVersion == geometryVersion) return;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    pickingBvh.build(openMesh, faces, triangleToFace);
+    pickingBvhVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    qDebug() << "BVH built:" << pickingBvh.triangleCount() << "triangles," << pickingBvh.nodeCount() << "nodes in"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
+}
+
+// 当前相机的MVP矩阵（与paintGL一致）
+QMatrix4x4 ShortestPathGLWidget::modelViewProjection() const
+{
+    QMatrix4x4 model, view, projection;
+    
+    model.rotate(rotation);
+    model.scale(zoom);
+    
+    QVector3D eyePosition(0, 0, viewDistance * viewScale);
+    view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
+    
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+    
+    return projection * view * model;
+}
+
+// 由屏幕坐标构造模型空间中的拾取光线
+BvhRay ShortestPathGLWidget::screenRay(int x, int y) const
+{
+    // 近、远裁剪面上的点反投影回模型空间
+    QMatrix4x4 inverse = modelViewProjection().inverted();
+    float ndcX = (2.0f * x) / width() - 1.0f;
+    float ndcY = 1.0f - (2.0f * y) / height();
+    QVector3D nearPoint = inverse.map(QVector3D(ndcX, ndcY, -1.0f));
+    QVector3D farPoint = inverse.map(QVector3D(ndcX, ndcY, 1.0f));
+    QVector3D direction = farPoint - nearPoint;
+    
+    BvhRay ray;
+    ray.origin = OpenMesh::Vec3f(nearPoint.x(), nearPoint.y(), nearPoint.z());
+    ray.direction = OpenMesh::Vec3f(direction.x(), direction.y(), direction.z());
+    return ray;
+}
+
+BvhHit ShortestPathGLWidget::pickSurfaceAtPosition(int x, int y)
+{
+    BvhHit hit;
+    if (!modelLoaded || faces.empty()) return hit;
+    
+    ensurePickingBvh();
+    pickingBvh.intersect(screenRay(x, y), hit);
+    return hit;
+}
+
+// 渲染ID缓冲：面元pass把gl_PrimitiveID+1写入0号附件，顶点pass把顶点ID+1写入1号附件
+// 同一次渲染同时支持面元和顶点拾取；调用时需要当前上下文
+void ShortestPathGLWidget::renderForPicking()
+{
+    ensureBuffersResident();
+    ensurePickingFBO();
+    QOpenGLExtraFunctions *f = context()->extraFunctions();
+    
+    // 保存深度测试状态
     GLboolean depthTestEnabled;
     glGetBooleanv(GL_DEPTH_TEST, &depthTestEnabled);
-    // 绑定拾取FBO
-    pickingFBO->bind();
-    glViewport(0, 0, width(), height());
     
-    // 使用黑色背景进行清除，并启用深度测试
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-    glEnable(GL_DEPTH_TEST);  // 启用深度测试
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // 绑定拾取FBO，整数附件清零（背景），并启用深度测试
+    glBindFramebuffer(GL_FRAMEBUFFER, pickingFbo);
+    glViewport(0, 0, pickingSize.width(), pickingSize.height());
+    glEnable(GL_DEPTH_TEST);
+    
+    const GLenum allBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    f->glDrawBuffers(2, allBuffers);
+    const GLuint zeroId[4] = {0, 0, 0, 0};
+    f->glClearBufferuiv(GL_COLOR, 0, zeroId);
+    f->glClearBufferuiv(GL_COLOR, 1, zeroId);
+    glClear(GL_DEPTH_BUFFER_BIT);
     
     QMatrix4x4 model, view, projection;
     
@@ -154,74 +543,44 @@ int ShortestPathGLWidget::pickVertexAtPosition(int x, int y)
     QVector3D eyePosition(0, 0, viewDistance * viewScale);
     view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
     
-    projection.perspective(45.0f, width() / float(height()), 0.1f, 100.0f);
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
+    
+    // 首先绘制面元（只写0号附件）
+    const GLenum faceBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_NONE};
+    f->glDrawBuffers(2, faceBuffers);
     
-    // 首先绘制面元（黑色）
-    facePickingProgram.bind();
+    facePickingProgram->bind();
     vao.bind();
     faceEbo.bind();
     
-    facePickingProgram.setUniformValue("model", model);
-    facePickingProgram.setUniformValue("view", view);
-    facePickingProgram.setUniformValue("projection", projection);
+    facePickingProgram->setUniformValue("model", model);
+    setPositionDequantization(facePickingProgram);
+    facePickingProgram->setUniformValue("view", view);
+    facePickingProgram->setUniformValue("projection", projection);
     
     glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
     
     faceEbo.release();
     vao.release();
-    facePickingProgram.release();
+    facePickingProgram->release();
     
-    // 然后绘制顶点（使用ID编码颜色）
-    pickingProgram.bind();
+    // 然后绘制顶点（只写1号附件）
+    const GLenum vertexBuffers[2] = {GL_NONE, GL_COLOR_ATTACHMENT1};
+    f->glDrawBuffers(2, vertexBuffers);
+    
+    pickingProgram->bind();
     vao.bind();
     
-    pickingProgram.setUniformValue("model", model);
-    pickingProgram.setUniformValue("view", view);
-    pickingProgram.setUniformValue("projection", projection);
+    pickingProgram->setUniformValue("model", model);
+    setPositionDequantization(pickingProgram);
+    pickingProgram->setUniformValue("view", view);
+    pickingProgram->setUniformValue("projection", projection);
     
-    // 绘制所有顶点，每个顶点使用其ID作为颜色
+    // 绘制所有顶点，每个顶点写入其ID
     glDrawArrays(GL_POINTS, 0, openMesh.n_vertices());
     
-    // 定义搜索半径
-    const int searchRadius = 10;
-    
-    // 计算搜索区域的边界
-    int startX = std::max(0, x - searchRadius);
-    int startY = std::max(0, y - searchRadius);
-    int endX = std::min(width() - 1, x + searchRadius);
-    int endY = std::min(height() - 1, y + searchRadius);
-    
-    int bestVertexId = -1;
-    float bestDepth = 1.0f; // 初始化为最大深度值
-    
-    // 遍历搜索区域内的所有像素
-    for (int py = startY; py <= endY; ++py) {
-        for (int px = startX; px <= endX; ++px) {
-            // 读取像素颜色
-            GLubyte pixel[4];
-            glReadPixels(px, height() - py - 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
-            
-            // 将颜色转换回顶点ID
-            int vertexId = pixel[0] + (pixel[1] << 8) + (pixel[2] << 16);
-            
-            // 如果读取的ID有效且不超过顶点数量
-            if (vertexId >= 0 && vertexId < static_cast<int>(openMesh.n_vertices())) {
-                // 读取深度值
-                GLfloat depth;
-                glReadPixels(px, height() - py - 1, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
-                
-                // 选择最前面的顶点（深度值最小的）
-                if (depth < bestDepth) {
-                    bestDepth = depth;
-                    bestVertexId = vertexId;
-                }
-            }
-        }
-    }
-    
     vao.release();
-    pickingProgram.release();
-    pickingFBO->release();
+    pickingProgram->release();
     
     // 恢复默认FBO和视口
     glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
@@ -231,12 +590,90 @@ int ShortestPathGLWidget::pickVertexAtPosition(int x, int y)
     if (!depthTestEnabled) {
         glDisable(GL_DEPTH_TEST);
     }
+}
+
+// 把拾取FBO中一个区域的ID（以及可选的深度）经PBO读回，只在映射时同步一次
+// (x, glY)为OpenGL坐标（原点在左下角），结果按行从下到上排列
+bool ShortestPathGLWidget::readPickingRegion(int x, int glY, int w, int h, GLenum attachment,
+                                             std::vector<GLuint>& ids, std::vector<GLfloat>* depths)
+{
+    QOpenGLExtraFunctions *f = context()->extraFunctions();
+    int idBytes = w * h * static_cast<int>(sizeof(GLuint));
+    int depthBytes = depths ? w * h * static_cast<int>(sizeof(GLfloat)) : 0;
     
-    // 恢复清除颜色到BaseGLWidget中设置的值
-    QColor bgColor = this->bgColor; // 从基类获取背景颜色
-    glClearColor(bgColor.redF(), bgColor.greenF(), bgColor.blueF(), bgColor.alphaF());
+    if (!pickPbo.isCreated()) {
+        pickPbo.create();
+        pickPbo.setUsagePattern(QOpenGLBuffer::StreamRead);
+    }
+    pickPbo.bind();
+    if (pickPbo.size() < idBytes + depthBytes) {
+        pickPbo.allocate(idBytes + depthBytes);
+    }
     
-    return bestVertexId;
+    glBindFramebuffer(GL_FRAMEBUFFER, pickingFbo);
+    f->glReadBuffer(attachment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(x, glY, w, h, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    if (depths) {
+        glReadPixels(x, glY, w, h, GL_DEPTH_COMPONENT, GL_FLOAT,
+                     reinterpret_cast<void*>(static_cast<quintptr>(idBytes)));
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+    
+    const char* mapped = static_cast<const char*>(
+        pickPbo.mapRange(0, idBytes + depthBytes, QOpenGLBuffer::RangeRead));
+    bool ok = mapped != nullptr;
+    if (ok) {
+        const GLuint* idData = reinterpret_cast<const GLuint*>(mapped);
+        ids.assign(idData, idData + w * h);
+        if (depths) {
+            const GLfloat* depthData = reinterpret_cast<const GLfloat*>(mapped + idBytes);
+            depths->assign(depthData, depthData + w * h);
+        }
+        pickPbo.unmap();
+    }
+    pickPbo.release();
+    return ok;
+}
+
+// ID缓冲缓存键：相机、视口或几何任一变化时需要重新渲染
+ShortestPathGLWidget::PickingCacheKey ShortestPathGLWidget::currentPickingCacheKey() const
+{
+    PickingCacheKey key;
+    key.rotation = rotation;
+    key.zoom = zoom;
+    key.viewDistance = viewDistance;
+    key.viewScale = viewScale;
+    key.modelCenter = modelCenter;
+    key.size = QSize(width(), height());
+    key.geometryVersion = geometryVersion;
+    return key;
+}
+
+// 按需渲染ID缓冲，并把整幅面元ID、顶点ID和深度读回内存；
+// 视图不变时重复拾取只是查表，不再绑定着色器或重新渲染。只在绘制之外调用（鼠标事件、导出图像）
+bool ShortestPathGLWidget::ensurePickingCache()
+{
+    PickingCacheKey key = currentPickingCacheKey();
+    if (pickingCacheValid && key == pickingCacheKey) return true;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    makeCurrent();
+    renderForPicking();
+    int w = pickingSize.width();
+    int h = pickingSize.height();
+    pickingCacheValid =
+        readPickingRegion(0, 0, w, h, GL_COLOR_ATTACHMENT1, cachedVertexIds, &cachedDepths) &&
+        readPickingRegion(0, 0, w, h, GL_COLOR_ATTACHMENT0, cachedFaceIds, nullptr);
+    doneCurrent();
+    pickingCacheKey = key;
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    qDebug() << "Picking buffer refreshed in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() << "us";
+    
+    return pickingCacheValid;
 }
 
 void ShortestPathGLWidget::clearSelectedPoints()
@@ -244,6 +681,11 @@ void ShortestPathGLWidget::clearSelectedPoints()
     selectedVertices.clear();
     pathVertices.clear();
     pathEdges.clear();
+    pathEdgeIndices.clear();
+    pathPolyline.clear();
+    pathEdgesDirty = true;
+    highlightDirty = true;
+    clearRegionSelection();
     update();
 }
 
@@ -260,16 +702,33 @@ void ShortestPathGLWidget::calculateShortestPath()
 // 新增方法：保存拾取FBO中的图像
 void ShortestPathGLWidget::savePickingImage(const QString& filename)
 {
-    makeCurrent();
-    
-    // 绑定拾取FBO
-    pickingFBO->bind();
+    // 直接使用缓存的ID缓冲，视图未变化时不会重新渲染
+    if (!modelLoaded || !ensurePickingCache()) {
+        qDebug() << "Failed to read picking buffer";
+        return;
+    }
     
-    // 读取FBO中的图像数据
-    QImage image = pickingFBO->toImage();
+    int w = pickingCacheKey.size.width();
+    int h = pickingCacheKey.size.height();
+    const std::vector<GLuint>& faceIds = cachedFaceIds;
+    const std::vector<GLuint>& vertexIds = cachedVertexIds;
     
-    // 释放FBO
-    pickingFBO->release();
+    // ID不能直接显示，按ID散列着色：面元为伪随机颜色，顶点为白色，背景为黑色
+    QImage image(w, h, QImage::Format_RGB32);
+    for (int row = 0; row < h; ++row) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(h - 1 - row));
+        for (int col = 0; col < w; ++col) {
+            int idx = row * w + col;
+            if (vertexIds[idx] != 0) {
+                line[col] = qRgb(255, 255, 255);
+            } else if (faceIds[idx] != 0) {
+                quint32 hash = faceIds[idx] * 2654435761u;
+                line[col] = qRgb(64 + (hash & 0x7F), 64 + ((hash >> 8) & 0x7F), 64 + ((hash >> 16) & 0x7F));
+            } else {
+                line[col] = qRgb(0, 0, 0);
+            }
+        }
+    }
     
     // 保存图像到文件
     if (!image.save(filename)) {
@@ -279,41 +738,126 @@ void ShortestPathGLWidget::savePickingImage(const QString& filename)
     }
 }
 
-// 计算启发式函数（欧几里得距离）
+const MeshGraph& ShortestPathGLWidget::ensurePathGraph()
+{
+    if (pathGraphVersion == geometryVersion) return pathGraph;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    pathGraph.build(openMesh);
+    pathGraphVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    qDebug() << "Path graph built:" << pathGraph.vertexCount() << "vertices," << pathGraph.arcCount() << "arcs in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() << "us";
+    return pathGraph;
+}
+
+void ShortestPathGLWidget::setUseLandmarks(bool enabled)
+{
+    useLandmarks = enabled;
+    if (!enabled) {
+        landmarkTable.clear();
+        landmarkVersion = ~quint64(0);
+        emit landmarksReadyChanged(false);
+    }
+    update();
+}
+
+const GeodesicMesh& ShortestPathGLWidget::ensureGeodesicMesh()
+{
+    if (geodesicMeshVersion == geometryVersion) return geodesicMesh;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    geodesicMesh.build(openMesh.points()->data(), openMesh.n_vertices(), faces);
+    geodesicMeshVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    qDebug() << "Geodesic mesh built:" << geodesicMesh.triangleCount() << "triangles in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() << "us";
+    return geodesicMesh;
+}
+
+// 内蕴网格依赖精确测地线的半边结构（描线时在原网格上展开），两者随几何一起重建
+const FlipGeodesic& ShortestPathGLWidget::ensureFlipGeodesic()
+{
+    const GeodesicMesh& mesh = ensureGeodesicMesh();
+    if (flipGeodesicVersion == geometryVersion) return flipGeodesic;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    bool ok = flipGeodesic.build(mesh);
+    flipGeodesicVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    
+    qDebug() << (ok ? "Intrinsic mesh built in" : "Intrinsic mesh unavailable (non-manifold), tried for")
+             << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
+    return flipGeodesic;
+}
+
+// 在后台线程中构建当前几何的地标表。图在GUI线程中构建后复制一份交给任务，
+// 任务期间GUI线程可以继续修改网格和pathGraph
+void ShortestPathGLWidget::startLandmarkPreprocessing()
+{
+    if (!useLandmarks || !modelLoaded || landmarkJobRunning || landmarkVersion == geometryVersion) {
+        return;
+    }
+    
+    auto graph = std::make_shared<MeshGraph>(ensurePathGraph());
+    const quint64 version = geometryVersion;
+    const int count = landmarkCount;
+    landmarkJobRunning = true;
+    
+    landmarkJob = std::async(std::launch::async, [this, graph, version, count]() {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto table = std::make_shared<LandmarkTable>();
+        table->build(*graph, count);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+        
+        QMetaObject::invokeMethod(this, [this, table, version, ms]() {
+            landmarkJobRunning = false;
+            if (useLandmarks && version == geometryVersion) {
+                landmarkTable = std::move(*table);
+                landmarkVersion = version;
+                qDebug() << "Landmark preprocessing:" << landmarkTable.count() << "landmarks in" << ms << "ms";
+                emit landmarksReadyChanged(true);
+            } else {
+                // 构建期间几何已变化，结果作废
+                startLandmarkPreprocessing();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+// 计算启发式函数（欧几里得距离），读取CSR图中的SoA坐标；
+// 地标表就绪时取与三角不等式下界的较大者，两者都一致，最大值仍一致
 double ShortestPathGLWidget::heuristic(unsigned int from, unsigned int to)
 {
-    OpenMesh::VertexHandle vh_from(from);
-    OpenMesh::VertexHandle vh_to(to);
-    OpenMesh::Vec3d from_pos = openMesh.point(vh_from);
-    OpenMesh::Vec3d to_pos = openMesh.point(vh_to);
-    return (from_pos - to_pos).norm();
+    double bound = pathGraph.distance(from, to);
+    if (landmarkVersion == geometryVersion) {
+        bound = std::max(bound, double(landmarkTable.lowerBound(from, to)));
+    }
+    return bound;
 }
 
 // 新增：A*算法计算最短路径
-std::vector<unsigned int> ShortestPathGLWidget::aStarShortestPath(unsigned int start, unsigned int end)
+std::vector<unsigned int> ShortestPathGLWidget::aStarShortestPath(unsigned int start, unsigned int end, PathSearchContext& ctx)
 {
     auto startTime = std::chrono::high_resolution_clock::now(); // 开始计时
     
     if (start >= openMesh.n_vertices() || end >= openMesh.n_vertices()) {
         return {};
     }
+    const MeshGraph& graph = ensurePathGraph();
     
-    // 初始化距离和前驱数组
-    std::vector<double> g_score(openMesh.n_vertices(), std::numeric_limits<double>::max());
-    std::vector<double> f_score(openMesh.n_vertices(), std::numeric_limits<double>::max());
-    std::vector<int> prev(openMesh.n_vertices(), -1);
-    
-    g_score[start] = 0.0;
-    f_score[start] = heuristic(start, end);
-    
-    // 使用优先队列实现A*算法
-    using VertexScore = std::pair<double, unsigned int>;
-    std::priority_queue<VertexScore, std::vector<VertexScore>, std::greater<VertexScore>> open_set;
-    open_set.push({f_score[start], start});
+    // 复用工作区：g值存为距离，f值存为键值，未访问的顶点视为无穷大
+    SearchWorkspace& ws = ctx.forward;
+    ws.reset(graph.vertexCount());
+    ctx.settled = 0;
+    ws.set(start, 0.0, heuristic(start, end), -1);
+    ws.push(ws.key(start), start);
     
-    while (!open_set.empty()) {
-        auto [current_f, u] = open_set.top();
-        open_set.pop();
+    while (!ws.heapEmpty()) {
+        auto [current_f, u] = ws.pop();
         
         // 如果到达终点，提前退出
         if (u == end) {
@@ -321,183 +865,373 @@ std::vector<unsigned int> ShortestPathGLWidget::aStarShortestPath(unsigned int s
         }
         
         // 如果当前f_score不是最优的，跳过
-        if (current_f > f_score[u]) {
+        if (current_f > ws.key(u)) {
             continue;
         }
+        ++ctx.settled;
         
-        // 遍历所有邻接顶点
-        OpenMesh::VertexHandle vh(u);
-        for (auto vv_it = openMesh.vv_begin(vh); vv_it != openMesh.vv_end(vh); ++vv_it) {
-            unsigned int v = vv_it->idx();
-            
-            // 计算边的权重（欧几里得距离）
-            OpenMesh::Vec3d u_pos = openMesh.point(vh);
-            OpenMesh::Vec3d v_pos = openMesh.point(*vv_it);
-            double weight = (u_pos - v_pos).norm();
+        // 遍历所有邻接顶点，边长已预先存在CSR图中
+        const double g_u = ws.distance(u);
+        for (uint32_t a = graph.begin(u); a < graph.end(u); ++a) {
+            unsigned int v = graph.neighbors[a];
+            double weight = graph.weights[a];
             
             // 计算临时g_score
-            double tentative_g_score = g_score[u] + weight;
+            double tentative_g_score = g_u + weight;
             
             // 如果找到更短的路径
-            if (tentative_g_score < g_score[v]) {
-                prev[v] = u;
-                g_score[v] = tentative_g_score;
-                f_score[v] = g_score[v] + heuristic(v, end);
-                open_set.push({f_score[v], v});
+            if (tentative_g_score < ws.distance(v)) {
+                double f = tentative_g_score + heuristic(v, end);
+                ws.set(v, tentative_g_score, f, u);
+                ws.push(f, v);
             }
         }
     }
     
     // 从终点回溯构建路径
-    std::vector<unsigned int> path;
-    int current = end;
-    while (current != -1) {
-        path.push_back(current);
-        current = prev[current];
-    }
-    std::reverse(path.begin(), path.end());
+    std::vector<unsigned int> path = ws.tracePath(end);
     
     auto endTime = std::chrono::high_resolution_clock::now(); // 结束计时
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    std::cout << "A* algorithm took " << duration.count() << " microseconds" << std::endl;
+    std::ostringstream log;   // 多段并行计算时整行输出，避免各线程的日志交错
+    log << "A* algorithm took " << duration.count() << " microseconds, touched "
+        << ws.touchedCount() << " vertices\n";
+    std::cout << log.str() << std::flush;
     
     return path;
 }
 
-std::vector<unsigned int> ShortestPathGLWidget::dijkstraShortestPath(unsigned int start, unsigned int end)
+std::vector<unsigned int> ShortestPathGLWidget::dijkstraShortestPath(unsigned int start, unsigned int end, PathSearchContext& ctx)
 {
     auto startTime = std::chrono::high_resolution_clock::now(); // 开始计时
     
     if (start >= openMesh.n_vertices() || end >= openMesh.n_vertices()) {
         return {};
     }
+    const MeshGraph& graph = ensurePathGraph();
     
-    // 初始化距离和前驱数组
-    std::vector<double> dist(openMesh.n_vertices(), std::numeric_limits<double>::max());
-    std::vector<int> prev(openMesh.n_vertices(), -1);
-    dist[start] = 0.0;
-    
-    // 使用优先队列实现Dijkstra算法
-    using VertexDist = std::pair<double, unsigned int>;
-    std::priority_queue<VertexDist, std::vector<VertexDist>, std::greater<VertexDist>> pq;
-    pq.push({0.0, start});
-    while (!pq.empty()) {
-        auto [d, u] = pq.top();
-        pq.pop();
+    // 复用工作区，不再为每次查询分配和清零O(n)的数组
+    SearchWorkspace& ws = ctx.forward;
+    ws.reset(graph.vertexCount());
+    ctx.settled = 0;
+    ws.set(start, 0.0, 0.0, -1);
+    ws.push(0.0, start);
+    while (!ws.heapEmpty()) {
+        auto [d, u] = ws.pop();
         
         // 如果已经找到更短的路径，跳过
-        if (d > dist[u]) {
+        if (d > ws.distance(u)) {
             continue;
         }
+        ++ctx.settled;
         
         // 如果到达终点，提前退出
         if (u == end) {
             break;
         }
         
-        // 遍历所有邻接顶点
-        OpenMesh::VertexHandle vh(u);
-        for (auto vv_it = openMesh.vv_begin(vh); vv_it != openMesh.vv_end(vh); ++vv_it) {
-            unsigned int v = vv_it->idx();
-            
-            // 计算边的权重（欧几里得距离）
-            OpenMesh::Vec3d u_pos = openMesh.point(vh);
-            OpenMesh::Vec3d v_pos = openMesh.point(*vv_it);
-            double weight = (u_pos - v_pos).norm();
+        // 遍历所有邻接顶点，边长已预先存在CSR图中
+        for (uint32_t a = graph.begin(u); a < graph.end(u); ++a) {
+            unsigned int v = graph.neighbors[a];
+            double weight = graph.weights[a];
             
             // 松弛操作
-            if (dist[v] > dist[u] + weight) {
-                dist[v] = dist[u] + weight;
-                prev[v] = u;
-                pq.push({dist[v], v});
+            if (ws.distance(v) > d + weight) {
+                ws.set(v, d + weight, d + weight, u);
+                ws.push(d + weight, v);
             }
         }
     }
     // 从终点回溯构建路径
+    std::vector<unsigned int> path = ws.tracePath(end);
+    
+    auto endTime = std::chrono::high_resolution_clock::now(); // 结束计时
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::ostringstream log;
+    log << "Dijkstra algorithm took " << duration.count() << " microseconds, touched "
+        << ws.touchedCount() << " vertices\n";
+    std::cout << log.str() << std::flush;
+    
+    return path;
+}
+
+// 双向搜索：两侧交替扩展堆顶键值较小的一侧，记录经过两侧都到达的顶点的最短s-t距离best，
+// 两个堆顶之和不小于best时停止（此后不可能再找到更短的路径）。
+// 双向A*使用平均势函数 p(v) = (h(v,t) - h(v,s)) / 2，正向键值为g+p，反向为g-p，
+// 两侧的约化边权都非负（一致），停止判据形式与双向Dijkstra相同
+std::vector<unsigned int> ShortestPathGLWidget::bidirectionalShortestPath(unsigned int start, unsigned int end, bool useAStar,
+                                                                        PathSearchContext& ctx)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    if (start >= openMesh.n_vertices() || end >= openMesh.n_vertices()) {
+        return {};
+    }
+    const MeshGraph& graph = ensurePathGraph();
+    
+    auto potential = [&](uint32_t v) {
+        return useAStar ? 0.5 * (heuristic(v, end) - heuristic(v, start)) : 0.0;
+    };
+    
+    SearchWorkspace& forward = ctx.forward;
+    SearchWorkspace& backward = ctx.backward;
+    forward.reset(graph.vertexCount());
+    backward.reset(graph.vertexCount());
+    ctx.settled = 0;
+    
+    forward.set(start, 0.0, potential(start), -1);
+    forward.push(potential(start), start);
+    backward.set(end, 0.0, -potential(end), -1);
+    backward.push(-potential(end), end);
+    
+    double best = start == end ? 0.0 : std::numeric_limits<double>::max();
+    int meet = start == end ? static_cast<int>(start) : -1;
+    
+    while (!forward.heapEmpty() && !backward.heapEmpty()) {
+        if (forward.topKey() + backward.topKey() >= best) {
+            break;
+        }
+        
+        bool isForward = forward.topKey() <= backward.topKey();
+        SearchWorkspace& self = isForward ? forward : backward;
+        const SearchWorkspace& other = isForward ? backward : forward;
+        const double sign = isForward ? 1.0 : -1.0;
+        
+        auto [k, u] = self.pop();
+        if (k > self.key(u)) {
+            continue;
+        }
+        ++ctx.settled;
+        
+        const double du = self.distance(u);
+        for (uint32_t a = graph.begin(u); a < graph.end(u); ++a) {
+            unsigned int v = graph.neighbors[a];
+            double dv = du + graph.weights[a];
+            if (dv >= self.distance(v)) {
+                continue;
+            }
+            
+            double kv = dv + sign * potential(v);
+            self.set(v, dv, kv, u);
+            self.push(kv, v);
+            
+            // 另一侧已到达v：得到一条候选s-t路径
+            if (other.visited(v) && dv + other.distance(v) < best) {
+                best = dv + other.distance(v);
+                meet = v;
+            }
+        }
+    }
+    
+    // 正向从起点到相遇点，反向从相遇点沿反向前驱到终点
     std::vector<unsigned int> path;
-    int current = end;
-    while (current != -1) {
-        path.push_back(current);
-        current = prev[current];
+    if (meet != -1) {
+        path = forward.tracePath(meet);
+        for (int current = backward.parent(meet); current != -1; current = backward.parent(current)) {
+            path.push_back(current);
+        }
     }
-    std::reverse(path.begin(), path.end());
     
-    auto endTime = std::chrono::high_resolution_clock::now(); // 结束计时
+    auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    std::cout << "Dijkstra algorithm took " << duration.count() << " microseconds" << std::endl;
+    std::ostringstream log;
+    log << (useAStar ? "Bidirectional A*" : "Bidirectional Dijkstra") << " took " << duration.count()
+        << " microseconds, settled " << ctx.settled << " vertices\n";
+    std::cout << log.str() << std::flush;
     
     return path;
 }
 
-// 修改calculateAllShortestPaths方法，根据选择的算法计算路径
+// 精确测地线：ICH窗口传播到终点距离确定后停止，回溯得到穿过面内部的折线，转为线段对存入polyline。
+// 返回值只含两个端点（用于高亮），路径不沿网格边
+std::vector<unsigned int> ShortestPathGLWidget::exactGeodesicPath(unsigned int start, unsigned int end,
+                                                                PathSearchContext& ctx, std::vector<float>& polyline)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    polyline.clear();
+    if (start >= openMesh.n_vertices() || end >= openMesh.n_vertices()) {
+        return {};
+    }
+    const GeodesicMesh& mesh = ensureGeodesicMesh();
+    
+    SurfacePoint target = SurfacePoint::atVertex(static_cast<int>(end));
+    ctx.geodesic.propagate(mesh, SurfacePoint::atVertex(static_cast<int>(start)), &target);
+    ctx.settled = static_cast<int>(ctx.geodesic.propagatedWindows());
+    
+    std::vector<double> points = ctx.geodesic.tracePath();
+    for (size_t i = 3; i < points.size(); i += 3) {
+        polyline.insert(polyline.end(), points.begin() + (i - 3), points.begin() + (i + 3));
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::ostringstream log;
+    log << "Exact geodesic took " << duration.count() << " microseconds, length " << ctx.geodesic.targetDistance()
+        << ", propagated " << ctx.settled << " windows (peak " << ctx.geodesic.peakWindows() << " live)\n";
+    std::cout << log.str() << std::flush;
+    
+    if (points.empty()) return {};
+    return { start, end };
+}
+
+// FlipOut：把段中Dijkstra求出的沿边路径在内蕴网格上翻转边，拉直为局部最短测地线，
+// 代价只与路径附近翻转的边数有关。内蕴网格无法构建或拉直失败时保留原来的沿边路径
+void ShortestPathGLWidget::straightenFlipOutSegment(PathSegment& segment)
+{
+    if (segment.vertices.size() < 2 || flipGeodesic.empty()) return;
+    
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<unsigned int> vertices;
+    std::vector<double> points;
+    if (!flipGeodesic.shorten(segment.vertices, vertices, points)) return;
+    
+    segment.polyline.clear();
+    for (size_t i = 3; i < points.size(); i += 3) {
+        segment.polyline.insert(segment.polyline.end(), points.begin() + (i - 3), points.begin() + (i + 3));
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::cout << "FlipOut took " << duration.count() << " microseconds, " << flipGeodesic.lastFlipCount()
+              << " flips, length " << flipGeodesic.lastLength() << " (" << segment.vertices.size()
+              << " edge path vertices -> " << vertices.size() << ")" << std::endl;
+    
+    segment.vertices = std::move(vertices);
+    segment.edges.clear();
+}
+
+// 按当前算法计算一段路径，并查出路径经过的网格边；只读访问网格和路径图，可在工作线程中调用
+void ShortestPathGLWidget::computePathSegment(unsigned int start, unsigned int end, PathSearchContext& ctx,
+                                              PathSegment& segment)
+{
+    std::vector<unsigned int> path;
+    
+    // 根据选择的算法计算路径
+    // FlipOut在这里只求沿边路径，拉直在所有段算完后依次进行
+    if (currentAlgorithm == Dijkstra || currentAlgorithm == FlipOutGeodesic) {
+        path = dijkstraShortestPath(start, end, ctx);
+    } else if (currentAlgorithm == AStar) {
+        path = aStarShortestPath(start, end, ctx);
+    } else if (currentAlgorithm == BidirectionalDijkstra) {
+        path = bidirectionalShortestPath(start, end, false, ctx);
+    } else if (currentAlgorithm == BidirectionalAStar) {
+        path = bidirectionalShortestPath(start, end, true, ctx);
+    } else if (currentAlgorithm == ExactGeodesic) {
+        segment.vertices = exactGeodesicPath(start, end, ctx, segment.polyline);
+        segment.edges.clear();
+        return;
+    }
+    
+    segment.edges.clear();
+    for (size_t j = 0; j + 1 < path.size(); ++j) {
+        // 查找连接这两个顶点的边
+        auto heh = openMesh.find_halfedge(OpenMesh::VertexHandle(path[j]), OpenMesh::VertexHandle(path[j + 1]));
+        segment.edges.push_back(heh.is_valid() ? openMesh.edge_handle(heh).idx() : -1);
+    }
+    segment.vertices = std::move(path);
+}
+
+// 计算所有相邻选中点之间的路径：已缓存的段直接复用，缺失的段分给各线程并行计算，
+// 最后按顺序拼接并一次性上传路径边
 void ShortestPathGLWidget::calculateAllShortestPaths()
 {
     pathVertices.clear();
     pathEdges.clear();
     pathEdgeIndices.clear(); // 清除之前的路径边索引
+    pathPolyline.clear();
+    highlightDirty = true;
 
     if (selectedVertices.size() < 2) {
         return;
     }
 
-    // 计算每对相邻选中点之间的最短路径
-    for (size_t i = 0; i < selectedVertices.size() - 1; ++i) {
-        unsigned int start = selectedVertices[i];
-        unsigned int end = selectedVertices[i + 1];
-        
-        std::vector<unsigned int> path;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    if (pathCacheVersion != geometryVersion) {
+        pathSegmentCache.clear();
+        pathCacheVersion = geometryVersion;
+    }
+    // 在进入工作线程之前构建，之后只读
+    ensurePathGraph();
+    if (currentAlgorithm == ExactGeodesic) {
+        ensureGeodesicMesh();
+    } else if (currentAlgorithm == FlipOutGeodesic) {
+        ensureFlipGeodesic();
+    }
+    
+    // 只保留本次用到的段，取消选择的点对应的段随之释放
+    std::map<PathSegmentKey, PathSegment> segments;
+    std::vector<std::pair<PathSegmentKey, PathSegment*>> missing;
+    for (size_t i = 0; i + 1 < selectedVertices.size(); ++i) {
+        PathSegmentKey key(selectedVertices[i], selectedVertices[i + 1], currentAlgorithm);
+        if (segments.count(key)) continue;
         
-        // 根据选择的算法计算路径
-        if (currentAlgorithm == Dijkstra) {
-            path = dijkstraShortestPath(start, end);
-        } else if (currentAlgorithm == AStar) {
-            path = aStarShortestPath(start, end);
+        auto cached = pathSegmentCache.find(key);
+        if (cached != pathSegmentCache.end()) {
+            segments.emplace(key, std::move(cached->second));
+        } else {
+            missing.emplace_back(key, &segments[key]);
         }
-        
-        if (path.empty()) {
+    }
+    
+    // 每个线程从searchContexts中取一个工作区，parallelForRange的块数不超过线程数
+    if (searchContexts.size() < parallel::threadCount()) {
+        searchContexts.resize(parallel::threadCount());
+    }
+    std::atomic<size_t> nextContext(0);
+    std::atomic<int> settledTotal(0);
+    parallel::parallelForRange(0, missing.size(), [&](size_t b, size_t e) {
+        PathSearchContext& ctx = searchContexts[nextContext++];
+        for (size_t i = b; i < e; ++i) {
+            computePathSegment(std::get<0>(missing[i].first), std::get<1>(missing[i].first), ctx, *missing[i].second);
+            settledTotal += ctx.settled;
+        }
+    }, 1);
+    if (currentAlgorithm == FlipOutGeodesic) {
+        for (auto& item : missing) {
+            straightenFlipOutSegment(*item.second);
+        }
+    }
+    pathSegmentCache = std::move(segments);
+    
+    // 按选中顺序拼接路径顶点和边
+    for (size_t i = 0; i + 1 < selectedVertices.size(); ++i) {
+        const PathSegment& segment = pathSegmentCache.at(
+            PathSegmentKey(selectedVertices[i], selectedVertices[i + 1], currentAlgorithm));
+        if (segment.vertices.empty()) {
             continue;
         }
         
         // 添加路径顶点到总路径中
-        pathVertices.insert(pathVertices.end(), path.begin(), path.end());
+        pathVertices.insert(pathVertices.end(), segment.vertices.begin(), segment.vertices.end());
+        pathPolyline.insert(pathPolyline.end(), segment.polyline.begin(), segment.polyline.end());
         
-        // 添加路径边到总边列表中
-        for (size_t j = 0; j < path.size() - 1; ++j) {
-            unsigned int v0 = path[j];
-            unsigned int v1 = path[j + 1];
-            
-            // 查找连接这两个顶点的边
-            OpenMesh::VertexHandle vh0(v0);
-            OpenMesh::VertexHandle vh1(v1);
-            
-            auto heh = openMesh.find_halfedge(vh0, vh1);
-            if (heh.is_valid()) {
-                OpenMesh::EdgeHandle eh = openMesh.edge_handle(heh);
-                pathEdges.push_back(eh.idx());
-
-                // 将两个顶点索引添加到pathEdgeIndices
-                pathEdgeIndices.push_back(v0);
-                pathEdgeIndices.push_back(v1);
-            }
+        // 添加路径边到总边列表中，两个顶点索引添加到pathEdgeIndices
+        for (size_t j = 0; j < segment.edges.size(); ++j) {
+            if (segment.edges[j] < 0) continue;
+            pathEdges.push_back(segment.edges[j]);
+            pathEdgeIndices.push_back(segment.vertices[j]);
+            pathEdgeIndices.push_back(segment.vertices[j + 1]);
         }
     }
 
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::cout << "Path segments: " << missing.size() << " computed, "
+              << selectedVertices.size() - 1 - missing.size() << " reused" << std::endl;
+    emit pathQueryFinished(settledTotal,
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() / 1000.0);
+
     // 更新EBO
     makeCurrent();
-    pathEdgeEbo.bind();
-    if (!pathEdgeIndices.empty()) {
-        pathEdgeEbo.allocate(pathEdgeIndices.data(), pathEdgeIndices.size() * sizeof(unsigned int));
-    } else {
-        pathEdgeEbo.allocate(0);
-    }
-    pathEdgeEbo.release();
+    uploadPathEdges();
     doneCurrent();
 }
 
 // 修改renderPathEdges方法，使用正确的索引数量
 void ShortestPathGLWidget::renderPathEdges()
 {
-    if (pathEdgeIndices.empty()) {
+    if (pathEdgeIndices.empty() && pathPolyline.empty()) {
         return;
     }
     
@@ -509,27 +1243,37 @@ void ShortestPathGLWidget::renderPathEdges()
     QVector3D eyePosition(0, 0, viewDistance * viewScale);
     view.lookAt(eyePosition, modelCenter, QVector3D(0, 1, 0));
     
-    projection.perspective(45.0f, width() / float(height()), 0.1f, 100.0f);
+    projection.perspective(FieldOfView, width() / float(height()), NearPlane, FarPlane);
     
     // 设置线宽
     glLineWidth(5.0f);
     glEnable(GL_LINE_SMOOTH);
     
-    wireframeProgram.bind();
+    wireframeProgram->bind();
     vao.bind();
     pathEdgeEbo.bind(); // 绑定路径边的EBO
     
-    wireframeProgram.setUniformValue("model", model);
-    wireframeProgram.setUniformValue("view", view);
-    wireframeProgram.setUniformValue("projection", projection);
-    wireframeProgram.setUniformValue("lineColor", QVector4D(0.0f, 1.0f, 0.0f, 1.0f)); // 绿色路径
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+    wireframeProgram->setUniformValue("lineColor", QVector4D(0.0f, 1.0f, 0.0f, 1.0f)); // 绿色路径
     
     // 使用正确的索引数量
     glDrawElements(GL_LINES, pathEdgeIndices.size(), GL_UNSIGNED_INT, 0);
     
     pathEdgeEbo.release();
     vao.release();
-    wireframeProgram.release();
+    
+    // 精确测地线的折线已是模型空间坐标，不需要反量化
+    if (!pathPolyline.empty()) {
+        pathPolylineVao.bind();
+        wireframeProgram->setUniformValue("posOffset", QVector3D(0.0f, 0.0f, 0.0f));
+        wireframeProgram->setUniformValue("posScale", QVector3D(1.0f, 1.0f, 1.0f));
+        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(pathPolyline.size() / 3));
+        pathPolylineVao.release();
+    }
+    wireframeProgram->release();
     
     glDisable(GL_LINE_SMOOTH);
 }
\ No newline at end of file
@@ -3,13 +3,27 @@
 #define SHORTESTPATHGLWIDGET_H
 
 #include "baseglwidget.h"
+#include "../meshutils/mesh_bvh.h"
+#include "../meshutils/mesh_graph.h"
+#include "../meshutils/landmarks.h"
+#include "../meshutils/exact_geodesic.h"
+#include "../meshutils/heat_geodesic.h"
+#include "../meshutils/fast_marching.h"
+#include "../meshutils/flip_geodesic.h"
+#include "../meshutils/geodesic_sampling.h"
+#include "../meshutils/search_workspace.h"
 #include <OpenMesh/Core/Utils/PropertyManager.hh>
-#include <QOpenGLFramebufferObject>
 #include <QOpenGLShaderProgram>
+#include <QBitArray>
+#include <QPolygon>
+#include <QImage>
 #include <vector>
 #include <queue>
 #include <functional>
 #include <limits>
+#include <future>
+#include <map>
+#include <tuple>
 
 class ShortestPathGLWidget : public BaseGLWidget
 {
@@ -18,15 +32,43 @@ class ShortestPathGLWidget : public BaseGLWidget
 public:
     enum Algorithm {
         Dijkstra,
-        AStar
+        AStar,
+        BidirectionalDijkstra,
+        BidirectionalAStar,
+        ExactGeodesic,     // 精确测地线（ICH窗口传播），路径可穿过面内部
+        FlipOutGeodesic    // Dijkstra路径经内蕴边翻转拉直为局部最短测地线（FlipOut）
+    };
+    
+    // 左键的选择工具：双击选点（默认）、套索、笔刷
+    enum SelectionTool {
+        PointTool,
+        LassoTool,
+        BrushTool
+    };
+    
+    // 距离场的计算方法
+    enum DistanceMethod {
+        HeatMethod,        // 预分解的热方法，每次查询两次回代
+        FastMarchingMethod // 快速行进法，不需要分解，可按距离阈值提前停止
+    };
+    
+    // 套索/笔刷作用的对象
+    enum SelectionTarget {
+        SelectVertices,
+        SelectFaces
     };
 
     explicit ShortestPathGLWidget(QWidget *parent = nullptr);
     ~ShortestPathGLWidget();
 
     void initializeGL() override;
+    void resizeGL(int w, int h) override;
     void paintGL() override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
 
     void clearSelectedPoints();
     void calculateShortestPath(); // 计算最短路径
@@ -37,37 +79,249 @@ public:
     
     // 设置算法
     void setAlgorithm(Algorithm algo) { currentAlgorithm = algo; }
+    
+    // ALT预处理：开启后模型加载（或几何变化）后在后台计算地标距离表，
+    // 就绪前A*仍使用欧氏距离启发式
+    void setUseLandmarks(bool enabled);
+    bool landmarksReady() const { return landmarkVersion == geometryVersion && !landmarkTable.empty(); }
+    
+    // 距离场：以选中点和区域选中的顶点为源点，用曲率色图显示，结果同时写入顶点属性v:geodesic_distance。
+    // 热方法的矩阵分解按几何缓存，之后每次计算只需两次回代；
+    // 快速行进法的limit为包围盒对角线的比例，超出的区域不再推进（>=1不限制）。
+    // 显示距离场时鼠标悬停处沿梯度下降回溯到最近源点
+    void computeDistanceField();
+    void clearDistanceField();
+    void setDistanceMethod(DistanceMethod method) { distanceMethod = method; }
+    void setDistanceLimit(double fraction) { distanceLimit = fraction; }
+    bool hasDistanceField() const { return distanceFieldVersion == geometryVersion && !distanceField.empty(); }
+    
+    // 测地Voronoi：在网格边图上做最远点采样，每个三角形按所属单元着色，单元编号写入面属性f:voronoi_cell。
+    // 与距离场共用表面覆盖层，计算其中一个时清除另一个
+    void computeVoronoi(int sampleCount);
+    void clearVoronoi();
+    bool hasVoronoi() const { return voronoiVersion == geometryVersion && !voronoiTriangleCells.empty(); }
+    
+    // 区域选择（套索/笔刷），按住Ctrl拖动时从选择中移除
+    void setSelectionTool(SelectionTool tool);
+    void setSelectionTarget(SelectionTarget target) { selectionTarget = target; }
+    void setBrushRadius(int radius) { brushRadius = radius; update(); }
+    void clearRegionSelection();
+    int regionSelectedVertexCount() const { return regionVertexSelection.count(true); }
+    int regionSelectedFaceCount() const { return regionFaceSelection.count(true); }
+
+signals:
+    void regionSelectionChanged(int vertexCount, int faceCount);
+    // 一次路径计算（所有相邻选中点对）共确定的顶点数和耗时
+    void pathQueryFinished(int settledVertices, double milliseconds);
+    void landmarksReadyChanged(bool ready);
+    void distanceFieldComputed(int sourceCount, double milliseconds);
+    void voronoiComputed(int sampleCount, double milliseconds);
 
 protected:
     void initializePickingShaders();
+    void ensurePickingFBO();
+    void destroyPickingFBO();
     void renderForPicking();
-    int pickVertexAtPosition(int x, int y);
+    bool readPickingRegion(int x, int glY, int w, int h, GLenum attachment,
+                           std::vector<GLuint>& ids, std::vector<GLfloat>* depths);
+    bool ensurePickingCache();
+    
+    // CPU BVH拾取：不需要额外渲染和GL上下文，可用于鼠标悬停
+    void ensurePickingBvh();
+    QMatrix4x4 modelViewProjection() const;
+    BvhRay screenRay(int x, int y) const;
+    BvhHit pickSurfaceAtPosition(int x, int y);
 
 private:
-    QOpenGLShaderProgram pickingProgram;
-    QOpenGLShaderProgram facePickingProgram;
-    QOpenGLFramebufferObject *pickingFBO;
+    QOpenGLShaderProgram *pickingProgram = nullptr;
+    QOpenGLShaderProgram *facePickingProgram = nullptr;
+    // 拾取FBO：两个R32UI附件（面元ID、顶点ID）+ 深度缓冲
+    GLuint pickingFbo = 0;
+    GLuint pickingFaceTex = 0;
+    GLuint pickingVertexTex = 0;
+    GLuint pickingDepthRbo = 0;
+    QSize pickingSize;
+    QOpenGLBuffer pickPbo; // 拾取窗口的像素回读缓冲（ID+深度）
+    
+    // 读回内存的ID缓冲缓存，相机/视口/几何不变时重复使用
+    struct PickingCacheKey {
+        QQuaternion rotation;
+        float zoom = 0.0f;
+        float viewDistance = 0.0f;
+        float viewScale = 0.0f;
+        QVector3D modelCenter;
+        QSize size;
+        quint64 geometryVersion = 0;
+        
+        bool operator==(const PickingCacheKey& other) const {
+            return rotation == other.rotation && zoom == other.zoom &&
+                   viewDistance == other.viewDistance && viewScale == other.viewScale &&
+                   modelCenter == other.modelCenter && size == other.size &&
+                   geometryVersion == other.geometryVersion;
+        }
+    };
+    PickingCacheKey currentPickingCacheKey() const;
+    bool pickingCacheValid = false;
+    PickingCacheKey pickingCacheKey;
+    std::vector<GLuint> cachedFaceIds;
+    std::vector<GLuint> cachedVertexIds;
+    std::vector<GLfloat> cachedDepths;
+    MeshBVH pickingBvh;
+    quint64 pickingBvhVersion = ~quint64(0);   // 构建BVH时的geometryVersion
+    int hoveredVertex = -1;                    // 鼠标悬停处最近的顶点
     std::vector<unsigned int> pathEdgeIndices; // 存储路径边的顶点索引
     QOpenGLBuffer pathEdgeEbo; // 专门用于路径边的EBO
+    // 精确测地线的折线：模型空间坐标的线段对，独立的VAO/VBO
+    std::vector<float> pathPolyline;
+    QOpenGLVertexArrayObject pathPolylineVao;
+    QOpenGLBuffer pathPolylineVbo;
+    bool pathEdgesDirty = false;               // 路径被清除后需重新上传（paintGL中有当前上下文）
+    
+    // 高亮点索引缓冲：[悬停顶点][选中顶点][路径顶点]，替代每帧发送客户端索引指针
+    QOpenGLBuffer highlightEbo;
+    int highlightSelectedCount = 0;
+    int highlightPathCount = 0;
+    bool highlightDirty = true;   // 选中点或路径变化，整体重新上传
+    bool hoverDirty = true;       // 只有悬停顶点变化，只更新第一个槽
+    void uploadHighlightIndices();
+    
+    // 区域选择：位集存储，选中面元的三角形和选中顶点写入专用索引缓冲
+    SelectionTool selectionTool = PointTool;
+    SelectionTarget selectionTarget = SelectVertices;
+    int brushRadius = 20;
+    bool regionSelecting = false;
+    bool regionDeselect = false;
+    QPolygon lassoPolygon;
+    QPoint brushPosition;
+    bool brushVisible = false;
+    QBitArray regionVertexSelection;
+    QBitArray regionFaceSelection;
+    quint64 selectionGeometryVersion = ~quint64(0);
+    QOpenGLBuffer selectionEbo;
+    int selectionFaceIndexCount = 0;
+    int selectionVertexIndexCount = 0;
+    bool selectionDirty = true;
+    
+    void syncSelectionToGeometry();
+    void selectWithLasso();
+    void selectWithBrush(const QPoint& from, const QPoint& to);
+    void applySelectionMask(const QImage& mask, const QRect& rect);
+    void uploadSelectionIndices();
+    void renderRegionSelection(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
+    void drawSelectionOverlay();
     
     std::vector<unsigned int> selectedVertices;
     std::vector<unsigned int> pathVertices;
     std::vector<unsigned int> pathEdges; // 新增：存储路径边的索引
     
     QVector3D highlightColor = QVector3D(1.0f, 0.0f, 0.0f); // 高亮颜色（红色）
+    QVector3D hoverColor = QVector3D(1.0f, 1.0f, 0.0f);     // 悬停颜色（黄色）
     
     Algorithm currentAlgorithm = Dijkstra; // 当前选择的算法
     
+    // 路径算法共用的CSR邻接图，几何变化后重建
+    MeshGraph pathGraph;
+    quint64 pathGraphVersion = ~quint64(0);
+    const MeshGraph& ensurePathGraph();
+    // 一次搜索使用的工作区，查询之间复用距离/前驱数组和堆；
+    // 多段路径并行计算时每个线程占用一个
+    struct PathSearchContext {
+        SearchWorkspace forward;
+        SearchWorkspace backward;   // 双向搜索的反向一侧
+        GeodesicPropagation geodesic;
+        int settled = 0;            // 最近一次查询出堆确定的顶点数（精确测地线为传播的窗口数）
+    };
+    std::vector<PathSearchContext> searchContexts;
+    
+    // 相邻选中点之间的路径段缓存，键为(起点, 终点, 算法)，几何变化时整体作废。
+    // 追加一个选中点时只需计算新的一段
+    struct PathSegment {
+        std::vector<unsigned int> vertices;
+        std::vector<int> edges;
+        std::vector<float> polyline;   // 精确测地线穿过面内部的折线（xyz），此时不经过网格边
+    };
+    typedef std::tuple<unsigned int, unsigned int, int> PathSegmentKey;
+    std::map<PathSegmentKey, PathSegment> pathSegmentCache;
+    quint64 pathCacheVersion = ~quint64(0);
+    void computePathSegment(unsigned int start, unsigned int end, PathSearchContext& ctx, PathSegment& segment);
+    
+    // 精确测地线使用的半边结构，由三角化后的索引构建，几何变化后重建
+    GeodesicMesh geodesicMesh;
+    quint64 geodesicMeshVersion = ~quint64(0);
+    const GeodesicMesh& ensureGeodesicMesh();
+    std::vector<unsigned int> exactGeodesicPath(unsigned int start, unsigned int end, PathSearchContext& ctx,
+                                                std::vector<float>& polyline);
+    
+    // FlipOut使用的内蕴网格，在GUI线程中构建。每次拉直后翻转都会恢复，
+    // 因此只保留一份，各段的Dijkstra并行求出后在它上面依次拉直
+    FlipGeodesic flipGeodesic;
+    quint64 flipGeodesicVersion = ~quint64(0);
+    const FlipGeodesic& ensureFlipGeodesic();
+    void straightenFlipOutSegment(PathSegment& segment);
+    
+    // 地标距离表在工作线程中基于图的副本构建，完成后排队回到GUI线程替换；
+    // 同一时间只有一个任务，任务期间几何变化时结果作废并重新开始
+    bool useLandmarks = true;
+    int landmarkCount = 16;
+    LandmarkTable landmarkTable;
+    quint64 landmarkVersion = ~quint64(0);
+    std::future<void> landmarkJob;
+    bool landmarkJobRunning = false;
+    void startLandmarkPreprocessing();
+    
+    // 距离场（热方法/快速行进法），显示时复用曲率着色器，距离存放在独立的16位顶点缓冲中
+    HeatGeodesic heatGeodesic;
+    quint64 heatGeodesicVersion = ~quint64(0);
+    const HeatGeodesic& ensureHeatGeodesic();
+    FastMarching fastMarching;
+    quint64 fastMarchingVersion = ~quint64(0);
+    const FastMarching& ensureFastMarching();
+    DistanceMethod distanceMethod = HeatMethod;
+    double distanceLimit = 1.0;
+    std::vector<double> distanceField;
+    quint64 distanceFieldVersion = ~quint64(0);
+    bool distanceFieldDirty = true;
+    OpenMesh::VPropHandleT<double> distanceProp;
+    QOpenGLShaderProgram *distanceProgram = nullptr;
+    QOpenGLBuffer distanceVbo;
+    void uploadDistanceField();
+    void renderDistanceField(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
+    // 悬停顶点沿距离场梯度下降到源点的折线（模型空间线段对）
+    std::vector<float> fieldTrace;
+    bool fieldTraceDirty = false;
+    QOpenGLVertexArrayObject fieldTraceVao;
+    QOpenGLBuffer fieldTraceVbo;
+    void updateFieldTrace();
+    void uploadFieldTrace();
+    // 测地Voronoi的三角形单元，颜色（RGBA8）按gl_PrimitiveID从着色器存储缓冲中读取
+    std::vector<int> voronoiTriangleCells;
+    quint64 voronoiVersion = ~quint64(0);
+    bool voronoiDirty = true;
+    OpenMesh::FPropHandleT<int> voronoiProp;
+    QOpenGLShaderProgram *voronoiProgram = nullptr;
+    QOpenGLBuffer voronoiColorBuffer;
+    void uploadVoronoiColors();
+    void renderVoronoi(const QMatrix4x4& model, const QMatrix4x4& view, const QMatrix4x4& projection);
+    
     // 新增：手动实现的Dijkstra算法计算最短路径
-    std::vector<unsigned int> dijkstraShortestPath(unsigned int start, unsigned int end);
+    std::vector<unsigned int> dijkstraShortestPath(unsigned int start, unsigned int end, PathSearchContext& ctx);
     
     // 新增：A*算法计算最短路径
-    std::vector<unsigned int> aStarShortestPath(unsigned int start, unsigned int end);
+    std::vector<unsigned int> aStarShortestPath(unsigned int start, unsigned int end, PathSearchContext& ctx);
+    
+    // 双向Dijkstra；useAStar时使用平均势函数的双向A*
+    std::vector<unsigned int> bidirectionalShortestPath(unsigned int start, unsigned int end, bool useAStar,
+                                                        PathSearchContext& ctx);
     
     // 新增：绘制路径边
     void renderPathEdges();
+    void uploadPathEdges();
+    
+    // 显存预算回收/恢复
+    void updateBuffersFromOpenMesh() override;
+    void releaseGpuBuffers() override;
     
-    // 计算启发式函数（欧几里得距离）
+    // 计算启发式函数：欧几里得距离，地标表就绪时取与ALT下界的较大者
     double heuristic(unsigned int from, unsigned int to);
 };
 
@@ -0,0 +1,334 @@
+// shortestpathglwidget_distance.cpp
+// 距离场：从选中点（含套索/笔刷选中的顶点）出发的多源测地距离，热方法或快速行进法；
+// 测地Voronoi：最远点采样得到的样本把表面划分为单元
+#include "shortestpathglwidget.h"
+#include "../meshutils/parallel_utils.h"
+#include <QColor>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+// 距离写入aCurvature的第一个通道，着色器按高斯曲率模式读取该通道
+static const int DistanceFieldChannel = BaseGLWidget::GaussianCurvature;
+
+// Laplacian和质量矩阵的分解只依赖几何，几何变化后在下一次查询时重新构建
+const HeatGeodesic& ShortestPathGLWidget::ensureHeatGeodesic()
+{
+    if (heatGeodesicVersion == geometryVersion) return heatGeodesic;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    heatGeodesic.build(openMesh.points()->data(), openMesh.n_vertices(), faces);
+    heatGeodesicVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    qDebug() << "Heat method factorized:" << heatGeodesic.vertexCount() << "vertices, t =" << heatGeodesic.timeStep()
+             << "in" << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() << "ms";
+    return heatGeodesic;
+}
+
+// 快速行进法引用精确测地线共用的半边结构，两者随几何一起重建
+const FastMarching& ShortestPathGLWidget::ensureFastMarching()
+{
+    const GeodesicMesh& mesh = ensureGeodesicMesh();
+    if (fastMarchingVersion == geometryVersion) return fastMarching;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    fastMarching.build(mesh);
+    fastMarchingVersion = geometryVersion;
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    qDebug() << "Fast marching prepared:" << fastMarching.obtuseCornerCount() << "obtuse corners unfolded in"
+             << std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count() << "us";
+    return fastMarching;
+}
+
+void ShortestPathGLWidget::computeDistanceField()
+{
+    if (!modelLoaded || openMesh.n_vertices() == 0) return;
+    syncSelectionToGeometry();
+
+    std::vector<unsigned int> sources(selectedVertices);
+    for (int v = 0; v < regionVertexSelection.size(); ++v) {
+        if (regionVertexSelection.testBit(v)) {
+            sources.push_back(static_cast<unsigned int>(v));
+        }
+    }
+    if (sources.empty()) {
+        qDebug() << "Distance field: no source vertices selected";
+        return;
+    }
+
+    bool ok = false;
+    double ms = 0.0;
+    if (distanceMethod == HeatMethod) {
+        const HeatGeodesic& heat = ensureHeatGeodesic();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        ok = heat.compute(sources, distanceField);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        qDebug() << "Heat distance field:" << sources.size() << "sources in" << ms << "ms";
+    } else {
+        ensureFastMarching();
+        double limit = std::numeric_limits<double>::infinity();
+        if (distanceLimit < 1.0) {
+            Mesh::Point min, max;
+            computeBoundingBox(min, max);
+            limit = distanceLimit * (max - min).norm();
+        }
+        auto startTime = std::chrono::high_resolution_clock::now();
+        fastMarching.propagate(sources, limit);
+        distanceField = fastMarching.distances();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        ok = !fastMarching.empty();
+        ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        qDebug() << "Fast marching distance field:" << sources.size() << "sources," << fastMarching.acceptedCount()
+                 << "vertices accepted in" << ms << "ms";
+    }
+    if (!ok) {
+        qDebug() << "Distance field: unavailable for this mesh";
+        return;
+    }
+
+    // 写入顶点属性，供等值线、Voronoi划分等后续处理读取
+    if (!openMesh.get_property_handle(distanceProp, "v:geodesic_distance")) {
+        openMesh.add_property(distanceProp, "v:geodesic_distance");
+    }
+    parallel::parallelFor(0, distanceField.size(), [&](size_t i) {
+        openMesh.property(distanceProp, Mesh::VertexHandle(static_cast<int>(i))) = distanceField[i];
+    });
+
+    voronoiTriangleCells.clear();
+    distanceFieldVersion = geometryVersion;
+    distanceFieldDirty = true;
+    updateFieldTrace();
+    emit distanceFieldComputed(static_cast<int>(sources.size()), ms);
+    update();
+}
+
+void ShortestPathGLWidget::clearDistanceField()
+{
+    distanceField.clear();
+    distanceFieldVersion = ~quint64(0);
+    distanceFieldDirty = true;
+    updateFieldTrace();
+    update();
+}
+
+void ShortestPathGLWidget::computeVoronoi(int sampleCount)
+{
+    if (!modelLoaded || openMesh.n_vertices() == 0 || faces.empty() || sampleCount <= 0) return;
+    const MeshGraph& graph = ensurePathGraph();
+
+    // 每加入一个样本只重新松弛它的Voronoi单元，上千个样本也只比几次完整Dijkstra略慢
+    auto startTime = std::chrono::high_resolution_clock::now();
+    FarthestPointSampler sampler;
+    sampler.reset(graph);
+    sampler.sample(static_cast<size_t>(sampleCount), 0);
+    assignTriangleCells(sampler.cells(), faces, voronoiTriangleCells);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    qDebug() << "Geodesic Voronoi:" << sampler.samples().size() << "samples, coverage radius"
+             << sampler.coverageRadius() << "in" << ms << "ms";
+
+    // 多边形面拆成的三角形连续存放，取面的第一个三角形的单元
+    if (!openMesh.get_property_handle(voronoiProp, "f:voronoi_cell")) {
+        openMesh.add_property(voronoiProp, "f:voronoi_cell");
+    }
+    parallel::parallelFor(0, voronoiTriangleCells.size(), [&](size_t t) {
+        if (t > 0 && triangleToFace[t - 1] == triangleToFace[t]) return;
+        openMesh.property(voronoiProp, Mesh::FaceHandle(triangleToFace[t])) = voronoiTriangleCells[t];
+    });
+
+    distanceField.clear();
+    updateFieldTrace();
+    voronoiVersion = geometryVersion;
+    voronoiDirty = true;
+    emit voronoiComputed(static_cast<int>(sampler.samples().size()), ms);
+    update();
+}
+
+void ShortestPathGLWidget::clearVoronoi()
+{
+    voronoiTriangleCells.clear();
+    voronoiVersion = ~quint64(0);
+    voronoiDirty = true;
+    update();
+}
+
+// 悬停顶点变化或距离场更新后重新回溯，代价只与路径经过的三角形数成正比
+void ShortestPathGLWidget::updateFieldTrace()
+{
+    fieldTrace.clear();
+    fieldTraceDirty = true;
+    if (!hasDistanceField() || hoveredVertex < 0) return;
+
+    std::vector<double> path = traceGradientDescent(ensureGeodesicMesh(), distanceField,
+                                                    static_cast<uint32_t>(hoveredVertex));
+    for (size_t i = 3; i < path.size(); i += 3) {
+        fieldTrace.insert(fieldTrace.end(), path.begin() + i - 3, path.begin() + i + 3);
+    }
+}
+
+void ShortestPathGLWidget::uploadFieldTrace()
+{
+    if (!fieldTraceVao.isCreated()) {
+        fieldTraceVao.create();
+    }
+    fieldTraceVbo.create();
+    fieldTraceVao.bind();
+    fieldTraceVbo.bind();
+    if (!fieldTrace.empty()) {
+        fieldTraceVbo.allocate(fieldTrace.data(), static_cast<int>(fieldTrace.size() * sizeof(float)));
+    } else {
+        fieldTraceVbo.allocate(0);
+    }
+    int posLoc = wireframeProgram->attributeLocation("aPos");
+    wireframeProgram->enableAttributeArray(posLoc);
+    wireframeProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
+    fieldTraceVbo.release();
+    fieldTraceVao.release();
+    fieldTraceDirty = false;
+
+    GpuMemoryBudget::instance().track(this, "fieldTraceVbo", fieldTraceVbo.size());
+}
+
+// 按最大有限距离归一化为16位通道并上传，不可达的顶点取最大值；调用时需要当前上下文
+void ShortestPathGLWidget::uploadDistanceField()
+{
+    const size_t vertexCount = distanceField.size();
+    double maxDistance = 0.0;
+    for (double d : distanceField) {
+        if (std::isfinite(d)) maxDistance = std::max(maxDistance, d);
+    }
+    const double scale = maxDistance > 0.0 ? 1.0 / maxDistance : 0.0;
+
+    std::vector<uint16_t> channel(vertexCount);
+    parallel::parallelFor(0, vertexCount, [&](size_t i) {
+        double value = std::isfinite(distanceField[i]) ? std::min(1.0, distanceField[i] * scale) : 1.0;
+        channel[i] = static_cast<uint16_t>(std::lround(value * 65535.0));
+    });
+
+    distanceVbo.create();
+    distanceVbo.bind();
+    distanceVbo.allocate(channel.data(), static_cast<int>(channel.size() * sizeof(uint16_t)));
+    distanceVbo.release();
+    distanceFieldDirty = false;
+
+    GpuMemoryBudget::instance().track(this, "distanceVbo", distanceVbo.size());
+}
+
+// 用曲率着色器的颜色映射覆盖在已绘制的表面上（相同几何，深度相等时通过）。
+// 距离属性只在这次绘制中启用，共享的VAO里不保留指向距离缓冲的状态
+void ShortestPathGLWidget::renderDistanceField(const QMatrix4x4& model, const QMatrix4x4& view,
+                                               const QMatrix4x4& projection)
+{
+    distanceProgram->bind();
+    vao.bind();
+    faceEbo.bind();
+    distanceVbo.bind();
+
+    int distanceLoc = distanceProgram->attributeLocation("aCurvature");
+    if (distanceLoc != -1) {
+        distanceProgram->enableAttributeArray(distanceLoc);
+        distanceProgram->setAttributeBuffer(distanceLoc, GL_UNSIGNED_SHORT, 0, 1, sizeof(uint16_t));
+    }
+
+    distanceProgram->setUniformValue("model", model);
+    setPositionDequantization(distanceProgram);
+    distanceProgram->setUniformValue("view", view);
+    distanceProgram->setUniformValue("projection", projection);
+    distanceProgram->setUniformValue("normalMatrix", model.normalMatrix());
+    distanceProgram->setUniformValue("curvatureType", DistanceFieldChannel);
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDepthFunc(GL_LEQUAL);
+    glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
+    glDepthFunc(GL_LESS);
+
+    if (distanceLoc != -1) {
+        distanceProgram->disableAttributeArray(distanceLoc);
+    }
+    distanceVbo.release();
+    faceEbo.release();
+    vao.release();
+    distanceProgram->release();
+
+    // 覆盖绘制会盖住基类画的线框，重新叠加一次
+    if (showWireframeOverlay) {
+        drawWireframeOverlay(model, view, projection);
+    }
+
+    // 梯度下降回溯的折线已是模型空间坐标，不需要反量化
+    if (fieldTraceDirty) {
+        uploadFieldTrace();
+    }
+    if (!fieldTrace.empty()) {
+        wireframeProgram->bind();
+        fieldTraceVao.bind();
+        wireframeProgram->setUniformValue("model", model);
+        wireframeProgram->setUniformValue("view", view);
+        wireframeProgram->setUniformValue("projection", projection);
+        wireframeProgram->setUniformValue("posOffset", QVector3D(0.0f, 0.0f, 0.0f));
+        wireframeProgram->setUniformValue("posScale", QVector3D(1.0f, 1.0f, 1.0f));
+        wireframeProgram->setUniformValue("lineColor", QVector4D(1.0f, 1.0f, 1.0f, 1.0f));
+        glLineWidth(3.0f);
+        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(fieldTrace.size() / 3));
+        glLineWidth(1.0f);
+        fieldTraceVao.release();
+        wireframeProgram->release();
+    }
+}
+
+// 每个三角形一个RGBA8颜色：色相按黄金分割角递增，相邻编号的单元颜色差别明显；不可达的三角形为灰色
+void ShortestPathGLWidget::uploadVoronoiColors()
+{
+    std::vector<uint32_t> colors(voronoiTriangleCells.size());
+    parallel::parallelFor(0, colors.size(), [&](size_t t) {
+        const int cell = voronoiTriangleCells[t];
+        QColor color = cell < 0 ? QColor(128, 128, 128)
+                                : QColor::fromHsvF(std::fmod(cell * 0.618033988749895, 1.0), 0.55, 0.95);
+        colors[t] = static_cast<uint32_t>(color.red()) | (static_cast<uint32_t>(color.green()) << 8) |
+                    (static_cast<uint32_t>(color.blue()) << 16) | (0xffu << 24);
+    });
+
+    voronoiColorBuffer.create();
+    voronoiColorBuffer.bind();
+    voronoiColorBuffer.allocate(colors.data(), static_cast<int>(colors.size() * sizeof(uint32_t)));
+    voronoiColorBuffer.release();
+    voronoiDirty = false;
+
+    GpuMemoryBudget::instance().track(this, "voronoiColorBuffer", voronoiColorBuffer.size());
+}
+
+// 与距离场相同的覆盖方式；颜色缓冲绑定为着色器存储缓冲，片元着色器按gl_PrimitiveID索引
+void ShortestPathGLWidget::renderVoronoi(const QMatrix4x4& model, const QMatrix4x4& view,
+                                         const QMatrix4x4& projection)
+{
+    QOpenGLExtraFunctions *f = context()->extraFunctions();
+    voronoiProgram->bind();
+    vao.bind();
+    faceEbo.bind();
+    f->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, voronoiColorBuffer.bufferId());
+
+    voronoiProgram->setUniformValue("model", model);
+    setPositionDequantization(voronoiProgram);
+    voronoiProgram->setUniformValue("view", view);
+    voronoiProgram->setUniformValue("projection", projection);
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDepthFunc(GL_LEQUAL);
+    glDrawElements(GL_TRIANGLES, faces.size(), GL_UNSIGNED_INT, 0);
+    glDepthFunc(GL_LESS);
+
+    f->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    faceEbo.release();
+    vao.release();
+    voronoiProgram->release();
+
+    if (showWireframeOverlay) {
+        drawWireframeOverlay(model, view, projection);
+    }
+}
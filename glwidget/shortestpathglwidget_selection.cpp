@@ -0,0 +1,246 @@
+// shortestpathglwidget_selection.cpp
+// 套索/笔刷区域选择
+#include "shortestpathglwidget.h"
+#include "../meshutils/parallel_utils.h"
+#include <QPainter>
+#include <chrono>
+#include <iostream>
+
+void ShortestPathGLWidget::setSelectionTool(SelectionTool tool)
+{
+    selectionTool = tool;
+    regionSelecting = false;
+    lassoPolygon.clear();
+    brushVisible = false;
+    setCursor(tool == PointTool ? Qt::ArrowCursor : Qt::CrossCursor);
+    update();
+}
+
+void ShortestPathGLWidget::clearRegionSelection()
+{
+    regionVertexSelection.fill(false);
+    regionFaceSelection.fill(false);
+    selectionDirty = true;
+    emit regionSelectionChanged(0, 0);
+    update();
+}
+
+// 网格变化后旧的索引全部失效，位集按新的顶点/面数重新分配
+void ShortestPathGLWidget::syncSelectionToGeometry()
+{
+    if (selectionGeometryVersion == geometryVersion) return;
+
+    selectionGeometryVersion = geometryVersion;
+    regionVertexSelection = QBitArray(static_cast<int>(openMesh.n_vertices()));
+    regionFaceSelection = QBitArray(static_cast<int>(openMesh.n_faces()));
+    selectedVertices.clear();
+    pathVertices.clear();
+    pathEdges.clear();
+    pathEdgeIndices.clear();
+    pathPolyline.clear();
+    pathEdgesDirty = true;
+    hoveredVertex = -1;
+    highlightDirty = true;
+    selectionDirty = true;
+}
+
+void ShortestPathGLWidget::selectWithLasso()
+{
+    if (lassoPolygon.size() < 3) return;
+
+    QRect rect = lassoPolygon.boundingRect().intersected(QRect(0, 0, width(), height()));
+    if (rect.isEmpty()) return;
+
+    // 把套索多边形光栅化为掩码，之后每个像素/顶点的包含测试都是O(1)
+    QImage mask(rect.size(), QImage::Format_Grayscale8);
+    mask.fill(0);
+    QPainter painter(&mask);
+    painter.translate(-rect.topLeft());
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::white);
+    painter.drawPolygon(lassoPolygon, Qt::OddEvenFill);
+    painter.end();
+
+    applySelectionMask(mask, rect);
+}
+
+void ShortestPathGLWidget::selectWithBrush(const QPoint& from, const QPoint& to)
+{
+    QRect rect = QRect(from, to).normalized()
+                     .adjusted(-brushRadius, -brushRadius, brushRadius + 1, brushRadius + 1)
+                     .intersected(QRect(0, 0, width(), height()));
+    if (rect.isEmpty()) return;
+
+    // 笔刷沿线段的轨迹：线宽为直径的圆头线段
+    QImage mask(rect.size(), QImage::Format_Grayscale8);
+    mask.fill(0);
+    QPainter painter(&mask);
+    painter.translate(-rect.topLeft());
+    painter.setPen(QPen(Qt::white, 2 * brushRadius, Qt::SolidLine, Qt::RoundCap));
+    painter.drawLine(from, to);
+    painter.end();
+
+    applySelectionMask(mask, rect);
+}
+
+// 用屏幕掩码更新选择：
+// 面元直接从缓存的ID缓冲中读取（只选中可见面），
+// 顶点则并行投影到屏幕，落在掩码内且未被遮挡（与ID缓冲深度比较）的被选中
+void ShortestPathGLWidget::applySelectionMask(const QImage& mask, const QRect& rect)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    if (!ensurePickingCache()) return;
+    syncSelectionToGeometry();
+
+    const int w = pickingCacheKey.size.width();
+    const int h = pickingCacheKey.size.height();
+    const bool value = !regionDeselect;
+
+    if (selectionTarget == SelectFaces) {
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            const uchar* maskLine = mask.constScanLine(y - rect.top());
+            const GLuint* idLine = cachedFaceIds.data() + size_t(h - 1 - y) * w;
+            for (int x = rect.left(); x <= rect.right(); ++x) {
+                GLuint triangleId = idLine[x];
+                if (!maskLine[x - rect.left()] || triangleId == 0 || triangleId > triangleToFace.size()) continue;
+                regionFaceSelection.setBit(triangleToFace[triangleId - 1], value);
+            }
+        }
+    } else {
+        const QMatrix4x4 mvp = modelViewProjection();
+        const size_t vertexCount = openMesh.n_vertices();
+        std::vector<char> hits(vertexCount, 0);
+
+        parallel::parallelFor(0, vertexCount, [&](size_t i) {
+            const Mesh::Point& p = openMesh.point(Mesh::VertexHandle(static_cast<int>(i)));
+            QVector4D clip = mvp.map(QVector4D(float(p[0]), float(p[1]), float(p[2]), 1.0f));
+            if (clip.w() <= 0.0f) return;
+
+            int px = static_cast<int>((clip.x() / clip.w() * 0.5f + 0.5f) * w);
+            int py = static_cast<int>((0.5f - clip.y() / clip.w() * 0.5f) * h);
+            if (!rect.contains(px, py) || !mask.constScanLine(py - rect.top())[px - rect.left()]) return;
+
+            // 透视投影下clip.w即视点空间深度；把缓存的窗口深度还原为线性深度后比较
+            float windowDepth = cachedDepths[size_t(h - 1 - py) * w + px];
+            float ndcDepth = 2.0f * windowDepth - 1.0f;
+            float surfaceDepth = 2.0f * NearPlane * FarPlane /
+                                 (FarPlane + NearPlane - ndcDepth * (FarPlane - NearPlane));
+            if (clip.w() <= surfaceDepth * 1.01f) {
+                hits[i] = 1;
+            }
+        }, 16384);
+
+        for (size_t i = 0; i < vertexCount; ++i) {
+            if (hits[i]) regionVertexSelection.setBit(static_cast<int>(i), value);
+        }
+    }
+
+    selectionDirty = true;
+    emit regionSelectionChanged(regionSelectedVertexCount(), regionSelectedFaceCount());
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::cout << "Region selection took " << duration.count() << " microseconds" << std::endl;
+}
+
+// 选中面元的三角形在前、选中顶点在后，写入同一个索引缓冲；调用时需要当前上下文
+void ShortestPathGLWidget::uploadSelectionIndices()
+{
+    std::vector<unsigned int> indices;
+
+    if (!regionFaceSelection.isEmpty()) {
+        for (size_t t = 0; t < triangleToFace.size(); ++t) {
+            if (regionFaceSelection.testBit(triangleToFace[t])) {
+                indices.push_back(faces[t * 3]);
+                indices.push_back(faces[t * 3 + 1]);
+                indices.push_back(faces[t * 3 + 2]);
+            }
+        }
+    }
+    selectionFaceIndexCount = static_cast<int>(indices.size());
+
+    for (int v = 0; v < regionVertexSelection.size(); ++v) {
+        if (regionVertexSelection.testBit(v)) {
+            indices.push_back(static_cast<unsigned int>(v));
+        }
+    }
+    selectionVertexIndexCount = static_cast<int>(indices.size()) - selectionFaceIndexCount;
+
+    selectionEbo.create();
+    selectionEbo.bind();
+    if (!indices.empty()) {
+        selectionEbo.allocate(indices.data(), indices.size() * sizeof(unsigned int));
+    } else {
+        selectionEbo.allocate(0);
+    }
+    selectionEbo.release();
+    selectionDirty = false;
+
+    GpuMemoryBudget::instance().track(this, "selectionEbo", selectionEbo.size());
+}
+
+void ShortestPathGLWidget::renderRegionSelection(const QMatrix4x4& model, const QMatrix4x4& view,
+                                                 const QMatrix4x4& projection)
+{
+    wireframeProgram->bind();
+    vao.bind();
+    selectionEbo.bind();
+
+    wireframeProgram->setUniformValue("model", model);
+    setPositionDequantization(wireframeProgram);
+    wireframeProgram->setUniformValue("view", view);
+    wireframeProgram->setUniformValue("projection", projection);
+
+    // 选中的面元：半透明橙色，略微前移避免与表面深度冲突
+    if (selectionFaceIndexCount > 0) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0, -1.0);
+
+        wireframeProgram->setUniformValue("lineColor", QVector4D(1.0f, 0.5f, 0.0f, 0.5f));
+        glDrawElements(GL_TRIANGLES, selectionFaceIndexCount, GL_UNSIGNED_INT, nullptr);
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glDisable(GL_BLEND);
+    }
+
+    // 选中的顶点：橙色点
+    if (selectionVertexIndexCount > 0) {
+        glPointSize(6.0f);
+        wireframeProgram->setUniformValue("lineColor", QVector4D(1.0f, 0.5f, 0.0f, 1.0f));
+        glDrawElements(GL_POINTS, selectionVertexIndexCount, GL_UNSIGNED_INT,
+                       reinterpret_cast<const void*>(size_t(selectionFaceIndexCount) * sizeof(unsigned int)));
+    }
+
+    selectionEbo.release();
+    vao.release();
+    wireframeProgram->release();
+}
+
+// 用QPainter在GL画面上叠加套索轮廓和笔刷圆圈
+void ShortestPathGLWidget::drawSelectionOverlay()
+{
+    bool drawLasso = regionSelecting && selectionTool == LassoTool && lassoPolygon.size() > 1;
+    bool drawBrush = selectionTool == BrushTool && (brushVisible || regionSelecting);
+    if (!drawLasso && !drawBrush) return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QColor color = regionDeselect && regionSelecting ? QColor(80, 160, 255) : QColor(255, 140, 0);
+    painter.setPen(QPen(color, 1.5, Qt::DashLine));
+
+    if (drawLasso) {
+        painter.drawPolyline(lassoPolygon);
+        painter.drawLine(lassoPolygon.last(), lassoPolygon.first());
+    }
+    if (drawBrush) {
+        painter.setBrush(Qt::NoBrush);
+        painter.drawEllipse(QPointF(brushPosition), brushRadius, brushRadius);
+    }
+    painter.end();
+
+    // QPainter会改动GL状态，恢复后续绘制依赖的深度测试
+    glEnable(GL_DEPTH_TEST);
+}
@@ -1,5 +1,7 @@
 // uvparamwidget.cpp
 #include "uvparamwidget.h"
+#include "shaderregistry.h"
+#include "../meshutils/simd_convert.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <QtMath>
@@ -43,9 +45,16 @@ UVParamWidget::UVParamWidget(QWidget *parent) : QOpenGLWidget(parent),
         QVector3D(0.8f, 0.8f, 0.56f),    // 加深的浅黄色
         QVector3D(0.8f, 0.64f, 0.48f)    // 加深的浅橙色
     };
+
+    GpuMemoryBudget::instance().registerWidget(this, [this]() {
+        makeCurrent();
+        releaseGpuBuffers();
+        doneCurrent();
+    });
 }
 
 UVParamWidget::~UVParamWidget() {
+    GpuMemoryBudget::instance().unregisterWidget(this);
     makeCurrent();
     squareVao.destroy();
     squareVbo.destroy();
@@ -107,34 +116,29 @@ void UVParamWidget::initializeGL() {
     }
 
     // 初始化抗锯齿线程序
-    antialiasedLineProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    antialiasedLineProgram = ShaderRegistry::instance().programFromSource("uv_aa_line",
         "#version 330 core\n"
         "layout (location = 0) in vec2 aPos;\n"
         "uniform mat4 projection;\n"
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
-        "}\n");
-    
-    antialiasedLineProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "out vec4 FragColor;\n"
         "uniform vec3 lineColor;\n"
         "void main() {\n"
         "   FragColor = vec4(lineColor, 1.0);\n"
         "}\n");
-    antialiasedLineProgram.link();
     
     // 初始化抗锯齿点程序
-    antialiasedPointProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    antialiasedPointProgram = ShaderRegistry::instance().programFromSource("uv_aa_point",
         "#version 330 core\n"
         "layout (location = 0) in vec2 aPos;\n"
         "uniform mat4 projection;\n"
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
         "   gl_PointSize = 6.0;\n"  // 稍微大一点的点以便抗锯齿效果更明显
-        "}\n");
-    
-    antialiasedPointProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "out vec4 FragColor;\n"
         "uniform vec3 pointColor;\n"
@@ -145,7 +149,6 @@ void UVParamWidget::initializeGL() {
         "       discard;\n"
         "   FragColor = vec4(pointColor, 1.0);\n"
         "}\n");
-    antialiasedPointProgram.link();
 
     // Initialize square
     squareVao.create();
@@ -158,52 +161,46 @@ void UVParamWidget::initializeGL() {
     uvVao.create();
     uvVbo.create();
     
-    uvProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    uvProgram = ShaderRegistry::instance().programFromSource("uv_point",
         "#version 330 core\n"
         "layout (location = 0) in vec2 aPos;\n"
         "uniform mat4 projection;\n"
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
         "   gl_PointSize = 5.0;\n"
-        "}\n");
-    
-    uvProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "out vec4 FragColor;\n"
         "uniform vec3 pointColor;\n"
         "void main() {\n"
         "   FragColor = vec4(pointColor, 1.0);\n"
         "}\n");
-    uvProgram.link();
 
     // Initialize lines
     lineVao.create();
     lineVbo.create();
     lineEbo.create();
     
-    lineProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    lineProgram = ShaderRegistry::instance().programFromSource("uv_line",
         "#version 330 core\n"
         "layout (location = 0) in vec2 aPos;\n"
         "uniform mat4 projection;\n"
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
-        "}\n");
-    
-    lineProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "out vec4 FragColor;\n"
         "uniform vec3 lineColor;\n"
         "void main() {\n"
         "   FragColor = vec4(lineColor, 1.0);\n"
         "}\n");
-    lineProgram.link();
     
     // Initialize faces
     faceVao.create();
     faceVbo.create();
     faceColorVbo.create();
     
-    faceProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    faceProgram = ShaderRegistry::instance().programFromSource("uv_face",
         "#version 330 core\n"
         "layout (location = 0) in vec2 aPos;\n"
         "layout (location = 1) in vec3 aColor;\n"
@@ -212,16 +209,13 @@ void UVParamWidget::initializeGL() {
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
         "   fragColor = aColor;\n"
-        "}\n");
-    
-    faceProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "in vec3 fragColor;\n"
         "out vec4 FragColor;\n"
         "void main() {\n"
         "   FragColor = vec4(fragColor, 0.7);\n"  // 半透明
         "}\n");
-    faceProgram.link();
 }
 
 void UVParamWidget::setupSquare() {
@@ -244,27 +238,24 @@ void UVParamWidget::setupSquare() {
     squareEbo.bind();
     squareEbo.allocate(indices, sizeof(indices));
     
-    squareProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+    squareProgram = ShaderRegistry::instance().programFromSource("uv_square",
         "#version 330 core\n"
         "layout (location = 0) in vec3 aPos;\n"
         "uniform mat4 projection;\n"
         "void main() {\n"
         "   gl_Position = projection * vec4(aPos, 1.0);\n"
-        "}\n");
-    
-    squareProgram.addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "}\n",
         "#version 330 core\n"
         "out vec4 FragColor;\n"
         "uniform vec4 squareColor;\n"
         "void main() {\n"
         "   FragColor = squareColor;\n"
         "}\n");
-    squareProgram.link();
     
-    squareProgram.bind();
-    int posLoc = squareProgram.attributeLocation("aPos");
-    squareProgram.enableAttributeArray(posLoc);
-    squareProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
+    squareProgram->bind();
+    int posLoc = squareProgram->attributeLocation("aPos");
+    squareProgram->enableAttributeArray(posLoc);
+    squareProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
     
     squareVao.release();
 }
@@ -379,18 +370,18 @@ void UVParamWidget::setupFaces() {
     faceVbo.bind();
     faceVbo.allocate(faceVertices.data(), faceVertices.size() * sizeof(QVector2D));
     
-    faceProgram.bind();
-    int posLoc = faceProgram.attributeLocation("aPos");
-    faceProgram.enableAttributeArray(posLoc);
-    faceProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
+    faceProgram->bind();
+    int posLoc = faceProgram->attributeLocation("aPos");
+    faceProgram->enableAttributeArray(posLoc);
+    faceProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
     
     // 顶点颜色
     faceColorVbo.bind();
     faceColorVbo.allocate(faceVertexColors.data(), faceVertexColors.size() * sizeof(QVector3D));
     
-    int colorLoc = faceProgram.attributeLocation("aColor");
-    faceProgram.enableAttributeArray(colorLoc);
-    faceProgram.setAttributeBuffer(colorLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
+    int colorLoc = faceProgram->attributeLocation("aColor");
+    faceProgram->enableAttributeArray(colorLoc);
+    faceProgram->setAttributeBuffer(colorLoc, GL_FLOAT, 0, 3, 3 * sizeof(float));
     
     faceVao.release();
 }
@@ -413,24 +404,27 @@ void UVParamWidget::setupUVPoints() {
     
     hasUV = true;
     
-    // 转换UV坐标到[-1,1]范围
-    std::vector<QVector2D> transformedUV;
-    for (const auto& texCoord : texCoords) {
-        // 将UV从[0,1]映射到[-1,1]
-        float x = texCoord[0] * 2.0f - 1.0f;
-        float y = texCoord[1] * 2.0f - 1.0f;
-        transformedUV.emplace_back(x, y);
-    }
+    // 缓冲区可能已被显存预算回收，create()对已创建的缓冲区无影响
+    uvVbo.create();
+    lineVbo.create();
+    faceVbo.create();
+    faceColorVbo.create();
+    
+    // 转换UV坐标到[-1,1]范围（SIMD内核，双精度计算后转为float）
+    std::vector<QVector2D> transformedUV(texCoords.size());
+    static_assert(sizeof(QVector2D) == 2 * sizeof(float), "QVector2D must be two packed floats");
+    simd::convertScaleDoubleToFloat(texCoords.data()->data(), reinterpret_cast<float*>(transformedUV.data()),
+                                    texCoords.size() * 2, 2.0, -1.0);
     
     // Setup points
     uvVao.bind();
     uvVbo.bind();
     uvVbo.allocate(transformedUV.data(), transformedUV.size() * sizeof(QVector2D));
     
-    uvProgram.bind();
-    int posLoc = uvProgram.attributeLocation("aPos");
-    uvProgram.enableAttributeArray(posLoc);
-    uvProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
+    uvProgram->bind();
+    int posLoc = uvProgram->attributeLocation("aPos");
+    uvProgram->enableAttributeArray(posLoc);
+    uvProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
     
     uvVao.release();
     
@@ -460,10 +454,10 @@ void UVParamWidget::setupUVPoints() {
     lineVbo.bind();
     lineVbo.allocate(lineVertices.data(), lineVertices.size() * sizeof(QVector2D));
     
-    lineProgram.bind();
-    posLoc = lineProgram.attributeLocation("aPos");
-    lineProgram.enableAttributeArray(posLoc);
-    lineProgram.setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
+    lineProgram->bind();
+    posLoc = lineProgram->attributeLocation("aPos");
+    lineProgram->enableAttributeArray(posLoc);
+    lineProgram->setAttributeBuffer(posLoc, GL_FLOAT, 0, 2, 2 * sizeof(float));
     
     lineVao.release();
     
@@ -472,6 +466,32 @@ void UVParamWidget::setupUVPoints() {
     
     // Setup faces
     setupFaces();
+    
+    trackGpuBuffers();
+}
+
+void UVParamWidget::trackGpuBuffers() {
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "uvVbo", uvVbo.isCreated() ? uvVbo.size() : 0);
+    budget.track(this, "lineVbo", lineVbo.isCreated() ? lineVbo.size() : 0);
+    budget.track(this, "faceVbo", faceVbo.isCreated() ? faceVbo.size() : 0);
+    budget.track(this, "faceColorVbo", faceColorVbo.isCreated() ? faceColorVbo.size() : 0);
+    buffersResident = true;
+}
+
+void UVParamWidget::releaseGpuBuffers() {
+    // 正方形缓冲区很小，保留
+    uvVbo.destroy();
+    lineVbo.destroy();
+    faceVbo.destroy();
+    faceColorVbo.destroy();
+    buffersResident = false;
+
+    GpuMemoryBudget& budget = GpuMemoryBudget::instance();
+    budget.track(this, "uvVbo", 0);
+    budget.track(this, "lineVbo", 0);
+    budget.track(this, "faceVbo", 0);
+    budget.track(this, "faceColorVbo", 0);
 }
 
 void UVParamWidget::resizeGL(int w, int h) {
@@ -490,13 +510,18 @@ void UVParamWidget::resizeGL(int w, int h) {
 void UVParamWidget::paintGL() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
+    GpuMemoryBudget::instance().touch(this);
+    if (hasUV && !buffersResident) {
+        setupUVPoints();
+    }
+    
     // Draw square
-    squareProgram.bind();
+    squareProgram->bind();
     squareVao.bind();
     squareEbo.bind();
     
-    squareProgram.setUniformValue("projection", projection);
-    squareProgram.setUniformValue("squareColor", 
+    squareProgram->setUniformValue("projection", projection);
+    squareProgram->setUniformValue("squareColor", 
                                  QVector4D(squareColor.redF(), squareColor.greenF(), 
                                            squareColor.blueF(), squareColor.alphaF()));
     
@@ -504,20 +529,20 @@ void UVParamWidget::paintGL() {
     
     squareEbo.release();
     squareVao.release();
-    squareProgram.release();
+    squareProgram->release();
     
     if (hasUV) {
         // Draw faces if enabled
         if (showFaces && faceVertexCount > 0) {
-            faceProgram.bind();
+            faceProgram->bind();
             faceVao.bind();
             
-            faceProgram.setUniformValue("projection", projection);
+            faceProgram->setUniformValue("projection", projection);
             
             glDrawArrays(GL_TRIANGLES, 0, faceVertexCount);
             
             faceVao.release();
-            faceProgram.release();
+            faceProgram->release();
         }
         
         // Draw wireframe if enabled - 使用抗锯齿
@@ -527,31 +552,31 @@ void UVParamWidget::paintGL() {
                 glEnable(GL_LINE_SMOOTH);
                 glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
                 
-                antialiasedLineProgram.bind();
+                antialiasedLineProgram->bind();
                 lineVao.bind();
                 
-                antialiasedLineProgram.setUniformValue("projection", projection);
-                antialiasedLineProgram.setUniformValue("lineColor", 
+                antialiasedLineProgram->setUniformValue("projection", projection);
+                antialiasedLineProgram->setUniformValue("lineColor", 
                                            QVector3D(lineColor.redF(), lineColor.greenF(), lineColor.blueF()));
                 
                 glDrawArrays(GL_LINES, 0, lineVertexCount);
                 
                 lineVao.release();
-                antialiasedLineProgram.release();
+                antialiasedLineProgram->release();
                 
                 glDisable(GL_LINE_SMOOTH);
             } else {
-                lineProgram.bind();
+                lineProgram->bind();
                 lineVao.bind();
                 
-                lineProgram.setUniformValue("projection", projection);
-                lineProgram.setUniformValue("lineColor", 
+                lineProgram->setUniformValue("projection", projection);
+                lineProgram->setUniformValue("lineColor", 
                                            QVector3D(lineColor.redF(), lineColor.greenF(), lineColor.blueF()));
                 
                 glDrawArrays(GL_LINES, 0, lineVertexCount);
                 
                 lineVao.release();
-                lineProgram.release();
+                lineProgram->release();
             }
         }
         
@@ -562,29 +587,29 @@ void UVParamWidget::paintGL() {
                 const auto& texCoords = mesh.property(mvt_list);
                 if (!texCoords.empty()) {
                     if (useAntialiasing) {
-                        antialiasedPointProgram.bind();
+                        antialiasedPointProgram->bind();
                         uvVao.bind();
                         
-                        antialiasedPointProgram.setUniformValue("projection", projection);
-                        antialiasedPointProgram.setUniformValue("pointColor", 
+                        antialiasedPointProgram->setUniformValue("projection", projection);
+                        antialiasedPointProgram->setUniformValue("pointColor", 
                                              QVector3D(pointColor.redF(), pointColor.greenF(), pointColor.blueF()));
                         
                         glDrawArrays(GL_POINTS, 0, texCoords.size());
                         
                         uvVao.release();
-                        antialiasedPointProgram.release();
+                        antialiasedPointProgram->release();
                     } else {
-                        uvProgram.bind();
+                        uvProgram->bind();
                         uvVao.bind();
                         
-                        uvProgram.setUniformValue("projection", projection);
-                        uvProgram.setUniformValue("pointColor", 
+                        uvProgram->setUniformValue("projection", projection);
+                        uvProgram->setUniformValue("pointColor", 
                                                  QVector3D(pointColor.redF(), pointColor.greenF(), pointColor.blueF()));
                         
                         glDrawArrays(GL_POINTS, 0, texCoords.size());
                         
                         uvVao.release();
-                        uvProgram.release();
+                        uvProgram->release();
                     }
                 }
             }
@@ -649,21 +674,7 @@ void UVParamWidget::clearData() {
     makeCurrent();
     
     // 重置所有缓冲区
-    uvVbo.bind();
-    uvVbo.allocate(0, 0);
-    uvVbo.release();
-    
-    lineVbo.bind();
-    lineVbo.allocate(0, 0);
-    lineVbo.release();
-    
-    faceVbo.bind();
-    faceVbo.allocate(0, 0);
-    faceVbo.release();
-    
-    faceColorVbo.bind();
-    faceColorVbo.allocate(0, 0);
-    faceColorVbo.release();
+    releaseGpuBuffers();
     
     doneCurrent();
     
@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include "../meshutils/my_traits.h"  // 添加头文件
+#include "gpumemorybudget.h"
 
 class UVParamWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -47,6 +48,10 @@ public:
     void setupUVPoints();
     void analyzeTopology();
     void setupFaces();
+    // 显存预算：回收UV缓冲区，绘制前按需从mesh重新上传
+    void releaseGpuBuffers();
+    void trackGpuBuffers();
+    bool buffersResident = false;
 
     bool hasUV;
     Mesh mesh;  // 使用OpenMesh的Mesh结构
@@ -56,32 +61,32 @@ public:
     std::vector<QVector3D> colorPalette; // 颜色调色板
 
     // OpenGL objects for square
-    QOpenGLShaderProgram squareProgram;
+    QOpenGLShaderProgram *squareProgram = nullptr;
     QOpenGLBuffer squareVbo;
     QOpenGLBuffer squareEbo;
     QOpenGLVertexArrayObject squareVao;
 
     // OpenGL objects for UV points
-    QOpenGLShaderProgram uvProgram;
+    QOpenGLShaderProgram *uvProgram = nullptr;
     QOpenGLBuffer uvVbo;
     QOpenGLVertexArrayObject uvVao;
 
     // OpenGL objects for UV lines
-    QOpenGLShaderProgram lineProgram;
+    QOpenGLShaderProgram *lineProgram = nullptr;
     QOpenGLBuffer lineVbo;
     QOpenGLBuffer lineEbo;
     QOpenGLVertexArrayObject lineVao;
 
     // OpenGL objects for UV faces
-    QOpenGLShaderProgram faceProgram;
+    QOpenGLShaderProgram *faceProgram = nullptr;
     QOpenGLBuffer faceVbo;
     QOpenGLBuffer faceColorVbo;
     QOpenGLVertexArrayObject faceVao;
 
     // 抗锯齿相关
     bool useAntialiasing;
-    QOpenGLShaderProgram antialiasedLineProgram;
-    QOpenGLShaderProgram antialiasedPointProgram;
+    QOpenGLShaderProgram *antialiasedLineProgram = nullptr;
+    QOpenGLShaderProgram *antialiasedPointProgram = nullptr;
 
     QMatrix4x4 projection;
     QColor squareColor;
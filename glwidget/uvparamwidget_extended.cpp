@@ -21,6 +21,7 @@ void UVParamWidgetExtended::init()
 	if (!get_para_mesh()) return;
     mesh.request_face_normals();
     mesh.update_face_normals();
+	meshGeometry.rebuild(mesh);
 	new_para.add_property(e_segment);
 	for (auto e_h : new_para.edges())
 	{
@@ -160,7 +161,7 @@ void UVParamWidgetExtended::calc_distortion()
 	double total_uv_area = 0.0;
 
 	OpenMesh::Vec3d mesh_BB_max, mesh_BB_min;
-	std::vector<double> face_area(nf);
+	const std::vector<double>& face_area = meshGeometry.faceArea;
 	mesh_BB_max = mesh_BB_min = mesh.point(mesh.vertex_handle(0));
 	for (auto f_h : mesh.faces())
 	{
@@ -177,13 +178,9 @@ void UVParamWidgetExtended::calc_distortion()
 			mesh_BB_min = mesh_BB_min.minimize(mesh_p[i]);
 		}
 
-		mesh_p[1] -= mesh_p[0];
-		mesh_p[2] -= mesh_p[0];
 		para_p[1] -= para_p[0];
 		para_p[2] -= para_p[0];
 
-		face_area[f_h.idx()] = OpenMesh::cross(mesh_p[1], mesh_p[2]).norm() / 2.0;
-
 		total_area += face_area[f_h.idx()];
 		total_uv_area += OpenMesh::cross(para_p[1], para_p[2]).norm() / 2.0;
 	}
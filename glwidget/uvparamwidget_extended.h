@@ -3,6 +3,7 @@
 
 #include "uvparamwidget.h"
 #include "../meshutils/my_traits.h"
+#include "../meshutils/geometry_cache.h"
 
 class UVParamWidgetExtended : public UVParamWidget
 {
@@ -43,6 +44,7 @@ protected:
     double cut_length = 0.0;
     std::set<int> flipped_faces;
     double para_distortion = 0.0;
+    GeometryCache meshGeometry; // mesh的面积/内角缓存，init时计算一次
 
     std::vector<int> vert_corner; // 存储所有角点的顶点ID
     std::vector<OpenMesh::Vec2i> quad_vertices; // 存储角点在参数空间中的整数坐标
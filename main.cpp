@@ -9,6 +9,13 @@
 #include <QPalette>
 #include <QStackedWidget>
 #include <QSplitter>
+#include <QSurfaceFormat>
+#include <QOpenGLWidget>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <functional>
+#include <memory>
+#include <vector>
 #include "glwidget/modelglwidget.h"
 #include "glwidget/baseglwidget.h"
 #include "glwidget/cgalglwidget.h"
@@ -203,6 +210,59 @@ namespace UIUtils {
         return group;
     }
 
+    // 创建双视图使用的信息标签
+    QLabel* createViewInfoLabel(const QString& text) {
+        QLabel *label = new QLabel(text);
+        label->setAlignment(Qt::AlignCenter);
+        label->setFixedHeight(50);
+        label->setStyleSheet("background-color: #3A3A3A; color: white; border-radius: 5px; padding: 5px; font-size: 14px;");
+        label->setWordWrap(true);
+        return label;
+    }
+
+    // 创建无边距的占位容器
+    QWidget* createPlaceholder(QBoxLayout* layout) {
+        QWidget *widget = new QWidget;
+        layout->setContentsMargins(0, 0, 0, 0);
+        widget->setLayout(layout);
+        return widget;
+    }
+
+    // 首帧计时：GL窗口第一次交换缓冲时输出从计时开始到首帧的耗时
+    void reportFirstFrame(QOpenGLWidget* glWidget, const QString& name, const QElapsedTimer& timer) {
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = QObject::connect(glWidget, &QOpenGLWidget::frameSwapped, [connection, name, timer]() {
+            qDebug() << "Time to first frame (" << name << "):" << timer.elapsed() << "ms";
+            QObject::disconnect(*connection);
+        });
+    }
+
+    // 延迟构建的标签页：tabWidget和controlStack中先放占位控件，
+    // 首次激活时才创建GL窗口（及其上下文、缓冲区）和对应的控制面板
+    struct LazyTab {
+        QString name;
+        QWidget *page = nullptr;
+        QWidget *panel = nullptr;
+        std::function<QOpenGLWidget*(QWidget*, QWidget*)> build;
+        std::function<void(QWidget*)> activate;   // 每次激活时调用（可选）
+        bool built = false;
+    };
+
+    void ensureLazyTabBuilt(LazyTab& lazyTab, const QElapsedTimer* startTimer = nullptr) {
+        if (!lazyTab.built) {
+            QElapsedTimer buildTimer;
+            buildTimer.start();
+            QOpenGLWidget *glWidget = lazyTab.build(lazyTab.page, lazyTab.panel);
+            lazyTab.built = true;
+            if (glWidget) {
+                reportFirstFrame(glWidget, lazyTab.name, startTimer ? *startTimer : buildTimer);
+            }
+        }
+        if (lazyTab.activate) {
+            lazyTab.activate(lazyTab.page);
+        }
+    }
+
     // 应用深色主题
     void applyDarkTheme(QApplication& app) {
         QApplication::setStyle(QStyleFactory::create("Fusion"));
@@ -230,6 +290,16 @@ namespace UIUtils {
 
 int main(int argc, char *argv[])
 {
+    // 所有GL窗口共享同一个上下文组，着色器程序只需编译一次
+    QSurfaceFormat format;
+    format.setSamples(4);
+    format.setSwapInterval(1);
+    QSurfaceFormat::setDefaultFormat(format);
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QApplication app(argc, argv);
     UIUtils::applyDarkTheme(app);
 
@@ -241,149 +311,141 @@ int main(int argc, char *argv[])
     QHBoxLayout *mainLayout = new QHBoxLayout(&mainWindow);
     mainLayout->setContentsMargins(10, 10, 10, 10);
     
-    // 创建OpenGL窗口
-    ModelGLWidget *modelGlWidget = new ModelGLWidget;
-    BaseGLWidget *basicGlWidget = new BaseGLWidget;
-    CGALGLWidget *cgalGlWidget = new CGALGLWidget;
-    ShortestPathGLWidget *shortestPathGlWidget = new ShortestPathGLWidget;
-    UVParamWidget *uvParamWidget = new UVParamWidget;
-    
-    // 创建双视图窗口 - 左侧为BaseGLWidget，右侧为UVParamWidget
-    BaseGLWidget *dualViewLeftWidget = new BaseGLWidget;
-    UVParamWidget *dualViewRightWidget = new UVParamWidget;
-    UVParamWidgetExtended *uvParamWidgetExtended = new UVParamWidgetExtended;
-
-    // 创建标签页
+    // 创建标签页和右侧控制面板堆栈
+    // GL窗口及其控制面板在标签页首次激活时才创建（见UIUtils::LazyTab）
     QTabWidget *tabWidget = new QTabWidget;
-    tabWidget->addTab(createBasicTab(basicGlWidget), "OpenMesh");
-    tabWidget->addTab(createCGALTab(cgalGlWidget), "CGAL");
-    tabWidget->addTab(createModelTab(modelGlWidget), "Model");
-    tabWidget->addTab(createShortestPathTab(shortestPathGlWidget), "Shortest Path");
-    tabWidget->addTab(createUVParamTab(uvParamWidget), "UV Parameterization");
-    tabWidget->addTab(createDualViewTab(dualViewLeftWidget, dualViewRightWidget), "Dual View");
-    tabWidget->addTab(createDualViewExtendedTab(dualViewLeftWidget, uvParamWidgetExtended), "Extended Dual View");
-    
-    // 创建右侧控制面板堆栈
     QStackedWidget *controlStack = new QStackedWidget;
+    std::vector<UIUtils::LazyTab> lazyTabs;
     
-    // 模型信息组
-    QLabel *modelInfoLabel = nullptr;
-    QLabel *basicInfoLabel = nullptr;
-    QLabel *cgalInfoLabel = nullptr;
-    QLabel *shortestPathInfoLabel = nullptr;
-    QLabel *uvParamInfoLabel = nullptr;
-    QLabel *dualViewLeftInfoLabel = nullptr;  // 双视图左侧信息标签
-    QLabel *dualViewRightInfoLabel = nullptr; // 双视图右侧信息标签
-    QLabel *dualViewExtendedLeftInfoLabel = nullptr;  // 扩展双视图左侧信息标签
-    QLabel *dualViewExtendedRightInfoLabel = nullptr; // 扩展双视图右侧信息标签
-
-    // 创建OpenMesh标签页的控制面板
-    QWidget *basicControlPanel = new QWidget;
-    QVBoxLayout *basicControlLayout = new QVBoxLayout(basicControlPanel);
-    basicControlLayout->setAlignment(Qt::AlignTop);
-    basicControlLayout->addWidget(UIUtils::createColorSettingsGroup(basicGlWidget));
-    basicControlLayout->addWidget(UIUtils::createModelInfoGroup(&basicInfoLabel));
-    basicControlLayout->addWidget(createBasicControlPanel(basicGlWidget, basicInfoLabel, &mainWindow));
-    
-    // 创建CGAL标签页的控制面板
-    QWidget *cgalControlPanel = new QWidget;
-    QVBoxLayout *cgalControlLayout = new QVBoxLayout(cgalControlPanel);
-    cgalControlLayout->setAlignment(Qt::AlignTop);
-    cgalControlLayout->addWidget(UIUtils::createColorSettingsGroup(cgalGlWidget));
-    cgalControlLayout->addWidget(UIUtils::createModelInfoGroup(&cgalInfoLabel));
-    cgalControlLayout->addWidget(createCGALControlPanel(cgalGlWidget, cgalInfoLabel, &mainWindow));
-    
-    // 创建模型标签页的控制面板
-    QWidget *modelControlPanel = new QWidget;
-    QVBoxLayout *modelControlLayout = new QVBoxLayout(modelControlPanel);
-    modelControlLayout->setAlignment(Qt::AlignTop);
-    modelControlLayout->addWidget(UIUtils::createColorSettingsGroup(modelGlWidget));
-    modelControlLayout->addWidget(UIUtils::createModelInfoGroup(&modelInfoLabel));
-    modelControlLayout->addWidget(createModelControlPanel(modelGlWidget, modelInfoLabel, &mainWindow));
-    
-    // 创建最短路径标签页的控制面板
-    QWidget *shortestPathControlPanel = new QWidget;
-    QVBoxLayout *shortestPathControlLayout = new QVBoxLayout(shortestPathControlPanel);
-    shortestPathControlLayout->setAlignment(Qt::AlignTop);
-    shortestPathControlLayout->addWidget(UIUtils::createColorSettingsGroup(shortestPathGlWidget));
-    shortestPathControlLayout->addWidget(UIUtils::createModelInfoGroup(&shortestPathInfoLabel));
-    shortestPathControlLayout->addWidget(createShortestPathControlPanel(shortestPathGlWidget, shortestPathInfoLabel, &mainWindow));
-    
-    // 创建UV参数化标签页的控制面板
-    QWidget *uvParamControlPanel = new QWidget;
-    QVBoxLayout *uvParamControlLayout = new QVBoxLayout(uvParamControlPanel);
-    uvParamControlLayout->setAlignment(Qt::AlignTop);
-    uvParamControlLayout->addWidget(UIUtils::createModelInfoGroup(&uvParamInfoLabel));
-    uvParamControlLayout->addWidget(createUVParamControlPanel(uvParamWidget, uvParamInfoLabel, &mainWindow));
-    
-    // 创建双视图标签页的控制面板
-    QWidget *dualViewControlPanel = new QWidget;
-    QVBoxLayout *dualViewControlLayout = new QVBoxLayout(dualViewControlPanel);
-    dualViewControlLayout->setAlignment(Qt::AlignTop);
-    
-    // 为双视图创建两个信息标签
-    QLabel *leftInfoLabel = new QLabel("No model loaded (Left View)");
-    leftInfoLabel->setAlignment(Qt::AlignCenter);
-    leftInfoLabel->setFixedHeight(50);
-    leftInfoLabel->setStyleSheet("background-color: #3A3A3A; color: white; border-radius: 5px; padding: 5px; font-size: 14px;");
-    leftInfoLabel->setWordWrap(true);
+    auto addLazyTab = [&](const QString& title, std::function<QOpenGLWidget*(QWidget*, QWidget*)> build) {
+        UIUtils::LazyTab lazyTab;
+        lazyTab.name = title;
+        lazyTab.page = UIUtils::createPlaceholder(new QHBoxLayout);
+        lazyTab.panel = UIUtils::createPlaceholder(new QVBoxLayout);
+        lazyTab.panel->layout()->setAlignment(Qt::AlignTop);
+        lazyTab.build = build;
+        tabWidget->addTab(lazyTab.page, title);
+        controlStack->addWidget(lazyTab.panel);
+        lazyTabs.push_back(lazyTab);
+    };
     
-    QLabel *rightInfoLabel = new QLabel("No model loaded (Right View)");
-    rightInfoLabel->setAlignment(Qt::AlignCenter);
-    rightInfoLabel->setFixedHeight(50);
-    rightInfoLabel->setStyleSheet("background-color: #3A3A3A; color: white; border-radius: 5px; padding: 5px; font-size: 14px;");
-    rightInfoLabel->setWordWrap(true);
+    // 双视图左侧的BaseGLWidget由两个双视图标签页共用，切换时移动到当前标签页的分割器中
+    BaseGLWidget *dualViewLeftWidget = nullptr;
+    auto dualViewLeft = [&dualViewLeftWidget]() {
+        if (!dualViewLeftWidget) {
+            dualViewLeftWidget = new BaseGLWidget;
+        }
+        return dualViewLeftWidget;
+    };
+    auto attachDualViewLeft = [&dualViewLeftWidget](QWidget *page) {
+        QSplitter *splitter = page->findChild<QSplitter*>();
+        if (splitter && dualViewLeftWidget && splitter->indexOf(dualViewLeftWidget) != 0) {
+            splitter->insertWidget(0, dualViewLeftWidget);
+            splitter->setSizes(QList<int>() << 500 << 500);
+        }
+    };
     
-    // 创建信息标签组
-    QGroupBox *infoGroup = new QGroupBox("Model Information");
-    QVBoxLayout *infoLayout = new QVBoxLayout(infoGroup);
-    infoLayout->addWidget(leftInfoLabel);
-    infoLayout->addWidget(rightInfoLabel);
-    
-    dualViewControlLayout->addWidget(infoGroup);
-    dualViewControlLayout->addWidget(createDualViewControlPanel(dualViewLeftWidget, dualViewRightWidget, leftInfoLabel, rightInfoLabel, &mainWindow));
+    addLazyTab("OpenMesh", [&mainWindow](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        BaseGLWidget *basicGlWidget = new BaseGLWidget;
+        QLabel *basicInfoLabel = nullptr;
+        page->layout()->addWidget(createBasicTab(basicGlWidget));
+        panel->layout()->addWidget(UIUtils::createColorSettingsGroup(basicGlWidget));
+        panel->layout()->addWidget(UIUtils::createModelInfoGroup(&basicInfoLabel));
+        panel->layout()->addWidget(createBasicControlPanel(basicGlWidget, basicInfoLabel, &mainWindow));
+        return basicGlWidget;
+    });
     
-    // 创建扩展双视图标签页的控制面板
-    QWidget *dualViewExtendedControlPanel = new QWidget;
-    QVBoxLayout *dualViewExtendedControlLayout = new QVBoxLayout(dualViewExtendedControlPanel);
-    dualViewExtendedControlLayout->setAlignment(Qt::AlignTop);
+    addLazyTab("CGAL", [&mainWindow](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        CGALGLWidget *cgalGlWidget = new CGALGLWidget;
+        QLabel *cgalInfoLabel = nullptr;
+        page->layout()->addWidget(createCGALTab(cgalGlWidget));
+        panel->layout()->addWidget(UIUtils::createColorSettingsGroup(cgalGlWidget));
+        panel->layout()->addWidget(UIUtils::createModelInfoGroup(&cgalInfoLabel));
+        panel->layout()->addWidget(createCGALControlPanel(cgalGlWidget, cgalInfoLabel, &mainWindow));
+        return cgalGlWidget;
+    });
     
-    // 为扩展双视图创建两个信息标签
-    QLabel *extendedLeftInfoLabel = new QLabel("No model loaded (Left View)");
-    extendedLeftInfoLabel->setAlignment(Qt::AlignCenter);
-    extendedLeftInfoLabel->setFixedHeight(50);
-    extendedLeftInfoLabel->setStyleSheet("background-color: #3A3A3A; color: white; border-radius: 5px; padding: 5px; font-size: 14px;");
-    extendedLeftInfoLabel->setWordWrap(true);
+    addLazyTab("Model", [&mainWindow](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        ModelGLWidget *modelGlWidget = new ModelGLWidget;
+        QLabel *modelInfoLabel = nullptr;
+        page->layout()->addWidget(createModelTab(modelGlWidget));
+        panel->layout()->addWidget(UIUtils::createColorSettingsGroup(modelGlWidget));
+        panel->layout()->addWidget(UIUtils::createModelInfoGroup(&modelInfoLabel));
+        panel->layout()->addWidget(createModelControlPanel(modelGlWidget, modelInfoLabel, &mainWindow));
+        return modelGlWidget;
+    });
     
-    QLabel *extendedRightInfoLabel = new QLabel("No model loaded (Right View)");
-    extendedRightInfoLabel->setAlignment(Qt::AlignCenter);
-    extendedRightInfoLabel->setFixedHeight(50);
-    extendedRightInfoLabel->setStyleSheet("background-color: #3A3A3A; color: white; border-radius: 5px; padding: 5px; font-size: 14px;");
-    extendedRightInfoLabel->setWordWrap(true);
+    addLazyTab("Shortest Path", [&mainWindow](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        ShortestPathGLWidget *shortestPathGlWidget = new ShortestPathGLWidget;
+        QLabel *shortestPathInfoLabel = nullptr;
+        page->layout()->addWidget(createShortestPathTab(shortestPathGlWidget));
+        panel->layout()->addWidget(UIUtils::createColorSettingsGroup(shortestPathGlWidget));
+        panel->layout()->addWidget(UIUtils::createModelInfoGroup(&shortestPathInfoLabel));
+        panel->layout()->addWidget(createShortestPathControlPanel(shortestPathGlWidget, shortestPathInfoLabel, &mainWindow));
+        return shortestPathGlWidget;
+    });
     
-    // 创建信息标签组
-    QGroupBox *extendedInfoGroup = new QGroupBox("Model Information");
-    QVBoxLayout *extendedInfoLayout = new QVBoxLayout(extendedInfoGroup);
-    extendedInfoLayout->addWidget(extendedLeftInfoLabel);
-    extendedInfoLayout->addWidget(extendedRightInfoLabel);
+    addLazyTab("UV Parameterization", [&mainWindow](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        UVParamWidget *uvParamWidget = new UVParamWidget;
+        QLabel *uvParamInfoLabel = nullptr;
+        page->layout()->addWidget(createUVParamTab(uvParamWidget));
+        panel->layout()->addWidget(UIUtils::createModelInfoGroup(&uvParamInfoLabel));
+        panel->layout()->addWidget(createUVParamControlPanel(uvParamWidget, uvParamInfoLabel, &mainWindow));
+        return uvParamWidget;
+    });
     
-    dualViewExtendedControlLayout->addWidget(extendedInfoGroup);
-    dualViewExtendedControlLayout->addWidget(createDualViewExtendedControlPanel(dualViewLeftWidget, uvParamWidgetExtended, extendedLeftInfoLabel, extendedRightInfoLabel, &mainWindow));
+    // 双视图 - 左侧为BaseGLWidget，右侧为UVParamWidget
+    addLazyTab("Dual View", [&mainWindow, dualViewLeft](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        UVParamWidget *dualViewRightWidget = new UVParamWidget;
+        page->layout()->addWidget(createDualViewTab(dualViewLeft(), dualViewRightWidget));
+        
+        // 为双视图创建两个信息标签
+        QLabel *leftInfoLabel = UIUtils::createViewInfoLabel("No model loaded (Left View)");
+        QLabel *rightInfoLabel = UIUtils::createViewInfoLabel("No model loaded (Right View)");
+        
+        // 创建信息标签组
+        QGroupBox *infoGroup = new QGroupBox("Model Information");
+        QVBoxLayout *infoLayout = new QVBoxLayout(infoGroup);
+        infoLayout->addWidget(leftInfoLabel);
+        infoLayout->addWidget(rightInfoLabel);
+        
+        panel->layout()->addWidget(infoGroup);
+        panel->layout()->addWidget(createDualViewControlPanel(dualViewLeft(), dualViewRightWidget, leftInfoLabel, rightInfoLabel, &mainWindow));
+        return dualViewRightWidget;
+    });
+    lazyTabs.back().activate = attachDualViewLeft;
     
-    // 添加到堆栈 - 调整顺序以匹配标签页顺序
-    controlStack->addWidget(basicControlPanel);      // OpenMesh
-    controlStack->addWidget(cgalControlPanel);       // CGAL
-    controlStack->addWidget(modelControlPanel);      // Model
-    controlStack->addWidget(shortestPathControlPanel); // Shortest Path
-    controlStack->addWidget(uvParamControlPanel);    // UV Parameterization
-    controlStack->addWidget(dualViewControlPanel);   // Dual View
-    controlStack->addWidget(dualViewExtendedControlPanel); // Extended Dual View
+    addLazyTab("Extended Dual View", [&mainWindow, dualViewLeft](QWidget *page, QWidget *panel) -> QOpenGLWidget* {
+        UVParamWidgetExtended *uvParamWidgetExtended = new UVParamWidgetExtended;
+        page->layout()->addWidget(createDualViewExtendedTab(dualViewLeft(), uvParamWidgetExtended));
+        
+        // 为扩展双视图创建两个信息标签
+        QLabel *extendedLeftInfoLabel = UIUtils::createViewInfoLabel("No model loaded (Left View)");
+        QLabel *extendedRightInfoLabel = UIUtils::createViewInfoLabel("No model loaded (Right View)");
+        
+        // 创建信息标签组
+        QGroupBox *extendedInfoGroup = new QGroupBox("Model Information");
+        QVBoxLayout *extendedInfoLayout = new QVBoxLayout(extendedInfoGroup);
+        extendedInfoLayout->addWidget(extendedLeftInfoLabel);
+        extendedInfoLayout->addWidget(extendedRightInfoLabel);
+        
+        panel->layout()->addWidget(extendedInfoGroup);
+        panel->layout()->addWidget(createDualViewExtendedControlPanel(dualViewLeft(), uvParamWidgetExtended, extendedLeftInfoLabel, extendedRightInfoLabel, &mainWindow));
+        return uvParamWidgetExtended;
+    });
+    lazyTabs.back().activate = attachDualViewLeft;
     
-    // 连接标签切换信号
-    QObject::connect(tabWidget, &QTabWidget::currentChanged, [controlStack](int index) {
+    // 连接标签切换信号：首次激活时构建标签页
+    QObject::connect(tabWidget, &QTabWidget::currentChanged, [controlStack, &lazyTabs](int index) {
+        if (index < 0 || index >= static_cast<int>(lazyTabs.size())) return;
+        UIUtils::ensureLazyTabBuilt(lazyTabs[index]);
         controlStack->setCurrentIndex(index);
     });
     
+    // 当前（第一个）标签页立即构建，其首帧时间从程序启动开始计算
+    UIUtils::ensureLazyTabBuilt(lazyTabs[tabWidget->currentIndex()], &startupTimer);
+    controlStack->setCurrentIndex(tabWidget->currentIndex());
+    
     // 设置控制面板固定宽度
     controlStack->setFixedWidth(400);
     
@@ -0,0 +1,90 @@
+// curvature.cpp
+#include "curvature.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
+
+#define EPSILON 1E-4F
+
+VertexCurvature computeVertexCurvature(const Mesh& mesh, const GeometryCache& geometry, Mesh::VertexHandle vh) {
+    VertexCurvature result;
+    if (mesh.is_boundary(vh)) {
+        return result;
+    }
+
+    // 高斯曲率：角亏/重心面积，均取自几何缓存
+    float angleDefect = 2 * M_PI - geometry.vertexAngleSum[vh.idx()];
+    float area = geometry.vertexArea[vh.idx()];
+    float A_mixed = 0.f;
+
+    for (auto heh : mesh.voh_range(vh)) {
+        // 平均曲率项：取出边所在面（边界时取对边所在面）中以v为顶点的角
+        Mesh::HalfedgeHandle corner = heh;
+        if (mesh.is_boundary(heh)) {
+            auto opp_heh = mesh.opposite_halfedge_handle(heh);
+            if (mesh.is_boundary(opp_heh)) continue;
+            corner = mesh.next_halfedge_handle(opp_heh);
+        }
+
+        float triArea = geometry.faceArea[mesh.face_handle(corner).idx()];
+        if (triArea <= EPSILON) continue;
+
+        auto prev = mesh.prev_halfedge_handle(corner);
+        double angleV = geometry.cornerAngle[corner.idx()];
+        bool nonObtuse =
+            angleV <= M_PI_2 &&
+            geometry.cornerAngle[mesh.next_halfedge_handle(corner).idx()] <= M_PI_2 &&
+            geometry.cornerAngle[prev.idx()] <= M_PI_2;
+
+        if (nonObtuse) {
+            float cotV = geometry.cornerCotan[corner.idx()];
+            float dist2_adjV = mesh.calc_edge_sqr_length(corner);
+            float dist2_np = mesh.calc_edge_sqr_length(prev);
+
+            A_mixed += (dist2_adjV + dist2_np) * cotV / 8.0f;
+        } else if (angleV > M_PI_2) {
+            A_mixed += triArea / 2.0f;
+        } else {
+            A_mixed += triArea / 4.0f;
+        }
+    }
+
+    if (area > EPSILON) {
+        result.gaussian = angleDefect / area;
+    }
+    if (A_mixed > EPSILON) {
+        result.mean = 0.5f * sqrt(A_mixed);
+    }
+    return result;
+}
+
+void computeVertexCurvatures(const Mesh& mesh, const GeometryCache& geometry, std::vector<VertexCurvature>& out) {
+    out.assign(mesh.n_vertices(), VertexCurvature());
+    parallel::parallelFor(0, mesh.n_vertices(), [&](size_t i) {
+        out[i] = computeVertexCurvature(mesh, geometry, Mesh::VertexHandle(static_cast<int>(i)));
+    }, 2048);
+}
+
+bool curvatureRange(const Mesh& mesh, const std::vector<float>& values, float& minValue, float& maxValue) {
+    minValue = FLT_MAX;
+    maxValue = -FLT_MAX;
+    std::mutex mergeMutex;
+
+    // 每个线程先求局部极值，最后合并一次
+    parallel::parallelForRange(0, values.size(), [&](size_t begin, size_t end) {
+        float localMin = FLT_MAX;
+        float localMax = -FLT_MAX;
+        for (size_t i = begin; i < end; ++i) {
+            if (mesh.is_boundary(Mesh::VertexHandle(static_cast<int>(i)))) continue;
+            localMin = std::min(localMin, values[i]);
+            localMax = std::max(localMax, values[i]);
+        }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        minValue = std::min(minValue, localMin);
+        maxValue = std::max(maxValue, localMax);
+    });
+
+    return minValue <= maxValue;
+}
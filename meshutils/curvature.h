@@ -0,0 +1,28 @@
+// curvature.h
+#ifndef CURVATURE_H
+#define CURVATURE_H
+
+#include <vector>
+#include "my_traits.h"
+#include "geometry_cache.h"
+
+// 离散曲率计算引擎
+// 每个顶点只遍历一次出边半边，同时得到高斯曲率（角亏/重心面积）和平均曲率项，
+// 不再对每个邻接顶点调用find_halfedge（原实现为O(valence²)）。
+// 内角、余切与面积来自GeometryCache，不在这里重复计算。
+// 顶点之间相互独立，按顶点并行计算。
+struct VertexCurvature {
+    float gaussian = 0.0f;
+    float mean = 0.0f;
+};
+
+// 计算单个顶点的曲率，边界顶点返回0
+VertexCurvature computeVertexCurvature(const Mesh& mesh, const GeometryCache& geometry, Mesh::VertexHandle vh);
+
+// 并行计算所有顶点的曲率，结果按顶点索引存放
+void computeVertexCurvatures(const Mesh& mesh, const GeometryCache& geometry, std::vector<VertexCurvature>& out);
+
+// 并行归约求values在非边界顶点上的最小/最大值，没有非边界顶点时返回false
+bool curvatureRange(const Mesh& mesh, const std::vector<float>& values, float& minValue, float& maxValue);
+
+#endif // CURVATURE_H
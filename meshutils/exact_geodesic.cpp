@@ -0,0 +1,505 @@
+// exact_geodesic.cpp
+#include "exact_geodesic.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const double Infinity = std::numeric_limits<double>::max();
+const double TwoPi = 6.283185307179586;
+
+double distance3(const double* a, const double* b) {
+    double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// 过s和p的直线与x轴（y=0）交点的x坐标；p比s更靠近x轴
+double crossAxis(double sx, double sy, double px, double py) {
+    double dy = py - sy;
+    if (dy <= 1e-300) return px;
+    return sx + (px - sx) * (-sy) / dy;
+}
+
+}
+
+void GeodesicMesh::clear() {
+    positions.clear();
+    halfedgeTo.clear();
+    opposite.clear();
+    length.clear();
+    outgoingOffsets.clear();
+    outgoing.clear();
+    pseudoSource.clear();
+}
+
+void GeodesicMesh::build(const double* points, size_t vertexCount, const std::vector<unsigned int>& triangles) {
+    clear();
+    const size_t halfedgeCount = triangles.size() / 3 * 3;
+    if (vertexCount == 0 || halfedgeCount == 0) return;
+
+    positions.assign(points, points + vertexCount * 3);
+    halfedgeTo.resize(halfedgeCount);
+    length.resize(halfedgeCount);
+    for (size_t h = 0; h < halfedgeCount; ++h) {
+        halfedgeTo[h] = triangles[next(static_cast<uint32_t>(h))];
+    }
+    double lengthSum = 0.0;
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        length[h] = distance3(point(from(h)), point(to(h)));
+        lengthSum += length[h];
+    }
+    epsilon = 1e-9 * lengthSum / halfedgeCount;
+
+    // 按无向边排序配对：恰好两条方向相反的半边才互为对边，其余按边界处理
+    std::vector<std::pair<uint64_t, uint32_t>> keys(halfedgeCount);
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        uint64_t a = from(h), b = to(h);
+        keys[h] = std::make_pair(std::min(a, b) << 32 | std::max(a, b), h);
+    }
+    std::sort(keys.begin(), keys.end());
+    opposite.assign(halfedgeCount, Invalid);
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i;
+        while (j < keys.size() && keys[j].first == keys[i].first) ++j;
+        if (j - i == 2) {
+            uint32_t h0 = keys[i].second, h1 = keys[i + 1].second;
+            if (from(h0) == to(h1)) {
+                opposite[h0] = h1;
+                opposite[h1] = h0;
+            }
+        }
+        i = j;
+    }
+
+    outgoingOffsets.assign(vertexCount + 1, 0);
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        ++outgoingOffsets[from(h) + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        outgoingOffsets[v + 1] += outgoingOffsets[v];
+    }
+    outgoing.resize(halfedgeCount);
+    std::vector<uint32_t> slot(outgoingOffsets.begin(), outgoingOffsets.end() - 1);
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        outgoing[slot[from(h)]++] = h;
+    }
+
+    // 角度和不小于2π（鞍点）或位于边界的顶点，测地线可以经过并在此转折
+    std::vector<double> angleSum(vertexCount, 0.0);
+    pseudoSource.assign(vertexCount, 0);
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        double a = length[h], b = length[prev(h)], c = length[next(h)];
+        if (a > 0.0 && b > 0.0) {
+            angleSum[from(h)] += std::acos(std::max(-1.0, std::min(1.0, (a * a + b * b - c * c) / (2.0 * a * b))));
+        }
+        if (opposite[h] == Invalid) {
+            pseudoSource[from(h)] = 1;
+            pseudoSource[to(h)] = 1;
+        }
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (angleSum[v] >= TwoPi - 1e-6) pseudoSource[v] = 1;
+    }
+}
+
+void GeodesicPropagation::reset(const GeodesicMesh& m) {
+    mesh = &m;
+    dist.assign(m.vertexCount(), Infinity);
+    vertexSource.assign(m.vertexCount(), VertexSource());
+    splitDist.assign(m.halfedgeTo.size(), Infinity);
+    splitX.assign(m.halfedgeTo.size(), 0.0);
+    windows.clear();
+    freeWindows.clear();
+    heap.clear();
+    liveWindows = 0;
+    peakLive = 0;
+    propagated = 0;
+    targetWindow = -1;
+    targetWindowDist = Infinity;
+    targetCorner = -1;
+    targetBest = Infinity;
+}
+
+void GeodesicPropagation::resolve(SurfacePoint& p) const {
+    if (p.vertex >= 0) {
+        const double* q = mesh->point(p.vertex);
+        std::copy(q, q + 3, p.position);
+    }
+}
+
+// 点p在半边h的局部坐标系中的位置：原点为半边起点，x轴沿半边，p在半边三角形一侧时y >= 0
+void GeodesicPropagation::frame(uint32_t h, const double* p, double& x, double& y) const {
+    const double* a = mesh->point(mesh->from(h));
+    const double* b = mesh->point(mesh->to(h));
+    const double len = mesh->length[h];
+    double e[3] = { (b[0] - a[0]) / len, (b[1] - a[1]) / len, (b[2] - a[2]) / len };
+    double d[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+    x = d[0] * e[0] + d[1] * e[1] + d[2] * e[2];
+    y = std::sqrt(std::max(0.0, d[0] * d[0] + d[1] * d[1] + d[2] * d[2] - x * x));
+}
+
+void GeodesicPropagation::updateVertex(uint32_t v, double d, VertexSource from) {
+    if (d >= dist[v]) return;
+
+    dist[v] = d;
+    if (from.window >= 0) ++windows[from.window].refs;
+    int previous = vertexSource[v].window;
+    vertexSource[v] = from;
+    if (previous >= 0) release(previous);
+
+    if (mesh->pseudoSource[v] || int(v) == source.vertex) {
+        heap.push_back(Event{ d, -int(v) - 1 });
+        std::push_heap(heap.begin(), heap.end(), std::greater<Event>());
+    }
+}
+
+// 伪源点v：沿边直接更新邻点，并在每个相邻三角形的对边上产生覆盖整条边的根窗口
+void GeodesicPropagation::expandPseudoSource(uint32_t v) {
+    const GeodesicMesh& m = *mesh;
+    const double dv = dist[v];
+    for (uint32_t i = m.outgoingOffsets[v]; i < m.outgoingOffsets[v + 1]; ++i) {
+        uint32_t h = m.outgoing[i];          // v -> B
+        uint32_t opp = GeodesicMesh::next(h);  // B -> C
+        uint32_t back = GeodesicMesh::prev(h); // C -> v
+        updateVertex(m.to(h), dv + m.length[h], VertexSource{ -1, int(v) });
+        updateVertex(m.from(back), dv + m.length[back], VertexSource{ -1, int(v) });
+
+        uint32_t g = m.opposite[opp];        // C -> B，朝向邻接三角形
+        if (g == GeodesicMesh::Invalid) continue;
+        double len = m.length[g];
+        double a = m.length[back];           // |Cv|
+        double b = m.length[h];              // |Bv|
+        double sx = (len * len + a * a - b * b) / (2.0 * len);
+        double sy = -std::sqrt(std::max(0.0, a * a - sx * sx));
+        createWindow(g, 0.0, len, sx, sy, dv, -1, int(v));
+    }
+}
+
+// 端点判据：沿边，D(x)-x单调不增，D(x)+x单调不减（D为窗口给出的距离），
+// 所以"到起点A再沿边过去"比窗口短的点构成区间的前缀，"到终点B再沿边过去"比窗口短的点构成后缀。
+// 顶点距离都是实际路径长度，用它们截短窗口总是安全的；截空时返回false
+bool GeodesicPropagation::trim(Window& w) const {
+    const GeodesicMesh& m = *mesh;
+    const double eps = m.epsilon;
+    const double len = m.length[w.halfedge];
+
+    const double dA = dist[m.from(w.halfedge)];
+    if (dA < Infinity && dA + w.b0 < w.d0 + std::hypot(w.b0 - w.sx, w.sy) - eps) {
+        if (dA + w.b1 < w.d0 + std::hypot(w.b1 - w.sx, w.sy) - eps) return false;
+        // 交点：(x - sx)^2 + sy^2 = (x + k)^2
+        double k = dA - w.d0;
+        if (w.sx + k > 0.0) {
+            w.b0 = std::max(w.b0, (w.sx * w.sx + w.sy * w.sy - k * k) / (2.0 * (w.sx + k)));
+        }
+    }
+
+    const double dB = dist[m.to(w.halfedge)];
+    if (dB < Infinity && dB + len - w.b1 < w.d0 + std::hypot(w.b1 - w.sx, w.sy) - eps) {
+        if (dB + len - w.b0 < w.d0 + std::hypot(w.b0 - w.sx, w.sy) - eps) return false;
+        // 交点：(x - sx)^2 + sy^2 = (k - x)^2
+        double k = dB + len - w.d0;
+        if (k - w.sx > 0.0) {
+            w.b1 = std::min(w.b1, (k * k - w.sx * w.sx - w.sy * w.sy) / (2.0 * (k - w.sx)));
+        }
+    }
+    return w.b1 - w.b0 >= eps;
+}
+
+void GeodesicPropagation::createWindow(uint32_t h, double b0, double b1, double sx, double sy, double d0,
+                                       int parent, int pseudo) {
+    if (b1 - b0 < mesh->epsilon) return;
+
+    Window w{ h, b0, b1, sx, sy, d0, parent, pseudo, 1 };
+    if (!trim(w)) return;
+
+    int id;
+    if (!freeWindows.empty()) {
+        id = freeWindows.back();
+        freeWindows.pop_back();
+        windows[id] = w;
+    } else {
+        id = static_cast<int>(windows.size());
+        windows.push_back(w);
+    }
+    if (parent >= 0) ++windows[parent].refs;
+    peakLive = std::max(peakLive, ++liveWindows);
+
+    // 键值为窗口上各点的最小距离
+    double nearest = std::min(std::max(sx, b0), b1);
+    heap.push_back(Event{ d0 + std::hypot(nearest - sx, sy), id });
+    std::push_heap(heap.begin(), heap.end(), std::greater<Event>());
+}
+
+void GeodesicPropagation::release(int id) {
+    while (id >= 0 && --windows[id].refs == 0) {
+        int parent = windows[id].parent;
+        freeWindows.push_back(id);
+        --liveWindows;
+        id = parent;
+    }
+}
+
+// 窗口跨过三角形ABC传播：源点向C的射线把区间分为左右两部分，分别投到AC和CB边上成为子窗口
+void GeodesicPropagation::propagateWindow(int id) {
+    const GeodesicMesh& m = *mesh;
+    const Window w = windows[id];
+    const uint32_t h = w.halfedge;
+    const uint32_t c = m.to(GeodesicMesh::next(h));
+    const double eps = m.epsilon;
+    const double len = m.length[h];
+    const double lenAC = m.length[GeodesicMesh::prev(h)];
+    const double lenBC = m.length[GeodesicMesh::next(h)];
+
+    // 三角形展开到窗口坐标系：A=(0,0)，B=(len,0)，C在上半平面
+    const double cx = (len * len + lenAC * lenAC - lenBC * lenBC) / (2.0 * len);
+    const double cy = std::max(std::sqrt(std::max(0.0, lenAC * lenAC - cx * cx)), eps);
+    const double xC = crossAxis(w.sx, w.sy, cx, cy);
+
+    // 左子窗口由[b0, leftEnd]内的射线组成，右子窗口由[rightBegin, b1]内的射线组成
+    double leftEnd = std::min(w.b1, xC);
+    double rightBegin = std::max(w.b0, xC);
+    if (xC >= w.b0 - eps && xC <= w.b1 + eps) {
+        double dC = w.d0 + std::hypot(cx - w.sx, cy - w.sy);
+        updateVertex(c, dC, VertexSource{ id, -1 });
+
+        // 一角一分裂：已有更短的路径经过C（在splitX处穿过AB）时，本窗口中与该路径的最后一段
+        // 相交的射线在交点之后都不如沿已有路径走（否则本窗口到C会更短），把对应的子窗口截掉这一段
+        if (dC < splitDist[h]) {
+            splitDist[h] = dC;
+            splitX[h] = xC;
+        } else if (xC < splitX[h]) {
+            rightBegin = std::max(rightBegin, splitX[h]);
+        } else {
+            leftEnd = std::min(leftEnd, splitX[h]);
+        }
+    }
+
+    // 目标点位于本三角形内：源点到目标点的直线穿过窗口区间时得到一个候选距离
+    if (hasTarget && target.vertex < 0 && uint32_t(target.triangle) == h / 3) {
+        double px, py;
+        frame(h, target.position, px, py);
+        double x = crossAxis(w.sx, w.sy, px, py);
+        if (x >= w.b0 - eps && x <= w.b1 + eps) {
+            double d = w.d0 + std::hypot(px - w.sx, py - w.sy);
+            if (d < targetWindowDist) {
+                ++windows[id].refs;
+                if (targetWindow >= 0) release(targetWindow);
+                targetWindow = id;
+                targetWindowDist = d;
+            }
+        }
+    }
+
+    // 左子窗口在AC上（对侧半边A->C），坐标系原点A，x轴沿AC，B一侧为负
+    uint32_t g = m.opposite[GeodesicMesh::prev(h)];
+    if (leftEnd > w.b0 && g != GeodesicMesh::Invalid) {
+        double ex = cx / lenAC, ey = cy / lenAC;
+        double sx = w.sx * ex + w.sy * ey;
+        double sy = -w.sx * ey + w.sy * ex;
+        auto hit = [&](double x) {
+            return std::min(std::max(crossAxis(sx, sy, x * ex, -x * ey), 0.0), lenAC);
+        };
+        createWindow(g, hit(w.b0), hit(leftEnd), sx, sy, w.d0, id, w.pseudoSource);
+    }
+
+    // 右子窗口在CB上（对侧半边C->B），坐标系原点C，x轴沿CB，A一侧为负
+    g = m.opposite[GeodesicMesh::next(h)];
+    if (rightBegin < w.b1 && g != GeodesicMesh::Invalid) {
+        double ex = (len - cx) / lenBC, ey = -cy / lenBC;
+        double rx = w.sx - cx, ry = w.sy - cy;
+        double sx = rx * ex + ry * ey;
+        double sy = -rx * ey + ry * ex;
+        auto hit = [&](double x) {
+            double qx = x - cx, qy = -cy;
+            return std::min(std::max(crossAxis(sx, sy, qx * ex + qy * ey, -qx * ey + qy * ex), 0.0), lenBC);
+        };
+        createWindow(g, hit(rightBegin), hit(w.b1), sx, sy, w.d0, id, w.pseudoSource);
+    }
+}
+
+// 目标当前的距离上界：目标顶点的距离，或三角形内目标点经窗口/三个角/源点直达的最小值
+double GeodesicPropagation::targetBound() const {
+    if (target.vertex >= 0) return dist[target.vertex];
+
+    double bound = targetWindowDist;
+    const uint32_t t = target.triangle;
+    for (int i = 0; i < 3; ++i) {
+        uint32_t c = mesh->halfedgeTo[t * 3 + i];
+        if (dist[c] < Infinity) {
+            bound = std::min(bound, dist[c] + distance3(mesh->point(c), target.position));
+        }
+    }
+    if (source.triangle == target.triangle && source.vertex < 0) {
+        bound = std::min(bound, distance3(source.position, target.position));
+    }
+    return bound;
+}
+
+void GeodesicPropagation::finishTarget() {
+    targetBest = targetBound();
+    if (target.vertex >= 0 || targetBest == Infinity) return;
+
+    // 记录最优路径经过的角（或直达），回溯时使用
+    targetCorner = -1;
+    if (targetBest < targetWindowDist) {
+        const uint32_t t = target.triangle;
+        for (int i = 0; i < 3; ++i) {
+            uint32_t c = mesh->halfedgeTo[t * 3 + i];
+            if (dist[c] < Infinity && dist[c] + distance3(mesh->point(c), target.position) == targetBest) {
+                targetCorner = int(c);
+            }
+        }
+        if (targetCorner < 0) targetCorner = -2;
+    }
+}
+
+void GeodesicPropagation::propagate(const GeodesicMesh& m, const SurfacePoint& from, const SurfacePoint* to) {
+    reset(m);
+    source = from;
+    resolve(source);
+    hasTarget = to != nullptr;
+    if (hasTarget) {
+        target = *to;
+        resolve(target);
+    }
+    if (m.empty()) return;
+
+    if (source.vertex >= 0) {
+        updateVertex(source.vertex, 0.0, VertexSource());
+    } else {
+        // 三角形内的源点：直接连到三个角，并在三条边上产生根窗口
+        const uint32_t t = source.triangle;
+        for (uint32_t h = t * 3; h < t * 3 + 3; ++h) {
+            uint32_t c = m.to(h);
+            updateVertex(c, distance3(m.point(c), source.position), VertexSource{ -1, -2 });
+        }
+        for (uint32_t h = t * 3; h < t * 3 + 3; ++h) {
+            uint32_t g = m.opposite[h];
+            if (g == GeodesicMesh::Invalid) continue;
+            double x, y;
+            frame(g, source.position, x, y);
+            createWindow(g, 0.0, m.length[g], x, -y, 0.0, -1, -1);
+        }
+    }
+
+    while (!heap.empty()) {
+        if (hasTarget && heap.front().key >= targetBound()) break;
+
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Event>());
+        Event e = heap.back();
+        heap.pop_back();
+
+        if (e.id < 0) {
+            uint32_t v = uint32_t(-e.id - 1);
+            if (e.key > dist[v]) continue;   // 过期
+            expandPseudoSource(v);
+        } else {
+            // 入队后顶点距离可能已变短，传播前再截短一次
+            if (trim(windows[e.id])) {
+                ++propagated;
+                propagateWindow(e.id);
+            }
+            release(e.id);
+        }
+    }
+
+    if (hasTarget) finishTarget();
+}
+
+// 回溯：窗口内的点沿指向展开源点的直线穿过窗口所在边，到达父窗口所在三角形，
+// 直到根窗口的伪源点；伪源点再按它自己的最短来源继续
+void GeodesicPropagation::traceFrom(int window, int vertex, const double* point, std::vector<double>& path) const {
+    const GeodesicMesh& m = *mesh;
+    double p[3] = { point[0], point[1], point[2] };
+
+    for (;;) {
+        if (window >= 0) {
+            const Window& w = windows[window];
+            const double* a = m.point(m.from(w.halfedge));
+            const double* b = m.point(m.to(w.halfedge));
+            double px, py;
+            frame(w.halfedge, p, px, py);
+            double x = std::min(std::max(crossAxis(w.sx, w.sy, px, py), w.b0), w.b1);
+            double t = x / m.length[w.halfedge];
+            for (int k = 0; k < 3; ++k) {
+                p[k] = a[k] + (b[k] - a[k]) * t;
+            }
+            path.insert(path.end(), p, p + 3);
+
+            if (w.parent >= 0) {
+                window = w.parent;
+                continue;
+            }
+            if (w.pseudoSource < 0) break;
+            vertex = w.pseudoSource;
+            window = -1;
+            const double* q = m.point(vertex);
+            std::copy(q, q + 3, p);
+            path.insert(path.end(), p, p + 3);
+        }
+
+        if (vertex < 0 || vertex == source.vertex) break;
+        const VertexSource& s = vertexSource[vertex];
+        if (s.window >= 0) {
+            window = s.window;
+        } else if (s.vertex >= 0) {
+            vertex = s.vertex;
+            const double* q = m.point(vertex);
+            std::copy(q, q + 3, p);
+            path.insert(path.end(), p, p + 3);
+        } else {
+            break;
+        }
+    }
+
+    // 三角形内的源点是路径的最后一段
+    if (source.vertex < 0) {
+        path.insert(path.end(), source.position, source.position + 3);
+    }
+}
+
+namespace {
+
+// 回溯得到的是终点到起点的顺序，按点翻转
+void reversePoints(std::vector<double>& path) {
+    const size_t n = path.size() / 3;
+    for (size_t i = 0; i < n / 2; ++i) {
+        std::swap_ranges(path.begin() + i * 3, path.begin() + i * 3 + 3, path.begin() + (n - 1 - i) * 3);
+    }
+}
+
+}
+
+std::vector<double> GeodesicPropagation::tracePath(uint32_t v) const {
+    std::vector<double> path;
+    if (!mesh || v >= dist.size() || dist[v] == Infinity) return path;
+
+    const double* p = mesh->point(v);
+    path.insert(path.end(), p, p + 3);
+    traceFrom(-1, int(v), p, path);
+    reversePoints(path);
+    return path;
+}
+
+std::vector<double> GeodesicPropagation::tracePath() const {
+    if (!hasTarget) return {};
+    if (target.vertex >= 0) return tracePath(uint32_t(target.vertex));
+
+    std::vector<double> path;
+    if (targetBest == Infinity) return path;
+    path.insert(path.end(), target.position, target.position + 3);
+    if (targetCorner == -1) {
+        traceFrom(targetWindow, -1, target.position, path);
+    } else if (targetCorner >= 0) {
+        const double* p = mesh->point(targetCorner);
+        path.insert(path.end(), p, p + 3);
+        traceFrom(-1, targetCorner, p, path);
+    } else {
+        path.insert(path.end(), source.position, source.position + 3);
+    }
+    reversePoints(path);
+    return path;
+}
@@ -0,0 +1,141 @@
+// exact_geodesic.h
+#ifndef EXACT_GEODESIC_H
+#define EXACT_GEODESIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 精确离散测地线：Improved Chen–Han窗口传播（Xin & Wang 2009）
+// 窗口是边上的一段区间及其展开到该边所在平面的（伪）源点，窗口跨过相邻三角形传播，
+// 只能经过鞍点或边界顶点（伪源点）转折。与MMP不同，ICH不在边上保存窗口列表，
+// 只用顶点距离过滤无用窗口，并对每个角应用"一角一分裂"规则，
+// 窗口按最小距离从优先队列中取出。路径可穿过面内部，源点和目标点可在曲面任意位置。
+
+// 三角网格的静态部分：半边连接关系、边长和伪源点标记，几何不变时可在多次查询之间共享
+class GeodesicMesh
+{
+public:
+    static constexpr uint32_t Invalid = 0xffffffffu;
+
+    // points为连续存放的xyz，triangles每3个一组
+    void build(const double* points, size_t vertexCount, const std::vector<unsigned int>& triangles);
+    void clear();
+
+    bool empty() const { return halfedgeTo.empty(); }
+    size_t vertexCount() const { return positions.size() / 3; }
+    size_t triangleCount() const { return halfedgeTo.size() / 3; }
+
+    // 半边3t+i从三角形t的第i个角指向第i+1个角
+    static uint32_t next(uint32_t h) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static uint32_t prev(uint32_t h) { return h % 3 == 0 ? h + 2 : h - 1; }
+    uint32_t from(uint32_t h) const { return halfedgeTo[prev(h)]; }
+    uint32_t to(uint32_t h) const { return halfedgeTo[h]; }
+    const double* point(uint32_t v) const { return positions.data() + size_t(v) * 3; }
+
+    std::vector<double> positions;
+    std::vector<uint32_t> halfedgeTo;
+    std::vector<uint32_t> opposite;          // 边界边或非流形边为Invalid
+    std::vector<double> length;              // 每条半边的长度
+    std::vector<uint32_t> outgoingOffsets;   // CSR：从每个顶点出发的半边
+    std::vector<uint32_t> outgoing;
+    std::vector<char> pseudoSource;          // 鞍点（角度和>=2π）或边界顶点，测地线可在此转折
+    double epsilon = 0.0;                    // 与平均边长成比例的数值容差
+};
+
+// 曲面上的点：网格顶点，或三角形内（含边上）的任意点
+struct SurfacePoint {
+    int vertex = -1;
+    int triangle = -1;
+    double position[3] = { 0, 0, 0 };
+
+    static SurfacePoint atVertex(int v) {
+        SurfacePoint p;
+        p.vertex = v;
+        return p;
+    }
+    static SurfacePoint inTriangle(int t, const double* pos) {
+        SurfacePoint p;
+        p.triangle = t;
+        p.position[0] = pos[0];
+        p.position[1] = pos[1];
+        p.position[2] = pos[2];
+        return p;
+    }
+};
+
+// 一次测地线查询的状态。窗口存放在池中，以引用计数回收：
+// 子窗口、以它为最短来源的顶点和队列各持有一份引用，不再被引用的窗口立即放回空闲链表，
+// 内存只与仍可能用于回溯的窗口数成正比；池在查询之间复用
+class GeodesicPropagation
+{
+public:
+    // 从source传播；给定target时在其距离确定后提前停止，否则计算所有顶点的距离
+    void propagate(const GeodesicMesh& mesh, const SurfacePoint& source, const SurfacePoint* target = nullptr);
+
+    double distance(uint32_t v) const { return dist[v]; }
+    double targetDistance() const { return targetBest; }
+
+    // 从源点到目标（或顶点v）的测地折线，xyz连续存放；不可达时为空
+    std::vector<double> tracePath() const;
+    std::vector<double> tracePath(uint32_t v) const;
+
+    size_t propagatedWindows() const { return propagated; }
+    size_t peakWindows() const { return peakLive; }
+
+private:
+    struct Window {
+        uint32_t halfedge;   // 窗口所在半边，向该半边所在的三角形传播
+        double b0, b1;       // 区间端点，从半边起点量起
+        double sx, sy;       // 半边局部坐标系下的展开源点，sy <= 0（位于半边三角形的另一侧）
+        double d0;           // 源点本身的测地距离
+        int parent;          // 传播出本窗口的父窗口，-1表示直接由伪源点产生
+        int pseudoSource;    // 父链根部的伪源点顶点，-1表示查询源点本身
+        int refs;
+    };
+    // 顶点当前最短距离的来源：窗口，或沿边从伪源点到达（vertex=-2为直接连到三角形内的源点）
+    struct VertexSource {
+        int window = -1;
+        int vertex = -1;
+    };
+    struct Event {
+        double key;
+        int id;              // >=0为窗口，否则为顶点-(id+1)
+        bool operator>(const Event& other) const { return key > other.key; }
+    };
+
+    void reset(const GeodesicMesh& mesh);
+    void resolve(SurfacePoint& p) const;
+    void frame(uint32_t h, const double* p, double& x, double& y) const;
+    void updateVertex(uint32_t v, double d, VertexSource source);
+    void expandPseudoSource(uint32_t v);
+    void propagateWindow(int id);
+    void createWindow(uint32_t h, double b0, double b1, double sx, double sy, double d0, int parent, int pseudo);
+    bool trim(Window& w) const;
+    void release(int id);
+    double targetBound() const;
+    void finishTarget();
+    void traceFrom(int window, int vertex, const double* point, std::vector<double>& path) const;
+
+    const GeodesicMesh* mesh = nullptr;
+    std::vector<double> dist;
+    std::vector<VertexSource> vertexSource;
+    std::vector<double> splitDist;   // 每个角（以对边半边索引）目前经过它的最短距离
+    std::vector<double> splitX;      // 以及该最短路径与对边交点的位置
+    std::vector<Window> windows;
+    std::vector<int> freeWindows;
+    std::vector<Event> heap;
+    size_t liveWindows = 0;
+    size_t peakLive = 0;
+    size_t propagated = 0;
+
+    SurfacePoint source;
+    SurfacePoint target;
+    bool hasTarget = false;
+    double targetBest = 0.0;
+    int targetWindow = -1;           // 经窗口到达三角形内目标点的最优窗口
+    double targetWindowDist = 0.0;
+    int targetCorner = -1;           // 最优路径经过的目标三角形顶点；-2为与源点同一三角形直达
+};
+
+#endif // EXACT_GEODESIC_H
@@ -0,0 +1,448 @@
+// fast_marching.cpp
+#include "fast_marching.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const uint32_t Invalid = GeodesicMesh::Invalid;
+const int MaxUnfoldSteps = 16;   // 钝角展开的最大深度，超出时放弃分裂，只用边更新
+
+// 已知P、Q（x为原点的展开坐标）以及|PW|、|QW|，把W放到直线PQ远离原点的一侧
+void unfold(double px, double py, double qx, double qy, double dp, double dq, double& wx, double& wy) {
+    double ex = qx - px, ey = qy - py;
+    double c = std::sqrt(ex * ex + ey * ey);
+    ex /= c;
+    ey /= c;
+    double nx = -ey, ny = ex;
+    if (nx * -px + ny * -py > 0.0) {
+        nx = -nx;
+        ny = -ny;
+    }
+    double s = (dp * dp - dq * dq + c * c) / (2.0 * c);
+    double h = std::sqrt(std::max(0.0, dp * dp - s * s));
+    wx = px + s * ex + h * nx;
+    wy = py + s * ey + h * ny;
+}
+
+// 平面波前更新：P、Q为已确定顶点的展开坐标（x在原点），距离dp、dq。
+// 虚拟源点S满足|SP| = dp、|SQ| = dq且位于PQ远离x的一侧；只有当S到x的直线穿过线段PQ、
+// 且结果不小于dp、dq（因果性）时才有效，否则返回无穷大，由调用者退回到沿边更新
+double planarUpdate(double px, double py, double dp, double qx, double qy, double dq) {
+    double ex = qx - px, ey = qy - py;
+    double c = std::sqrt(ex * ex + ey * ey);
+    if (c <= 0.0) return FastMarching::Infinity;
+    ex /= c;
+    ey /= c;
+    double nx = -ey, ny = ex;
+    // x相对P的局部坐标：沿边xs，法向xh（法向取远离x的方向，因此xh <= 0）
+    double xs = -px * ex - py * ey;
+    double xh = -px * nx - py * ny;
+    if (xh > 0.0) {
+        nx = -nx;
+        ny = -ny;
+        xh = -xh;
+    }
+
+    double s = (dp * dp - dq * dq + c * c) / (2.0 * c);
+    double h2 = dp * dp - s * s;
+    if (h2 < 0.0) return FastMarching::Infinity;
+    double h = std::sqrt(h2);
+    if (h - xh <= 0.0) return FastMarching::Infinity;
+
+    double crossing = s + (xs - s) * h / (h - xh);
+    if (crossing < 0.0 || crossing > c) return FastMarching::Infinity;
+
+    double sx = px + s * ex + h * nx;
+    double sy = py + s * ey + h * ny;
+    double d = std::sqrt(sx * sx + sy * sy);
+    return d >= std::max(dp, dq) ? d : FastMarching::Infinity;
+}
+
+}
+
+void FastMarching::clear() {
+    mesh = nullptr;
+    corners.clear();
+    obtuseCorners = 0;
+    dist.clear();
+    label.clear();
+    alive.clear();
+    heap.clear();
+    heapIndex.clear();
+    accepted = 0;
+}
+
+void FastMarching::build(const GeodesicMesh& geodesicMesh) {
+    clear();
+    if (geodesicMesh.empty()) return;
+    mesh = &geodesicMesh;
+
+    const size_t halfedgeCount = mesh->halfedgeTo.size();
+    corners.resize(halfedgeCount);
+    for (uint32_t h = 0; h < halfedgeCount; ++h) {
+        Corner& corner = corners[h];
+        const double a = mesh->length[h];
+        const double b = mesh->length[GeodesicMesh::prev(h)];
+        const double c = mesh->length[GeodesicMesh::next(h)];
+        corner.ax = a;
+        corner.bx = a > 0.0 ? (a * a + b * b - c * c) / (2.0 * a) : 0.0;
+        corner.by = std::sqrt(std::max(0.0, b * b - corner.bx * corner.bx));
+        corner.wx = corner.wy = 0.0;
+        corner.split = Invalid;
+        // 直角不需要分裂，留出浮点误差的余量
+        if (corner.bx >= -1e-9 * a) continue;
+
+        // 钝角：跨过对边逐个展开相邻三角形。g从Q指向P，P是两端中更靠近A一侧的顶点
+        ++obtuseCorners;
+        uint32_t g = mesh->opposite[GeodesicMesh::next(h)];
+        double px = corner.ax, py = 0.0, qx = corner.bx, qy = corner.by;
+        for (int step = 0; step < MaxUnfoldSteps && g != Invalid; ++step) {
+            double wx, wy;
+            unfold(px, py, qx, qy, mesh->length[GeodesicMesh::next(g)], mesh->length[GeodesicMesh::prev(g)], wx, wy);
+            // 锐角区：与xA、xB的夹角都不超过90°
+            bool pastA = wx * corner.ax <= 0.0;
+            bool pastB = wx * corner.bx + wy * corner.by <= 0.0;
+            if (!pastA && !pastB) {
+                corner.split = mesh->to(GeodesicMesh::next(g));
+                corner.wx = wx;
+                corner.wy = wy;
+                break;
+            }
+            if (pastA) {
+                // W偏向B一侧，锐角区在P与W之间
+                g = mesh->opposite[GeodesicMesh::next(g)];
+                qx = wx;
+                qy = wy;
+            } else {
+                g = mesh->opposite[GeodesicMesh::prev(g)];
+                px = wx;
+                py = wy;
+            }
+        }
+    }
+}
+
+void FastMarching::heapPush(uint32_t v, double key) {
+    if (heapIndex[v] == Invalid) {
+        heapIndex[v] = static_cast<uint32_t>(heap.size());
+        heap.push_back({ key, v });
+    } else {
+        heap[heapIndex[v]].key = key;
+    }
+    siftUp(heapIndex[v]);
+}
+
+uint32_t FastMarching::heapPop() {
+    uint32_t top = heap.front().vertex;
+    heapIndex[top] = Invalid;
+    heap.front() = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heapIndex[heap.front().vertex] = 0;
+        siftDown(0);
+    }
+    return top;
+}
+
+void FastMarching::siftUp(size_t i) {
+    HeapEntry entry = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 4;
+        if (heap[parent].key <= entry.key) break;
+        heap[i] = heap[parent];
+        heapIndex[heap[i].vertex] = static_cast<uint32_t>(i);
+        i = parent;
+    }
+    heap[i] = entry;
+    heapIndex[entry.vertex] = static_cast<uint32_t>(i);
+}
+
+void FastMarching::siftDown(size_t i) {
+    HeapEntry entry = heap[i];
+    const size_t size = heap.size();
+    while (true) {
+        size_t first = i * 4 + 1;
+        if (first >= size) break;
+        size_t best = first;
+        size_t last = std::min(first + 4, size);
+        for (size_t c = first + 1; c < last; ++c) {
+            if (heap[c].key < heap[best].key) best = c;
+        }
+        if (heap[best].key >= entry.key) break;
+        heap[i] = heap[best];
+        heapIndex[heap[i].vertex] = static_cast<uint32_t>(i);
+        i = best;
+    }
+    heap[i] = entry;
+    heapIndex[entry.vertex] = static_cast<uint32_t>(i);
+}
+
+// 用角corner（起点为x）所在的三角形更新x，A、B中至少一个已确定
+void FastMarching::updateVertex(uint32_t x, uint32_t cornerIndex) {
+    const Corner& corner = corners[cornerIndex];
+    const uint32_t a = mesh->to(cornerIndex);
+    const uint32_t b = mesh->to(GeodesicMesh::next(cornerIndex));
+
+    double best = dist[x];
+    int bestLabel = -1;
+    auto consider = [&](double d, uint32_t from) {
+        if (d < best) {
+            best = d;
+            bestLabel = label[from];
+        }
+    };
+
+    if (alive[a]) consider(dist[a] + corner.ax, a);
+    if (alive[b]) consider(dist[b] + mesh->length[GeodesicMesh::prev(cornerIndex)], b);
+    if (alive[a] && alive[b]) {
+        const uint32_t nearer = dist[a] <= dist[b] ? a : b;
+        if (corner.split != Invalid && alive[corner.split]) {
+            const uint32_t w = corner.split;
+            const double dw = dist[w];
+            consider(dw + std::sqrt(corner.wx * corner.wx + corner.wy * corner.wy), w);
+            consider(planarUpdate(corner.ax, 0.0, dist[a], corner.wx, corner.wy, dw), dist[a] <= dw ? a : w);
+            consider(planarUpdate(corner.wx, corner.wy, dw, corner.bx, corner.by, dist[b]), dw <= dist[b] ? w : b);
+        } else {
+            consider(planarUpdate(corner.ax, 0.0, dist[a], corner.bx, corner.by, dist[b]), nearer);
+        }
+    }
+
+    if (bestLabel >= 0) {
+        dist[x] = best;
+        label[x] = bestLabel;
+        heapPush(x, best);
+    }
+}
+
+void FastMarching::propagate(const std::vector<unsigned int>& sources, double maxDistance) {
+    if (!mesh) return;
+    const size_t vertexCount = mesh->vertexCount();
+    dist.assign(vertexCount, Infinity);
+    label.assign(vertexCount, -1);
+    alive.assign(vertexCount, 0);
+    heapIndex.assign(vertexCount, Invalid);
+    heap.clear();
+    accepted = 0;
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        uint32_t s = sources[i];
+        if (s >= vertexCount || dist[s] == 0.0) continue;
+        dist[s] = 0.0;
+        label[s] = static_cast<int>(i);
+        heapPush(s, 0.0);
+    }
+
+    while (!heap.empty()) {
+        if (heap.front().key > maxDistance) break;
+        const uint32_t v = heapPop();
+        alive[v] = 1;
+        ++accepted;
+
+        // v所在的每个三角形(v, a, c)：a由角next(h)更新，c由角prev(h)更新
+        for (uint32_t i = mesh->outgoingOffsets[v]; i < mesh->outgoingOffsets[v + 1]; ++i) {
+            const uint32_t h = mesh->outgoing[i];
+            const uint32_t a = mesh->to(h);
+            const uint32_t c = mesh->to(GeodesicMesh::next(h));
+            if (!alive[a]) updateVertex(a, GeodesicMesh::next(h));
+            if (!alive[c]) updateVertex(c, GeodesicMesh::prev(h));
+        }
+    }
+
+    // 提前停止时窄带中剩下的是暂定值，按未到达处理
+    for (const HeapEntry& entry : heap) {
+        dist[entry.vertex] = Infinity;
+        label[entry.vertex] = -1;
+        heapIndex[entry.vertex] = Invalid;
+    }
+    heap.clear();
+}
+
+namespace {
+
+void sub3(const double* a, const double* b, double* out) {
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+double dot3(const double* a, const double* b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void cross3(const double* a, const double* b, double* out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// 三角形t内场的下降方向，以及沿该方向各重心坐标的变化率delta[i]
+bool descentInTriangle(const GeodesicMesh& mesh, const std::vector<double>& field, uint32_t t,
+                       double* direction, double* delta) {
+    const double* p[3];
+    double f[3];
+    for (int i = 0; i < 3; ++i) {
+        uint32_t v = mesh.from(t * 3 + i);
+        p[i] = mesh.point(v);
+        f[i] = field[v];
+    }
+    if (!std::isfinite(f[0]) || !std::isfinite(f[1]) || !std::isfinite(f[2])) return false;
+
+    double e1[3], e2[3], n[3];
+    sub3(p[1], p[0], e1);
+    sub3(p[2], p[0], e2);
+    cross3(e1, e2, n);
+    double n2 = dot3(n, n);
+    if (n2 <= 0.0) return false;
+
+    // 重心坐标的梯度：∇λ_i = n × e_i / |n|²，e_i为角i的对边
+    double gradLambda[3][3];
+    double grad[3] = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < 3; ++i) {
+        double e[3];
+        sub3(p[(i + 2) % 3], p[(i + 1) % 3], e);
+        cross3(n, e, gradLambda[i]);
+        for (int c = 0; c < 3; ++c) {
+            gradLambda[i][c] /= n2;
+            grad[c] += f[i] * gradLambda[i][c];
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        direction[c] = -grad[c];
+    }
+    for (int i = 0; i < 3; ++i) {
+        delta[i] = dot3(gradLambda[i], direction);
+    }
+    return dot3(direction, direction) > 0.0;
+}
+
+void appendPoint(std::vector<double>& path, const double* p) {
+    path.insert(path.end(), p, p + 3);
+}
+
+}
+
+std::vector<double> traceGradientDescent(const GeodesicMesh& mesh, const std::vector<double>& field, uint32_t start) {
+    std::vector<double> path;
+    if (mesh.empty() || start >= mesh.vertexCount() || !std::isfinite(field[start])) return path;
+
+    const double snap = 1e-9;
+    // 当前位置：顶点vertex，或半边edge上从起点量起的参数s
+    uint32_t vertex = start;
+    uint32_t edge = Invalid;
+    double s = 0.0;
+    uint32_t fromTriangle = Invalid;   // 到达当前边时所在的三角形
+    appendPoint(path, mesh.point(start));
+
+    const size_t maxSteps = mesh.triangleCount() * 2 + 16;
+    for (size_t step = 0; step < maxSteps; ++step) {
+        if (edge == Invalid) {
+            if (field[vertex] <= 0.0) break;
+
+            // 在顶点处比较各相邻三角形内部方向与各条边的下降速率，取最陡者
+            double bestRate = 0.0;
+            uint32_t bestTriangle = Invalid;
+            uint32_t bestCorner = 0;
+            double bestDelta[3] = { 0.0, 0.0, 0.0 };
+            uint32_t bestNeighbor = Invalid;
+            for (uint32_t i = mesh.outgoingOffsets[vertex]; i < mesh.outgoingOffsets[vertex + 1]; ++i) {
+                const uint32_t h = mesh.outgoing[i];
+                const uint32_t t = h / 3, c = h % 3;
+                double direction[3], delta[3];
+                if (descentInTriangle(mesh, field, t, direction, delta) &&
+                    delta[(c + 1) % 3] >= 0.0 && delta[(c + 2) % 3] >= 0.0 && delta[c] < 0.0) {
+                    double rate = std::sqrt(dot3(direction, direction));
+                    if (rate > bestRate) {
+                        bestRate = rate;
+                        bestTriangle = t;
+                        bestCorner = c;
+                        std::copy(delta, delta + 3, bestDelta);
+                        bestNeighbor = Invalid;
+                    }
+                }
+                const uint32_t neighbors[2] = { mesh.to(h), mesh.from(GeodesicMesh::prev(h)) };
+                const double lengths[2] = { mesh.length[h], mesh.length[GeodesicMesh::prev(h)] };
+                for (int k = 0; k < 2; ++k) {
+                    if (lengths[k] <= 0.0 || !std::isfinite(field[neighbors[k]])) continue;
+                    double rate = (field[vertex] - field[neighbors[k]]) / lengths[k];
+                    if (rate > bestRate) {
+                        bestRate = rate;
+                        bestTriangle = Invalid;
+                        bestNeighbor = neighbors[k];
+                    }
+                }
+            }
+
+            if (bestNeighbor != Invalid) {
+                vertex = bestNeighbor;
+                appendPoint(path, mesh.point(vertex));
+                continue;
+            }
+            if (bestTriangle == Invalid) break;
+
+            // 从角bestCorner沿下降方向走到对边（λ_c降到0）
+            const uint32_t c = bestCorner;
+            const double sigma = -1.0 / bestDelta[c];
+            const double lambdaEnd = sigma * bestDelta[(c + 2) % 3];
+            edge = bestTriangle * 3 + (c + 1) % 3;
+            s = std::min(1.0, std::max(0.0, lambdaEnd));
+            fromTriangle = bestTriangle;
+        } else {
+            // 在边上：进入边另一侧的三角形，若下降方向不指向其内部则沿边滑向较低的端点
+            const uint32_t across = edge / 3 == fromTriangle ? mesh.opposite[edge] : edge;
+            bool moved = false;
+            if (across != Invalid) {
+                const uint32_t t = across / 3;
+                const uint32_t j = across % 3, j1 = (j + 1) % 3, i = (j + 2) % 3;
+                const double param = across == edge ? s : 1.0 - s;
+                double lambda[3];
+                lambda[j] = 1.0 - param;
+                lambda[j1] = param;
+                lambda[i] = 0.0;
+                double direction[3], delta[3];
+                if (descentInTriangle(mesh, field, t, direction, delta) && delta[i] > 0.0) {
+                    // 走到λ_j或λ_j1先降为0的那条边
+                    double sigma = FastMarching::Infinity;
+                    uint32_t exitCorner = i;
+                    for (uint32_t m : { j, j1 }) {
+                        if (delta[m] < 0.0 && -lambda[m] / delta[m] < sigma) {
+                            sigma = -lambda[m] / delta[m];
+                            exitCorner = m;
+                        }
+                    }
+                    if (exitCorner != i) {
+                        for (int k = 0; k < 3; ++k) {
+                            lambda[k] = std::max(0.0, lambda[k] + sigma * delta[k]);
+                        }
+                        lambda[exitCorner] = 0.0;
+                        edge = t * 3 + (exitCorner + 1) % 3;
+                        s = lambda[(exitCorner + 2) % 3] / std::max(snap, lambda[(exitCorner + 1) % 3] +
+                                                                         lambda[(exitCorner + 2) % 3]);
+                        fromTriangle = t;
+                        moved = true;
+                    }
+                }
+            }
+            if (!moved) {
+                const uint32_t a = mesh.from(edge), b = mesh.to(edge);
+                edge = Invalid;
+                vertex = field[a] <= field[b] ? a : b;
+                appendPoint(path, mesh.point(vertex));
+                continue;
+            }
+        }
+
+        // 落在顶点附近时吸附到顶点，否则记录边上的点
+        if (s <= snap || s >= 1.0 - snap) {
+            vertex = s <= snap ? mesh.from(edge) : mesh.to(edge);
+            edge = Invalid;
+            appendPoint(path, mesh.point(vertex));
+        } else {
+            const double* a = mesh.point(mesh.from(edge));
+            const double* b = mesh.point(mesh.to(edge));
+            double p[3] = { a[0] + (b[0] - a[0]) * s, a[1] + (b[1] - a[1]) * s, a[2] + (b[2] - a[2]) * s };
+            appendPoint(path, p);
+        }
+    }
+    return path;
+}
@@ -0,0 +1,76 @@
+// fast_marching.h
+#ifndef FAST_MARCHING_H
+#define FAST_MARCHING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "exact_geodesic.h"
+
+// 三角网格上的快速行进法（Kimmel & Sethian 1998），不需要解线性方程组，
+// 内存只与网格大小成线性，适合无法做矩阵分解的大网格。
+// 每个顶点由相邻三角形中两个已确定的顶点按平面波前更新；钝角处沿对边向外展开相邻三角形，
+// 直到找到落在锐角区内的顶点，用它把钝角分成两个虚拟锐角三角形，避免钝角造成的因果性破坏。
+// 窄带（试探顶点）放在带位置索引的4叉堆中，堆项内联键值，支持原地减小键值；
+// 邻接直接遍历GeodesicMesh的出半边CSR。
+class FastMarching
+{
+public:
+    static constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+    // 预计算每个角的展开坐标和钝角的分裂顶点，mesh需在本对象使用期间保持有效
+    void build(const GeodesicMesh& mesh);
+    void clear();
+
+    bool empty() const { return corners.empty(); }
+    size_t obtuseCornerCount() const { return obtuseCorners; }
+
+    // 从一个或多个源点推进；距离超过maxDistance后停止，未到达的顶点为无穷大
+    void propagate(const std::vector<unsigned int>& sources, double maxDistance = Infinity);
+
+    double distance(uint32_t v) const { return dist[v]; }
+    const std::vector<double>& distances() const { return dist; }
+    // 最近源点在sources中的序号（测地Voronoi划分），未到达为-1
+    int nearestSource(uint32_t v) const { return label[v]; }
+    size_t acceptedCount() const { return accepted; }
+
+private:
+    // 以半边h的起点x为原点、h方向为x轴的展开坐标：A = to(h) = (ax, 0)，B = to(next(h)) = (bx, by)，by > 0。
+    // 钝角时split为展开后落在锐角区内的顶点W及其坐标，否则为Invalid
+    struct Corner {
+        double ax;
+        double bx, by;
+        double wx, wy;
+        uint32_t split;
+    };
+
+    // 窄带：带位置索引的4叉最小堆
+    struct HeapEntry {
+        double key;
+        uint32_t vertex;
+    };
+
+    void updateVertex(uint32_t x, uint32_t corner);
+    void heapPush(uint32_t v, double key);
+    uint32_t heapPop();
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+    const GeodesicMesh* mesh = nullptr;
+    std::vector<Corner> corners;
+    size_t obtuseCorners = 0;
+
+    std::vector<double> dist;
+    std::vector<int> label;
+    std::vector<char> alive;
+    std::vector<HeapEntry> heap;
+    std::vector<uint32_t> heapIndex;   // 顶点在堆中的位置，不在堆中为Invalid
+    size_t accepted = 0;
+};
+
+// 沿逐顶点标量场（距离场）的最速下降方向从顶点v走到极小点（源点），路径可穿过面内部；
+// 场在每个三角形内线性插值。返回xyz连续存放的折线
+std::vector<double> traceGradientDescent(const GeodesicMesh& mesh, const std::vector<double>& field, uint32_t v);
+
+#endif // FAST_MARCHING_H
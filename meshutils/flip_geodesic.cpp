@@ -0,0 +1,475 @@
+// flip_geodesic.cpp
+#include "flip_geodesic.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 转折点夹角与π比较的容差，避免在几乎笔直处反复翻转
+const double AngleTolerance = 1e-6;
+
+// 边长为a、b的两边夹角，c为对边
+double angleFromLengths(double a, double b, double c) {
+    if (a <= 0.0 || b <= 0.0) return 0.0;
+    return std::acos(std::max(-1.0, std::min(1.0, (a * a + b * b - c * c) / (2.0 * a * b))));
+}
+
+// 底边从(0,0)到(base,0)，第三个顶点到两端的距离为r0、r1，返回它在上半平面的坐标
+void layoutApex(double base, double r0, double r1, double& x, double& y) {
+    x = (r0 * r0 - r1 * r1 + base * base) / (2.0 * base);
+    y = std::sqrt(std::max(0.0, r0 * r0 - x * x));
+}
+
+double cross2(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+// 原网格中半边h在起点处的内角
+double inputCorner(const GeodesicMesh& mesh, uint32_t h) {
+    return angleFromLengths(mesh.length[h], mesh.length[GeodesicMesh::prev(h)], mesh.length[GeodesicMesh::next(h)]);
+}
+
+}
+
+void FlipGeodesic::clear() {
+    geodesicMesh = nullptr;
+    intrinsic.clear();
+    lengths.clear();
+    signposts.clear();
+    inputAngles.clear();
+    angleSums.clear();
+    boundary.clear();
+    flipLog.clear();
+    pathCount.clear();
+}
+
+bool FlipGeodesic::build(const GeodesicMesh& mesh) {
+    clear();
+    if (mesh.empty()) return false;
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.triangleCount();
+
+    // 内蕴副本的面索引与三角形索引一一对应，之后按面对应原网格的半边
+    intrinsic.reserve(vertexCount, triangleCount * 3 / 2 + vertexCount, triangleCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const double* p = mesh.point(static_cast<uint32_t>(v));
+        intrinsic.add_vertex(Mesh::Point(p[0], p[1], p[2]));
+    }
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        Mesh::FaceHandle fh = intrinsic.add_face(Mesh::VertexHandle(mesh.from(3 * t)),
+                                                 Mesh::VertexHandle(mesh.from(3 * t + 1)),
+                                                 Mesh::VertexHandle(mesh.from(3 * t + 2)));
+        if (!fh.is_valid() || fh.idx() != static_cast<int>(t)) {
+            intrinsic.clear();
+            return false;
+        }
+    }
+
+    // 原网格上每个顶点从最顺时针的出半边（边界顶点）或任意出半边开始，逆时针累加内角
+    inputAngles.assign(mesh.halfedgeTo.size(), 0.0);
+    angleSums.assign(vertexCount, 0.0);
+    boundary.assign(vertexCount, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        const uint32_t begin = mesh.outgoingOffsets[v], end = mesh.outgoingOffsets[v + 1];
+        if (begin == end) continue;
+        uint32_t start = mesh.outgoing[begin];
+        for (uint32_t i = begin; i < end; ++i) {
+            if (mesh.opposite[mesh.outgoing[i]] == GeodesicMesh::Invalid) {
+                start = mesh.outgoing[i];
+                boundary[v] = 1;
+                break;
+            }
+        }
+        double angle = 0.0;
+        uint32_t h = start;
+        for (uint32_t count = begin; count < end; ++count) {
+            inputAngles[h] = angle;
+            angle += inputCorner(mesh, h);
+            h = mesh.opposite[GeodesicMesh::prev(h)];
+            if (h == GeodesicMesh::Invalid || h == start) break;
+        }
+        angleSums[v] = angle;
+    }
+
+    lengths.resize(intrinsic.n_edges());
+    for (size_t e = 0; e < intrinsic.n_edges(); ++e) {
+        Mesh::HalfedgeHandle h = intrinsic.halfedge_handle(Mesh::EdgeHandle(static_cast<int>(e)), 0);
+        lengths[e] = (intrinsic.point(intrinsic.to_vertex_handle(h)) -
+                      intrinsic.point(intrinsic.from_vertex_handle(h))).norm();
+    }
+
+    // 面内的半边直接取原网格的方向角，边界半边（无面）由相邻的面内半边推出
+    signposts.assign(intrinsic.n_halfedges(), 0.0);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        Mesh::HalfedgeHandle h = intrinsic.halfedge_handle(Mesh::FaceHandle(static_cast<int>(t)));
+        for (int k = 0; k < 3; ++k, h = intrinsic.next_halfedge_handle(h)) {
+            const uint32_t from = intrinsic.from_vertex_handle(h).idx();
+            for (uint32_t i = 0; i < 3; ++i) {
+                if (mesh.from(3 * t + i) == from) signposts[h.idx()] = inputAngles[3 * t + i];
+            }
+        }
+    }
+    for (size_t i = 0; i < intrinsic.n_halfedges(); ++i) {
+        Mesh::HalfedgeHandle h(static_cast<int>(i));
+        if (intrinsic.is_boundary(h)) updateSignpost(h);
+    }
+
+    pathCount.assign(vertexCount, 0);
+    geodesicMesh = &mesh;
+    return true;
+}
+
+// 内蕴半边h在起点处的内角
+double FlipGeodesic::cornerAngle(Mesh::HalfedgeHandle h) const {
+    return angleFromLengths(edgeLength(h), edgeLength(intrinsic.prev_halfedge_handle(h)),
+                            edgeLength(intrinsic.next_halfedge_handle(h)));
+}
+
+// 绕起点逆时针：面内出半边g的下一条出半边是opposite(prev(g))，方向角多出g处的内角。
+// h的对边所在面中，从同一顶点出发的另一条半边即是h顺时针方向的邻居
+void FlipGeodesic::updateSignpost(Mesh::HalfedgeHandle h) {
+    const int v = intrinsic.from_vertex_handle(h).idx();
+    Mesh::HalfedgeHandle g = intrinsic.next_halfedge_handle(intrinsic.opposite_halfedge_handle(h));
+    double angle = signposts[g.idx()] + cornerAngle(g);
+    if (!boundary[v] && angleSums[v] > 0.0) angle = std::fmod(angle, angleSums[v]);
+    signposts[h.idx()] = angle;
+}
+
+// 翻转h所在的边，新边长由相邻两个三角形展开成的四边形得到；连接关系先记入日志
+bool FlipGeodesic::flipEdge(Mesh::HalfedgeHandle h) {
+    Mesh::EdgeHandle eh = intrinsic.edge_handle(h);
+    if (!is_flip_ok_openmesh(eh, intrinsic)) return false;
+
+    Mesh::HalfedgeHandle a0 = intrinsic.halfedge_handle(eh, 0);
+    Mesh::HalfedgeHandle b0 = intrinsic.halfedge_handle(eh, 1);
+    Mesh::HalfedgeHandle a1 = intrinsic.next_halfedge_handle(a0), a2 = intrinsic.next_halfedge_handle(a1);
+    Mesh::HalfedgeHandle b1 = intrinsic.next_halfedge_handle(b0), b2 = intrinsic.next_halfedge_handle(b1);
+
+    // a0从vb0指向va0；va1在a0左侧，vb1在右侧
+    const double base = lengths[eh.idx()];
+    double xa, ya, xb, yb;
+    layoutApex(base, edgeLength(a2), edgeLength(a1), xa, ya);
+    layoutApex(base, edgeLength(b1), edgeLength(b2), xb, yb);
+    const double flippedLength = std::hypot(xa - xb, ya + yb);
+
+    FlipRecord record;
+    record.edge = eh.idx();
+    const Mesh::HalfedgeHandle halfedges[6] = { a0, a1, a2, b0, b1, b2 };
+    for (int k = 0; k < 6; ++k) {
+        record.halfedges[k] = halfedges[k].idx();
+        record.halfedgeTo[k] = intrinsic.to_vertex_handle(halfedges[k]).idx();
+        record.halfedgeNext[k] = intrinsic.next_halfedge_handle(halfedges[k]).idx();
+        record.halfedgeFace[k] = intrinsic.face_handle(halfedges[k]).idx();
+    }
+    record.faces[0] = intrinsic.face_handle(a0).idx();
+    record.faces[1] = intrinsic.face_handle(b0).idx();
+    record.faceHalfedge[0] = intrinsic.halfedge_handle(intrinsic.face_handle(a0)).idx();
+    record.faceHalfedge[1] = intrinsic.halfedge_handle(intrinsic.face_handle(b0)).idx();
+    record.vertices[0] = intrinsic.to_vertex_handle(a0).idx();
+    record.vertices[1] = intrinsic.to_vertex_handle(b0).idx();
+    record.vertexHalfedge[0] = intrinsic.halfedge_handle(intrinsic.to_vertex_handle(a0)).idx();
+    record.vertexHalfedge[1] = intrinsic.halfedge_handle(intrinsic.to_vertex_handle(b0)).idx();
+    record.length = base;
+    record.signpost[0] = signposts[a0.idx()];
+    record.signpost[1] = signposts[b0.idx()];
+
+    if (!flip_openmesh(eh, intrinsic)) return false;
+    flipLog.push_back(record);
+    ++flipCount;
+
+    lengths[eh.idx()] = flippedLength;
+    updateSignpost(a0);
+    updateSignpost(b0);
+    return true;
+}
+
+// 逆序撤销日志中的翻转，内蕴网格回到原网格
+void FlipGeodesic::restore() {
+    for (auto it = flipLog.rbegin(); it != flipLog.rend(); ++it) {
+        const FlipRecord& record = *it;
+        for (int k = 0; k < 6; ++k) {
+            Mesh::HalfedgeHandle h(record.halfedges[k]);
+            intrinsic.set_vertex_handle(h, Mesh::VertexHandle(record.halfedgeTo[k]));
+            intrinsic.set_face_handle(h, Mesh::FaceHandle(record.halfedgeFace[k]));
+        }
+        // 设置next时同时更新prev，六条半边全部设置后前后关系一致
+        for (int k = 0; k < 6; ++k) {
+            intrinsic.set_next_halfedge_handle(Mesh::HalfedgeHandle(record.halfedges[k]),
+                                               Mesh::HalfedgeHandle(record.halfedgeNext[k]));
+        }
+        for (int k = 0; k < 2; ++k) {
+            intrinsic.set_halfedge_handle(Mesh::FaceHandle(record.faces[k]), Mesh::HalfedgeHandle(record.faceHalfedge[k]));
+            intrinsic.set_halfedge_handle(Mesh::VertexHandle(record.vertices[k]),
+                                          Mesh::HalfedgeHandle(record.vertexHalfedge[k]));
+        }
+        Mesh::EdgeHandle eh(record.edge);
+        lengths[record.edge] = record.length;
+        signposts[intrinsic.halfedge_handle(eh, 0).idx()] = record.signpost[0];
+        signposts[intrinsic.halfedge_handle(eh, 1).idx()] = record.signpost[1];
+    }
+    flipLog.clear();
+}
+
+bool FlipGeodesic::shorten(const std::vector<unsigned int>& edgePath, std::vector<unsigned int>& vertices,
+                           std::vector<double>& polyline) {
+    vertices.clear();
+    polyline.clear();
+    finalLength = 0.0;
+    flipCount = 0;
+    if (empty() || edgePath.empty()) return false;
+    for (size_t i = 0; i < edgePath.size(); ++i) {
+        if (edgePath[i] >= pathCount.size()) return false;
+        if (i > 0 && !intrinsic.find_halfedge(Mesh::VertexHandle(edgePath[i - 1]),
+                                              Mesh::VertexHandle(edgePath[i])).is_valid()) {
+            return false;
+        }
+    }
+
+    const int count = static_cast<int>(edgePath.size());
+    nodeVertex.assign(edgePath.begin(), edgePath.end());
+    nodePrev.resize(count);
+    nodeNext.resize(count);
+    nodeQueued.assign(count, 0);
+    jointQueue.clear();
+    for (int i = 0; i < count; ++i) {
+        nodePrev[i] = i - 1;
+        nodeNext[i] = i + 1 < count ? i + 1 : -1;
+        ++pathCount[nodeVertex[i]];
+    }
+    for (int i = 1; i + 1 < count; ++i) {
+        jointQueue.push_back(i);
+        nodeQueued[i] = 1;
+    }
+
+    // 每次成功拉直都使路径严格变短，步数上限只防止数值问题导致的循环
+    const size_t maxSteps = 100 * edgePath.size() + 1000;
+    for (size_t step = 0; step < maxSteps && !jointQueue.empty(); ++step) {
+        int node = jointQueue.front();
+        jointQueue.pop_front();
+        nodeQueued[node] = 0;
+        if (nodePrev[node] < 0) continue;   // 已被替换
+        straightenJoint(node);
+    }
+
+    // 首节点不会被替换；沿链表收集顶点，并把每条内蕴边描到原网格上
+    const double* start = geodesicMesh->point(nodeVertex[0]);
+    polyline.insert(polyline.end(), start, start + 3);
+    for (int node = 0; node >= 0; node = nodeNext[node]) {
+        vertices.push_back(nodeVertex[node]);
+        const int next = nodeNext[node];
+        if (next < 0) break;
+        Mesh::HalfedgeHandle h = intrinsic.find_halfedge(Mesh::VertexHandle(nodeVertex[node]),
+                                                         Mesh::VertexHandle(nodeVertex[next]));
+        const double length = edgeLength(h);
+        finalLength += length;
+        traceEdge(nodeVertex[node], signposts[h.idx()], length, nodeVertex[next], polyline);
+    }
+
+    restore();
+    for (uint32_t v : nodeVertex) {
+        pathCount[v] = 0;
+    }
+    return true;
+}
+
+// 在转折点b处，沿夹角小于π的一侧翻转夹角内的边。夹角内的边b-x在x处的两个内角之和小于π时
+// 可以翻转（四边形为凸），翻转后x不再与b相邻。翻转完成后，剩下的扇形外沿a-x1-...-xk-c
+// 比a-b-c短，用它替换b
+bool FlipGeodesic::straightenJoint(int node) {
+    const int prevNode = nodePrev[node], nextNode = nodeNext[node];
+    const uint32_t a = nodeVertex[prevNode], b = nodeVertex[node], c = nodeVertex[nextNode];
+    if (a == c) return false;
+
+    Mesh::HalfedgeHandle ha = intrinsic.find_halfedge(Mesh::VertexHandle(b), Mesh::VertexHandle(a));
+    Mesh::HalfedgeHandle hc = intrinsic.find_halfedge(Mesh::VertexHandle(b), Mesh::VertexHandle(c));
+    if (!ha.is_valid() || !hc.is_valid()) return false;
+
+    // 从b->a逆时针转到b->c的角度ccw，以及另一侧cw；边界顶点上跨过边界的一侧不能拉直
+    const double phiA = signposts[ha.idx()], phiC = signposts[hc.idx()];
+    const double infinity = std::numeric_limits<double>::infinity();
+    double ccw, cw;
+    if (boundary[b]) {
+        ccw = phiC >= phiA ? phiC - phiA : infinity;
+        cw = phiA >= phiC ? phiA - phiC : infinity;
+    } else {
+        ccw = std::fmod(phiC - phiA, angleSums[b]);
+        if (ccw < 0.0) ccw += angleSums[b];
+        cw = angleSums[b] - ccw;
+    }
+    if (std::min(ccw, cw) >= M_PI - AngleTolerance) return false;
+
+    // 夹角内的出半边，按逆时针顺序从start到end
+    const bool reversed = cw < ccw;
+    const Mesh::HalfedgeHandle end = reversed ? ha : hc;
+    std::vector<Mesh::HalfedgeHandle> wedge(1, reversed ? hc : ha);
+    const size_t valence = intrinsic.valence(Mesh::VertexHandle(b));
+    while (wedge.back() != end) {
+        if (intrinsic.is_boundary(wedge.back()) || wedge.size() > valence) return false;
+        wedge.push_back(intrinsic.opposite_halfedge_handle(intrinsic.prev_halfedge_handle(wedge.back())));
+    }
+
+    for (size_t j = 1; j + 1 < wedge.size();) {
+        double angle = cornerAngle(intrinsic.prev_halfedge_handle(wedge[j - 1])) +
+                       cornerAngle(intrinsic.next_halfedge_handle(wedge[j]));
+        if (angle < M_PI - AngleTolerance && flipEdge(wedge[j])) {
+            wedge.erase(wedge.begin() + j);
+            if (j > 1) --j;
+        } else {
+            ++j;
+        }
+    }
+
+    // 部分边因组合限制（新边已存在）无法翻转时，外沿不一定更短，此时保持原路径
+    double newLength = 0.0;
+    for (size_t j = 0; j + 1 < wedge.size(); ++j) {
+        newLength += edgeLength(intrinsic.next_halfedge_handle(wedge[j]));
+    }
+    if (newLength >= (edgeLength(ha) + edgeLength(hc)) * (1.0 - 1e-12)) return false;
+
+    std::vector<uint32_t> chain;
+    for (size_t j = 1; j + 1 < wedge.size(); ++j) {
+        uint32_t x = intrinsic.to_vertex_handle(wedge[j]).idx();
+        if (pathCount[x] > 0) return false;
+        chain.push_back(x);
+    }
+    if (reversed) std::reverse(chain.begin(), chain.end());
+
+    auto enqueue = [this](int n) {
+        if (nodePrev[n] >= 0 && nodeNext[n] >= 0 && !nodeQueued[n]) {
+            jointQueue.push_back(n);
+            nodeQueued[n] = 1;
+        }
+    };
+
+    --pathCount[b];
+    nodePrev[node] = -1;
+    nodeNext[node] = -1;
+    int last = prevNode;
+    for (uint32_t x : chain) {
+        const int n = static_cast<int>(nodeVertex.size());
+        nodeVertex.push_back(x);
+        nodePrev.push_back(last);
+        nodeNext.push_back(-1);
+        nodeQueued.push_back(0);
+        nodeNext[last] = n;
+        ++pathCount[x];
+        last = n;
+    }
+    nodeNext[last] = nextNode;
+    nodePrev[nextNode] = last;
+
+    enqueue(prevNode);
+    for (int n = nodeNext[prevNode]; n != nextNode; n = nodeNext[n]) {
+        enqueue(n);
+    }
+    enqueue(nextNode);
+    return true;
+}
+
+// 从顶点v沿方向角angle在原网格上走length，逐个三角形展开到平面中求与边的交点，
+// 穿过边的位置依次追加到折线，最后以目标顶点结束
+void FlipGeodesic::traceEdge(uint32_t v, double angle, double length, uint32_t target,
+                             std::vector<double>& polyline) const {
+    const GeodesicMesh& mesh = *geodesicMesh;
+    const double* targetPoint = mesh.point(target);
+
+    // 方向所在的角：方向角落在该出半边与逆时针下一条出半边之间
+    uint32_t h = GeodesicMesh::Invalid;
+    double direction = 0.0, bestExcess = std::numeric_limits<double>::infinity();
+    for (uint32_t i = mesh.outgoingOffsets[v]; i < mesh.outgoingOffsets[v + 1]; ++i) {
+        const uint32_t g = mesh.outgoing[i];
+        double relative = angle - inputAngles[g];
+        if (!boundary[v] && angleSums[v] > 0.0) {
+            relative = std::fmod(relative, angleSums[v]);
+            if (relative < 0.0) relative += angleSums[v];
+        }
+        const double corner = inputCorner(mesh, g);
+        const double excess = relative < 0.0 ? -relative : std::max(0.0, relative - corner);
+        if (excess < bestExcess) {
+            bestExcess = excess;
+            h = g;
+            direction = std::min(std::max(relative, 0.0), corner);
+        }
+    }
+    if (h == GeodesicMesh::Invalid) {
+        polyline.insert(polyline.end(), targetPoint, targetPoint + 3);
+        return;
+    }
+
+    // 当前三角形三个角在展开平面中的坐标，v在原点、h沿x轴
+    uint32_t t = h / 3;
+    const uint32_t corner = h % 3;
+    double q[3][2];
+    q[corner][0] = 0.0;
+    q[corner][1] = 0.0;
+    q[(corner + 1) % 3][0] = mesh.length[h];
+    q[(corner + 1) % 3][1] = 0.0;
+    const double apex = inputCorner(mesh, h);
+    q[(corner + 2) % 3][0] = mesh.length[GeodesicMesh::prev(h)] * std::cos(apex);
+    q[(corner + 2) % 3][1] = mesh.length[GeodesicMesh::prev(h)] * std::sin(apex);
+
+    const double dx = std::cos(direction), dy = std::sin(direction);
+    double px = 0.0, py = 0.0;
+    double remaining = length;
+    uint32_t entered = GeodesicMesh::Invalid;
+    const size_t maxSteps = mesh.triangleCount() + 16;
+    for (size_t step = 0; step < maxSteps; ++step) {
+        // 出边：从顶点出发时只能是对边；否则取交点参数最接近边内部的一条，相同时取更远的
+        uint32_t exit = GeodesicMesh::Invalid;
+        double exitS = 0.0, exitU = 0.0, bestViolation = std::numeric_limits<double>::infinity();
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t e = 3 * t + k;
+            if (e == entered) continue;
+            if (entered == GeodesicMesh::Invalid && k != (corner + 1) % 3) continue;
+            const double* qa = q[k];
+            const double* qb = q[(k + 1) % 3];
+            const double ex = qb[0] - qa[0], ey = qb[1] - qa[1];
+            const double denom = cross2(dx, dy, ex, ey);
+            if (std::fabs(denom) < 1e-300) continue;
+            const double wx = qa[0] - px, wy = qa[1] - py;
+            const double s = cross2(wx, wy, ex, ey) / denom;
+            const double u = cross2(wx, wy, dx, dy) / denom;
+            const double violation = std::max(0.0, -u) + std::max(0.0, u - 1.0) + std::max(0.0, -s);
+            if (violation < bestViolation - 1e-12 || (violation <= bestViolation + 1e-12 && s > exitS)) {
+                bestViolation = violation;
+                exit = e;
+                exitS = s;
+                exitU = std::min(1.0, std::max(0.0, u));
+            }
+        }
+        if (exit == GeodesicMesh::Invalid || exitS >= remaining) break;
+
+        const double* pa = mesh.point(mesh.from(exit));
+        const double* pb = mesh.point(mesh.to(exit));
+        for (int c = 0; c < 3; ++c) {
+            polyline.push_back(pa[c] + exitU * (pb[c] - pa[c]));
+        }
+        remaining -= exitS;
+
+        const uint32_t g = mesh.opposite[exit];
+        if (g == GeodesicMesh::Invalid) break;
+        const double* qa = q[exit % 3];
+        const double* qb = q[(exit + 1) % 3];
+        px = qa[0] + exitU * (qb[0] - qa[0]);
+        py = qa[1] + exitU * (qb[1] - qa[1]);
+
+        // 相邻三角形：g从出边终点B指向起点A，第三个角在B->A的左侧
+        const double bx = qb[0], by = qb[1], ax = qa[0], ay = qa[1];
+        const double base = std::hypot(ax - bx, ay - by);
+        if (base <= 0.0) break;
+        const double e1x = (ax - bx) / base, e1y = (ay - by) / base;
+        double x, y;
+        layoutApex(base, mesh.length[GeodesicMesh::prev(g)], mesh.length[GeodesicMesh::next(g)], x, y);
+        const uint32_t k = g % 3;
+        t = g / 3;
+        q[k][0] = bx;
+        q[k][1] = by;
+        q[(k + 1) % 3][0] = ax;
+        q[(k + 1) % 3][1] = ay;
+        q[(k + 2) % 3][0] = bx + x * e1x - y * e1y;
+        q[(k + 2) % 3][1] = by + x * e1y + y * e1x;
+        entered = g;
+    }
+    polyline.insert(polyline.end(), targetPoint, targetPoint + 3);
+}
@@ -0,0 +1,75 @@
+// flip_geodesic.h
+#ifndef FLIP_GEODESIC_H
+#define FLIP_GEODESIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "my_traits.h"
+#include "exact_geodesic.h"
+
+// FlipOut测地线拉直（Sharp & Crane 2020）
+// 在网格的内蕴副本上工作：连接关系是一份OpenMesh网格，几何只由边长决定，翻转边（flip_openmesh）
+// 后按相邻两个三角形展开的四边形重新计算边长，渲染用的网格和顶点位置都不改变。
+// 输入沿网格边的路径，反复找路径上某一侧夹角小于π的转折点，翻转夹角内的边使路径绕过该点，
+// 路径每步严格变短，直到所有转折点两侧都不小于π，即局部最短测地线。
+// 每条半边在起点处保存相对参考方向的角度（signpost），最终的内蕴边据此在原网格上描出穿过面内部的折线。
+// 翻转记录在日志中，查询结束后逆序恢复，代价只与路径附近翻转的边数有关。
+class FlipGeodesic
+{
+public:
+    // 由三角网格构建内蕴副本，mesh需在本对象使用期间保持有效；非流形网格构建失败
+    bool build(const GeodesicMesh& mesh);
+    void clear();
+
+    bool empty() const { return geodesicMesh == nullptr; }
+
+    // 拉直沿网格边的路径（相邻顶点需共边）。vertices为拉直后经过的网格顶点（端点及鞍点/边界转折点），
+    // polyline为穿过面内部的折线（xyz连续存放）。完成后内蕴网格恢复原状，可继续下一次查询
+    bool shorten(const std::vector<unsigned int>& edgePath, std::vector<unsigned int>& vertices,
+                 std::vector<double>& polyline);
+
+    double lastLength() const { return finalLength; }
+    size_t lastFlipCount() const { return flipCount; }
+
+private:
+    // 一次翻转前受影响元素的连接关系，用于逆序恢复
+    struct FlipRecord {
+        int edge;
+        int halfedges[6];
+        int halfedgeTo[6], halfedgeNext[6], halfedgeFace[6];
+        int faces[2], faceHalfedge[2];
+        int vertices[2], vertexHalfedge[2];
+        double length;
+        double signpost[2];
+    };
+
+    double edgeLength(Mesh::HalfedgeHandle h) const { return lengths[intrinsic.edge_handle(h).idx()]; }
+    double cornerAngle(Mesh::HalfedgeHandle h) const;
+    void updateSignpost(Mesh::HalfedgeHandle h);
+    bool flipEdge(Mesh::HalfedgeHandle h);
+    void restore();
+    bool straightenJoint(int node);
+    void traceEdge(uint32_t v, double angle, double length, uint32_t target, std::vector<double>& polyline) const;
+
+    const GeodesicMesh* geodesicMesh = nullptr;
+    Mesh intrinsic;
+    std::vector<double> lengths;         // 内蕴边长，按边索引
+    std::vector<double> signposts;       // 半边在起点处的方向角，按半边索引
+    std::vector<double> inputAngles;     // 原网格半边（3t+i）在起点处的方向角，与signposts同一参考方向
+    std::vector<double> angleSums;       // 顶点的角度和
+    std::vector<char> boundary;
+    std::vector<FlipRecord> flipLog;
+
+    // 路径以双向链表保存，转折点按先进先出队列检查
+    std::vector<uint32_t> nodeVertex;
+    std::vector<int> nodePrev, nodeNext;
+    std::vector<char> nodeQueued;
+    std::deque<int> jointQueue;
+    std::vector<int> pathCount;          // 顶点在路径上出现的次数，避免拉直时路径自交
+    double finalLength = 0.0;
+    size_t flipCount = 0;
+};
+
+#endif // FLIP_GEODESIC_H
@@ -0,0 +1,106 @@
+// geodesic_sampling.cpp
+#include "geodesic_sampling.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <functional>
+
+void FarthestPointSampler::reset(const MeshGraph& meshGraph) {
+    graph = &meshGraph;
+    const size_t vertexCount = meshGraph.vertexCount();
+    dist.assign(vertexCount, Unreachable);
+    cell.assign(vertexCount, -1);
+    sampleList.clear();
+    heap.clear();
+    rebuildFarthestHeap();
+}
+
+// 过期项累积过多时按当前距离重建最大堆，内存保持在顶点数的常数倍
+void FarthestPointSampler::rebuildFarthestHeap() {
+    farthest.resize(dist.size());
+    for (size_t v = 0; v < dist.size(); ++v) {
+        farthest[v] = HeapEntry(dist[v], static_cast<uint32_t>(v));
+    }
+    std::make_heap(farthest.begin(), farthest.end());
+}
+
+// 从source出发的Dijkstra，只更新能使dist变小的顶点，并把它们划入label单元；返回划入的顶点数
+size_t FarthestPointSampler::relax(uint32_t source, int label) {
+    size_t claimed = 1;
+    heap.clear();
+    dist[source] = 0.0f;
+    cell[source] = label;
+    heap.emplace_back(0.0f, source);
+    farthest.emplace_back(0.0f, source);
+    std::push_heap(farthest.begin(), farthest.end());
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        auto [d, u] = heap.back();
+        heap.pop_back();
+        if (d > dist[u]) continue;
+
+        for (uint32_t a = graph->begin(u); a < graph->end(u); ++a) {
+            uint32_t v = graph->neighbors[a];
+            float dv = d + graph->weights[a];
+            if (dv < dist[v]) {
+                if (cell[v] != label) ++claimed;
+                dist[v] = dv;
+                cell[v] = label;
+                heap.emplace_back(dv, v);
+                std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+                farthest.emplace_back(dv, v);
+                std::push_heap(farthest.begin(), farthest.end());
+            }
+        }
+    }
+    return claimed;
+}
+
+uint32_t FarthestPointSampler::farthestVertex() {
+    if (farthest.size() > 4 * dist.size()) {
+        rebuildFarthestHeap();
+    }
+    // 距离只会减小，键值仍等于当前距离的项即为最新
+    while (farthest.front().first != dist[farthest.front().second]) {
+        std::pop_heap(farthest.begin(), farthest.end());
+        farthest.pop_back();
+    }
+    return farthest.front().second;
+}
+
+size_t FarthestPointSampler::addSample(uint32_t v) {
+    if (empty() || v >= dist.size()) return 0;
+    const int label = static_cast<int>(sampleList.size());
+    sampleList.push_back(v);
+    return relax(v, label);
+}
+
+void FarthestPointSampler::sample(size_t count, uint32_t seed) {
+    if (empty()) return;
+    count = std::min(count, dist.size());
+    if (sampleList.empty() && count > 0) {
+        // 先求离seed最远的点作为第一个样本，再清空距离
+        relax(std::min<uint32_t>(seed, static_cast<uint32_t>(dist.size() - 1)), -1);
+        uint32_t first = farthestVertex();
+        reset(*graph);
+        sampleList.push_back(first);
+        relax(first, 0);
+    }
+    while (sampleList.size() < count) {
+        uint32_t next = farthestVertex();
+        if (dist[next] == 0.0f) break;   // 所有顶点都已是样本
+        sampleList.push_back(next);
+        relax(next, static_cast<int>(sampleList.size() - 1));
+    }
+}
+
+void assignTriangleCells(const std::vector<int>& vertexCells, const std::vector<unsigned int>& triangles,
+                         std::vector<int>& triangleCells) {
+    const size_t triangleCount = triangles.size() / 3;
+    triangleCells.resize(triangleCount);
+    parallel::parallelFor(0, triangleCount, [&](size_t t) {
+        const int a = vertexCells[triangles[t * 3]];
+        const int b = vertexCells[triangles[t * 3 + 1]];
+        const int c = vertexCells[triangles[t * 3 + 2]];
+        triangleCells[t] = (b == c && a != b) ? b : a;
+    });
+}
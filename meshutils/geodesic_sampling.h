@@ -0,0 +1,58 @@
+// geodesic_sampling.h
+#ifndef GEODESIC_SAMPLING_H
+#define GEODESIC_SAMPLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "mesh_graph.h"
+
+// 曲面上的最远点采样与测地Voronoi划分（网格边图上的Dijkstra距离）
+// 每加入一个样本只从它出发做一次Dijkstra，并且只扩展比原最近样本更近的顶点，即新样本的Voronoi单元，
+// 其余区域的距离和单元保持不变；下一个最远点由带惰性删除的最大堆给出，不需要每次扫描全部顶点。
+// 采样k个点的总代价约为所有单元在被切分时的面积之和，均匀采样时约为 O(n log k) 次松弛。
+class FarthestPointSampler
+{
+public:
+    static constexpr float Unreachable = std::numeric_limits<float>::max();
+
+    // 清空样本，所有顶点不可达；graph需在本对象使用期间保持有效
+    void reset(const MeshGraph& graph);
+
+    // 加入样本v，返回划入其单元的顶点数
+    size_t addSample(uint32_t v);
+    // 按最远点采样继续加入样本，直到共count个或所有顶点都已是样本；
+    // 还没有样本时第一个取离seed最远的点
+    void sample(size_t count, uint32_t seed = 0);
+
+    // 离所有样本最远的顶点，不可达（没有样本的连通分量）的顶点优先
+    uint32_t farthestVertex();
+    // 覆盖半径：所有顶点到最近样本的最大距离
+    float coverageRadius() { return empty() ? Unreachable : dist[farthestVertex()]; }
+
+    bool empty() const { return graph == nullptr || dist.empty(); }
+    const std::vector<uint32_t>& samples() const { return sampleList; }
+    const std::vector<float>& distances() const { return dist; }     // 到最近样本的距离
+    const std::vector<int>& cells() const { return cell; }           // 最近样本的序号，不可达为-1
+
+private:
+    typedef std::pair<float, uint32_t> HeapEntry;
+
+    size_t relax(uint32_t source, int label);
+    void rebuildFarthestHeap();
+
+    const MeshGraph* graph = nullptr;
+    std::vector<float> dist;
+    std::vector<int> cell;
+    std::vector<uint32_t> sampleList;
+    std::vector<HeapEntry> heap;        // Dijkstra的最小堆，在样本之间复用
+    std::vector<HeapEntry> farthest;    // 最大堆，键值与dist不一致的项已过期
+};
+
+// 三角形所在的Voronoi单元：三个顶点中至少两个在同一单元时取该单元，否则取第一个顶点的
+void assignTriangleCells(const std::vector<int>& vertexCells, const std::vector<unsigned int>& triangles,
+                         std::vector<int>& triangleCells);
+
+#endif // GEODESIC_SAMPLING_H
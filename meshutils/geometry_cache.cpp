@@ -0,0 +1,90 @@
+// geometry_cache.cpp
+#include "geometry_cache.h"
+#include "parallel_utils.h"
+#include <cmath>
+
+bool GeometryCache::update(const Mesh& mesh, uint64_t version) {
+    if (hasData && cachedVersion == version) return false;
+    rebuild(mesh);
+    cachedVersion = version;
+    return true;
+}
+
+void GeometryCache::clear() {
+    faceArea.clear();
+    cornerAngle.clear();
+    cornerCotan.clear();
+    vertexAngleSum.clear();
+    vertexArea.clear();
+    hasData = false;
+}
+
+void GeometryCache::computeFace(const Mesh& mesh, Mesh::FaceHandle fh) {
+    Mesh::Point normal(0, 0, 0);
+    for (auto h : mesh.fh_range(fh)) {
+        const Mesh::Point& p = mesh.point(mesh.from_vertex_handle(h));
+        const Mesh::Point& next = mesh.point(mesh.to_vertex_handle(h));
+        const Mesh::Point& prev = mesh.point(mesh.from_vertex_handle(mesh.prev_halfedge_handle(h)));
+        normal += p % next;
+
+        // 用atan2(|a×b|, a·b)求角，比对单位向量取acos更稳定
+        Mesh::Point a = next - p;
+        Mesh::Point b = prev - p;
+        double sinTerm = (a % b).norm();
+        double cosTerm = a | b;
+        cornerAngle[h.idx()] = std::atan2(sinTerm, cosTerm);
+        cornerCotan[h.idx()] = sinTerm > 1e-12 ? cosTerm / sinTerm : 0.0;
+    }
+    faceArea[fh.idx()] = 0.5 * normal.norm();
+}
+
+void GeometryCache::computeVertex(const Mesh& mesh, Mesh::VertexHandle vh) {
+    double angleSum = 0.0;
+    double area = 0.0;
+    for (auto h : mesh.voh_range(vh)) {
+        if (mesh.is_boundary(h)) continue;
+        angleSum += cornerAngle[h.idx()];
+        auto fh = mesh.face_handle(h);
+        area += faceArea[fh.idx()] / mesh.valence(fh);
+    }
+    vertexAngleSum[vh.idx()] = angleSum;
+    vertexArea[vh.idx()] = area;
+}
+
+void GeometryCache::rebuild(const Mesh& mesh) {
+    faceArea.assign(mesh.n_faces(), 0.0);
+    cornerAngle.assign(mesh.n_halfedges(), 0.0);
+    cornerCotan.assign(mesh.n_halfedges(), 0.0);
+    vertexAngleSum.assign(mesh.n_vertices(), 0.0);
+    vertexArea.assign(mesh.n_vertices(), 0.0);
+
+    // 按面并行：每个半边只属于一个面，写入互不重叠
+    parallel::parallelFor(0, mesh.n_faces(), [&](size_t f) {
+        computeFace(mesh, Mesh::FaceHandle(static_cast<int>(f)));
+    }, 4096);
+
+    // 按顶点并行累加
+    parallel::parallelFor(0, mesh.n_vertices(), [&](size_t v) {
+        computeVertex(mesh, Mesh::VertexHandle(static_cast<int>(v)));
+    }, 4096);
+
+    hasData = true;
+}
+
+void GeometryCache::updateFaces(const Mesh& mesh, const std::vector<Mesh::FaceHandle>& faces, uint64_t version) {
+    if (!hasData || faceArea.size() != mesh.n_faces() || cornerAngle.size() != mesh.n_halfedges()) {
+        update(mesh, version);
+        return;
+    }
+
+    // 先重算所有变化面的角和面积，再累加这些面的顶点
+    for (auto fh : faces) {
+        computeFace(mesh, fh);
+    }
+    for (auto fh : faces) {
+        for (auto vh : mesh.fv_range(fh)) {
+            computeVertex(mesh, vh);
+        }
+    }
+    cachedVersion = version;
+}
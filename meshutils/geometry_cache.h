@@ -0,0 +1,56 @@
+// geometry_cache.h
+#ifndef GEOMETRY_CACHE_H
+#define GEOMETRY_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include "my_traits.h"
+
+// 网格的逐面/逐角几何量缓存（面积、内角、余切）
+// 一次按面并行的遍历写入以面/半边索引为下标的SoA数组，再按顶点并行累加出顶点量。
+// 由几何版本号判断失效，曲率、参数化畸变、Laplacian、测地线等模块共用，每次编辑只计算一次。
+//
+// 角的约定：半边h对应其所在面中from_vertex(h)处的角，即h与prev(h)之间的夹角。
+// 边界半边（无面）的角量均为0。
+class GeometryCache
+{
+public:
+    // version与上次相同时直接返回false；否则重新计算并返回true
+    bool update(const Mesh& mesh, uint64_t version);
+    // 无版本号的调用方（如参数化窗口）直接重算
+    void rebuild(const Mesh& mesh);
+    // 局部编辑后只重算给定的面及其顶点（网格的面/半边/顶点数不变），并把版本更新为version
+    void updateFaces(const Mesh& mesh, const std::vector<Mesh::FaceHandle>& faces, uint64_t version);
+    void clear();
+
+    bool valid() const { return hasData; }
+    uint64_t version() const { return cachedVersion; }
+
+    // 逐面
+    std::vector<double> faceArea;
+    // 逐半边（即逐角）
+    std::vector<double> cornerAngle;
+    std::vector<double> cornerCotan;
+    // 逐顶点：相邻角之和、重心面积（每个面面积按顶点数均分）
+    std::vector<double> vertexAngleSum;
+    std::vector<double> vertexArea;
+
+    // 半边h在其所在三角形中的对角余切，边界半边为0
+    double oppositeCotan(const Mesh& mesh, Mesh::HalfedgeHandle h) const {
+        return mesh.is_boundary(h) ? 0.0 : cornerCotan[mesh.prev_halfedge_handle(h).idx()];
+    }
+    // 余切Laplacian的边权 (cot α + cot β) / 2
+    double cotanWeight(const Mesh& mesh, Mesh::EdgeHandle e) const {
+        return 0.5 * (oppositeCotan(mesh, mesh.halfedge_handle(e, 0)) +
+                      oppositeCotan(mesh, mesh.halfedge_handle(e, 1)));
+    }
+
+private:
+    void computeFace(const Mesh& mesh, Mesh::FaceHandle fh);
+    void computeVertex(const Mesh& mesh, Mesh::VertexHandle vh);
+
+    bool hasData = false;
+    uint64_t cachedVersion = 0;
+};
+
+#endif // GEOMETRY_CACHE_H
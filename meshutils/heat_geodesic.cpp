@@ -0,0 +1,263 @@
+// heat_geodesic.cpp
+#include "heat_geodesic.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+typedef Eigen::Triplet<double> Triplet;
+
+// Poisson方程的L只有半正定（常数在零空间中），加上很小的质量项使其正定，
+// 对距离的影响只是每个连通分量上的一个常数，随后被源点平移消去
+const double PoissonRegularization = 1e-8;
+
+void sub3(const double* a, const double* b, double* out) {
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+double dot3(const double* a, const double* b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void cross3(const double* a, const double* b, double* out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+int findRoot(std::vector<int>& parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+}
+
+void HeatGeodesic::clear() {
+    triangles.clear();
+    area.clear();
+    gradientBasis.clear();
+    divergenceWeights.clear();
+    mass.clear();
+    cornerOffsets.clear();
+    corners.clear();
+    component.clear();
+    componentCount = 0;
+    time = 0.0;
+    heatSolver.reset();
+    poissonSolver.reset();
+}
+
+bool HeatGeodesic::build(const double* points, size_t vertexCount, const std::vector<unsigned int>& triangleIndices,
+                         double timeScale) {
+    clear();
+    const size_t triangleCount = triangleIndices.size() / 3;
+    if (vertexCount == 0 || triangleCount == 0) return false;
+
+    triangles.assign(triangleIndices.begin(), triangleIndices.begin() + triangleCount * 3);
+    area.resize(triangleCount);
+    gradientBasis.resize(triangleCount * 9);
+    divergenceWeights.resize(triangleCount * 9);
+
+    // 每个三角形独立计算面积、三个角的余切，并写入自己的12个Laplacian三元组：
+    // 角i的余切贡献给对边(j,k)的权重 w = cot/2，L(j,k) = L(k,j) = -w，L(j,j)、L(k,k)各加w。
+    // 查询时的梯度和散度只是这些几何量的线性组合，一并预先算好
+    std::vector<Triplet> triplets(triangleCount * 12);
+    std::vector<double> perimeter(triangleCount);
+    parallel::parallelForRange(0, triangleCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const uint32_t* tri = triangles.data() + t * 3;
+            const double* p[3] = { points + size_t(tri[0]) * 3, points + size_t(tri[1]) * 3,
+                                   points + size_t(tri[2]) * 3 };
+            double e[3][3];   // e[i]为角i的对边，从角i+1指向角i+2
+            perimeter[t] = 0.0;
+            for (int i = 0; i < 3; ++i) {
+                sub3(p[(i + 2) % 3], p[(i + 1) % 3], e[i]);
+                perimeter[t] += std::sqrt(dot3(e[i], e[i]));
+            }
+            double n[3];
+            cross3(e[2], e[0], n);
+            double doubleArea = std::sqrt(dot3(n, n));
+            area[t] = 0.5 * doubleArea;
+
+            double cot[3];
+            Triplet* out = triplets.data() + t * 12;
+            for (int i = 0; i < 3; ++i) {
+                // 从角i出发的两条边为 e[i+2] 与 -e[i+1]，cot = 点积 / 叉积模
+                const double* a = e[(i + 1) % 3];
+                const double* b = e[(i + 2) % 3];
+                cot[i] = doubleArea > 0.0 ? -dot3(a, b) / doubleArea : 0.0;
+
+                uint32_t j = tri[(i + 1) % 3], k = tri[(i + 2) % 3];
+                double w = 0.5 * cot[i];
+                *out++ = Triplet(j, k, -w);
+                *out++ = Triplet(k, j, -w);
+                *out++ = Triplet(j, j, w);
+                *out++ = Triplet(k, k, w);
+            }
+
+            // ∇u ∝ Σ u_i (N × e_i)，只用于归一化后的方向，省去1/2A和法向量的单位化
+            // 角i的散度贡献 1/2 [cotθ_k (e_ij·X) + cotθ_j (e_ik·X)]，其中e_ij = e[k]，e_ik = -e[j]
+            double* basis = gradientBasis.data() + t * 9;
+            double* weights = divergenceWeights.data() + t * 9;
+            for (int i = 0; i < 3; ++i) {
+                const int j = (i + 1) % 3, k = (i + 2) % 3;
+                cross3(n, e[i], basis + i * 3);
+                for (int c = 0; c < 3; ++c) {
+                    weights[i * 3 + c] = 0.5 * (cot[k] * e[k][c] - cot[j] * e[j][c]);
+                }
+            }
+        }
+    }, 2048);
+    // 内部边被两个三角形各计一次，对平均边长没有影响
+    double meanEdge = std::accumulate(perimeter.begin(), perimeter.end(), 0.0) / (triangleCount * 3);
+    time = timeScale * meanEdge * meanEdge;
+
+    // 顶点->角的CSR，质量和散度都按顶点并行累加
+    cornerOffsets.assign(vertexCount + 1, 0);
+    for (uint32_t v : triangles) {
+        ++cornerOffsets[v + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        cornerOffsets[v + 1] += cornerOffsets[v];
+    }
+    corners.resize(triangles.size());
+    {
+        std::vector<uint32_t> cursor(cornerOffsets.begin(), cornerOffsets.end() - 1);
+        for (uint32_t c = 0; c < triangles.size(); ++c) {
+            corners[cursor[triangles[c]]++] = c;
+        }
+    }
+
+    mass.assign(vertexCount, 0.0);
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        double sum = 0.0;
+        for (uint32_t i = cornerOffsets[v]; i < cornerOffsets[v + 1]; ++i) {
+            sum += area[corners[i] / 3];
+        }
+        mass[v] = sum / 3.0;
+    });
+
+    // 连通分量：用于区分不可达顶点，也使每个分量的距离单独平移
+    std::vector<int> parent(vertexCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int a = findRoot(parent, triangles[t * 3]);
+        for (int i = 1; i < 3; ++i) {
+            int b = findRoot(parent, triangles[t * 3 + i]);
+            if (a != b) parent[b] = a;
+        }
+    }
+    component.assign(vertexCount, -1);
+    std::vector<int> rootComponent(vertexCount, -1);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (cornerOffsets[v] == cornerOffsets[v + 1]) continue;
+        int root = findRoot(parent, static_cast<int>(v));
+        if (rootComponent[root] < 0) rootComponent[root] = componentCount++;
+        component[v] = rootComponent[root];
+    }
+
+    // 孤立顶点没有质量，给一个单位对角元避免矩阵奇异，它们的距离总是无穷大
+    const double meanMass = std::accumulate(mass.begin(), mass.end(), 0.0) / vertexCount;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (component[v] < 0) {
+            triplets.emplace_back(v, v, meanMass);
+        }
+    }
+
+    SparseMatrix laplacian(vertexCount, vertexCount);
+    laplacian.setFromTriplets(triplets.begin(), triplets.end());
+    triplets.clear();
+    triplets.shrink_to_fit();
+
+    Eigen::VectorXd massVector = Eigen::Map<const Eigen::VectorXd>(mass.data(), vertexCount);
+    SparseMatrix heatMatrix = laplacian * time;
+    SparseMatrix poissonMatrix = laplacian;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        heatMatrix.coeffRef(v, v) += massVector[v];
+        poissonMatrix.coeffRef(v, v) += PoissonRegularization * massVector[v];
+    }
+
+    // 两个分解互不依赖，同时进行
+    heatSolver.reset(new Eigen::SimplicialLDLT<SparseMatrix>());
+    poissonSolver.reset(new Eigen::SimplicialLDLT<SparseMatrix>());
+    parallel::parallelInvoke(
+        [&]() { heatSolver->compute(heatMatrix); },
+        [&]() { poissonSolver->compute(poissonMatrix); });
+
+    if (heatSolver->info() != Eigen::Success || poissonSolver->info() != Eigen::Success) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool HeatGeodesic::compute(const std::vector<unsigned int>& sources, std::vector<double>& distance) const {
+    const size_t vertexCount = mass.size();
+    if (!heatSolver || !poissonSolver || sources.empty()) return false;
+
+    // 1. 热扩散
+    Eigen::VectorXd delta = Eigen::VectorXd::Zero(vertexCount);
+    for (unsigned int s : sources) {
+        if (s < vertexCount) delta[s] = 1.0;
+    }
+    Eigen::VectorXd u = heatSolver->solve(delta);
+
+    // 2. 每个三角形上归一化的负梯度
+    const size_t triangleCount = area.size();
+    std::vector<double> field(triangleCount * 3, 0.0);
+    parallel::parallelFor(0, triangleCount, [&](size_t t) {
+        const uint32_t* tri = triangles.data() + t * 3;
+        const double* basis = gradientBasis.data() + t * 9;
+        const double u0 = u[tri[0]], u1 = u[tri[1]], u2 = u[tri[2]];
+        double grad[3];
+        for (int c = 0; c < 3; ++c) {
+            grad[c] = u0 * basis[c] + u1 * basis[3 + c] + u2 * basis[6 + c];
+        }
+        double len = std::sqrt(dot3(grad, grad));
+        if (len <= 0.0) return;
+        field[t * 3] = -grad[0] / len;
+        field[t * 3 + 1] = -grad[1] / len;
+        field[t * 3 + 2] = -grad[2] / len;
+    }, 8192);
+
+    // 3. 积分散度，按顶点收集所在角的贡献，各线程互不写冲突
+    Eigen::VectorXd divergence(vertexCount);
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        double sum = 0.0;
+        for (uint32_t c = cornerOffsets[v]; c < cornerOffsets[v + 1]; ++c) {
+            const uint32_t corner = corners[c];
+            sum += dot3(field.data() + size_t(corner / 3) * 3, divergenceWeights.data() + size_t(corner) * 3);
+        }
+        divergence[v] = sum;
+    }, 8192);
+
+    // 4. L为负的余切Laplacian，Δφ = div X 即 L φ = -div X
+    Eigen::VectorXd phi = poissonSolver->solve(-divergence);
+
+    // 每个连通分量按其中源点的平均值平移；没有源点的分量不可达
+    std::vector<double> shift(componentCount, 0.0);
+    std::vector<int> sourceCount(componentCount, 0);
+    for (unsigned int s : sources) {
+        if (s >= vertexCount || component[s] < 0) continue;
+        shift[component[s]] += phi[s];
+        ++sourceCount[component[s]];
+    }
+    distance.resize(vertexCount);
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        int c = component[v];
+        if (c < 0 || sourceCount[c] == 0) {
+            distance[v] = std::numeric_limits<double>::infinity();
+        } else {
+            distance[v] = std::max(0.0, phi[v] - shift[c] / sourceCount[c]);
+        }
+    });
+    return true;
+}
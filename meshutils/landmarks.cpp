@@ -0,0 +1,72 @@
+// landmarks.cpp
+#include "landmarks.h"
+#include "geodesic_sampling.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace {
+
+// 键值与距离表同为float，出堆时的过期判断才不会因舍入误丢顶点
+typedef std::pair<float, uint32_t> HeapEntry;
+
+// 从source出发的完整Dijkstra距离场，dist初始为全Unreachable
+void relaxFrom(const MeshGraph& graph, uint32_t source, std::vector<float>& dist,
+               std::vector<HeapEntry>& heap) {
+    heap.clear();
+    dist[source] = 0.0f;
+    heap.emplace_back(0.0f, source);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        auto [d, u] = heap.back();
+        heap.pop_back();
+        if (d > dist[u]) continue;
+
+        for (uint32_t a = graph.begin(u); a < graph.end(u); ++a) {
+            uint32_t v = graph.neighbors[a];
+            float dv = d + graph.weights[a];
+            if (dv < dist[v]) {
+                dist[v] = dv;
+                heap.emplace_back(dv, v);
+                std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+            }
+        }
+    }
+}
+
+}
+
+void LandmarkTable::clear() {
+    landmarks.clear();
+    distances.clear();
+}
+
+void LandmarkTable::build(const MeshGraph& graph, int landmarkCount) {
+    clear();
+    const size_t vertexCount = graph.vertexCount();
+    if (vertexCount == 0 || landmarkCount <= 0) return;
+    const size_t k = std::min<size_t>(landmarkCount, vertexCount);
+
+    // 最远点采样：第一个地标取离0号顶点最远的点，之后每次取离已选地标最远的点
+    FarthestPointSampler sampler;
+    sampler.reset(graph);
+    sampler.sample(k, 0);
+    landmarks = sampler.samples();
+
+    // 每个地标的完整距离场相互独立，并行计算后转置为顶点主序
+    const size_t count = landmarks.size();
+    std::vector<std::vector<float>> fields(count);
+    parallel::parallelFor(0, count, [&](size_t i) {
+        std::vector<HeapEntry> localHeap;
+        fields[i].assign(vertexCount, Unreachable);
+        relaxFrom(graph, landmarks[i], fields[i], localHeap);
+    }, 1);
+
+    distances.resize(vertexCount * count);
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        for (size_t i = 0; i < count; ++i) {
+            distances[v * count + i] = fields[i][v];
+        }
+    });
+}
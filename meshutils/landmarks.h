@@ -0,0 +1,43 @@
+// landmarks.h
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "mesh_graph.h"
+
+// ALT（A*, Landmarks, Triangle inequality）预处理
+// 用最远点采样选K个地标，再并行地对每个地标跑一次全图Dijkstra，
+// 按顶点主序保存 distances[v*K + i] = d(地标i, v)，查询时一个顶点的K个距离是连续的。
+// 由三角不等式 d(v,t) >= |d(L,t) - d(L,v)| 得到的下界是一致的启发式，可直接替换A*的欧氏距离。
+class LandmarkTable
+{
+public:
+    static constexpr float Unreachable = std::numeric_limits<float>::max();
+
+    void build(const MeshGraph& graph, int landmarkCount);
+    void clear();
+
+    bool empty() const { return landmarks.empty(); }
+    int count() const { return static_cast<int>(landmarks.size()); }
+
+    // v到t的最短路径长度下界，地标与其中一点不连通时忽略该地标
+    float lowerBound(uint32_t v, uint32_t t) const {
+        const size_t k = landmarks.size();
+        const float* dv = distances.data() + size_t(v) * k;
+        const float* dt = distances.data() + size_t(t) * k;
+        float bound = 0.0f;
+        for (size_t i = 0; i < k; ++i) {
+            if (dv[i] == Unreachable || dt[i] == Unreachable) continue;
+            float diff = dt[i] > dv[i] ? dt[i] - dv[i] : dv[i] - dt[i];
+            bound = diff > bound ? diff : bound;
+        }
+        return bound;
+    }
+
+    std::vector<uint32_t> landmarks;
+    std::vector<float> distances;
+};
+
+#endif // LANDMARKS_H
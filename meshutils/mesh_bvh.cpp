@@ -0,0 +1,411 @@
+// mesh_bvh.cpp
+#include "mesh_bvh.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#define MESH_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const int kBinCount = 16;
+const uint32_t kMaxLeafSize = 4;
+// 超过该规模的子树在新线程中构建
+const uint32_t kParallelThreshold = 16384;
+const float kInf = std::numeric_limits<float>::infinity();
+
+struct Aabb {
+    float bmin[3] = { kInf, kInf, kInf };
+    float bmax[3] = { -kInf, -kInf, -kInf };
+
+    void grow(const float* lo, const float* hi) {
+        for (int k = 0; k < 3; ++k) {
+            bmin[k] = std::min(bmin[k], lo[k]);
+            bmax[k] = std::max(bmax[k], hi[k]);
+        }
+    }
+    void grow(const float* p) { grow(p, p); }
+    float area() const {
+        float dx = bmax[0] - bmin[0];
+        float dy = bmax[1] - bmin[1];
+        float dz = bmax[2] - bmin[2];
+        if (dx < 0.0f) return 0.0f;
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+}
+
+struct MeshBVH::BuildContext {
+    std::vector<uint32_t> prims;        // 三角形序号，构建过程中就地划分
+    std::vector<float> centroids;       // 每个三角形3个float
+    std::vector<float> boundsMin;
+    std::vector<float> boundsMax;
+    std::atomic<uint32_t> nodeCount{1};
+    std::atomic<int> maxDepth{0};
+    int maxParallelDepth = 0;
+};
+
+void MeshBVH::clear() {
+    nodes.clear();
+    packets.clear();
+    indices.clear();
+    faceOfTriangle.clear();
+    positions.clear();
+    maxDepth = 0;
+}
+
+void MeshBVH::build(const Mesh& mesh, const std::vector<unsigned int>& triangles,
+                    const std::vector<int>& triangleToFace) {
+    clear();
+    uint32_t triCount = static_cast<uint32_t>(triangles.size() / 3);
+    if (triCount == 0) return;
+
+    indices = triangles;
+    faceOfTriangle = triangleToFace;
+    positions.resize(mesh.n_vertices());
+    parallel::parallelFor(0, positions.size(), [&](size_t i) {
+        const Mesh::Point& p = mesh.point(Mesh::VertexHandle(static_cast<int>(i)));
+        positions[i] = OpenMesh::Vec3f(float(p[0]), float(p[1]), float(p[2]));
+    });
+
+    BuildContext ctx;
+    ctx.prims.resize(triCount);
+    ctx.centroids.resize(triCount * 3);
+    ctx.boundsMin.resize(triCount * 3);
+    ctx.boundsMax.resize(triCount * 3);
+    parallel::parallelFor(0, triCount, [&](size_t t) {
+        ctx.prims[t] = static_cast<uint32_t>(t);
+        const OpenMesh::Vec3f& a = positions[indices[t * 3]];
+        const OpenMesh::Vec3f& b = positions[indices[t * 3 + 1]];
+        const OpenMesh::Vec3f& c = positions[indices[t * 3 + 2]];
+        for (int k = 0; k < 3; ++k) {
+            float lo = std::min({ a[k], b[k], c[k] });
+            float hi = std::max({ a[k], b[k], c[k] });
+            ctx.boundsMin[t * 3 + k] = lo;
+            ctx.boundsMax[t * 3 + k] = hi;
+            ctx.centroids[t * 3 + k] = 0.5f * (lo + hi);
+        }
+    });
+
+    // 节点数上限为2N-1
+    nodes.resize(size_t(triCount) * 2);
+    ctx.maxParallelDepth = 0;
+    while ((1u << ctx.maxParallelDepth) < parallel::threadCount()) {
+        ++ctx.maxParallelDepth;
+    }
+    buildNode(ctx, 0, 0, triCount, 0);
+    nodes.resize(ctx.nodeCount.load());
+    maxDepth = ctx.maxDepth.load();
+
+    // 给叶子分配三角形包，再并行填充SoA数据
+    std::vector<uint32_t> leaves;
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].count > 0) leaves.push_back(i);
+    }
+    packets.resize(leaves.size());
+    parallel::parallelFor(0, leaves.size(), [&](size_t p) {
+        Node& leaf = nodes[leaves[p]];
+        TriPacket& packet = packets[p];
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            if (lane < leaf.count) {
+                uint32_t tri = ctx.prims[leaf.leftOrFirst + lane];
+                const OpenMesh::Vec3f& a = positions[indices[tri * 3]];
+                const OpenMesh::Vec3f& b = positions[indices[tri * 3 + 1]];
+                const OpenMesh::Vec3f& c = positions[indices[tri * 3 + 2]];
+                for (int k = 0; k < 3; ++k) {
+                    packet.v0[k][lane] = a[k];
+                    packet.e1[k][lane] = b[k] - a[k];
+                    packet.e2[k][lane] = c[k] - a[k];
+                }
+                packet.triangle[lane] = tri;
+            } else {
+                for (int k = 0; k < 3; ++k) {
+                    packet.v0[k][lane] = 0.0f;
+                    packet.e1[k][lane] = 0.0f;
+                    packet.e2[k][lane] = 0.0f;
+                }
+                packet.triangle[lane] = 0;
+            }
+        }
+        leaf.leftOrFirst = static_cast<uint32_t>(p);
+    }, 1024);
+}
+
+// 分箱SAH：在三个轴上各划分kBinCount个箱，选代价最小的划分面
+void MeshBVH::buildNode(BuildContext& ctx, uint32_t nodeIndex, uint32_t begin, uint32_t end, int depth) {
+    Node& node = nodes[nodeIndex];
+    uint32_t count = end - begin;
+
+    Aabb bounds, centroidBounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        uint32_t t = ctx.prims[i];
+        bounds.grow(&ctx.boundsMin[t * 3], &ctx.boundsMax[t * 3]);
+        centroidBounds.grow(&ctx.centroids[t * 3]);
+    }
+    for (int k = 0; k < 3; ++k) {
+        node.bmin[k] = bounds.bmin[k];
+        node.bmax[k] = bounds.bmax[k];
+    }
+
+    auto makeLeaf = [&]() {
+        node.leftOrFirst = begin;
+        node.count = count;
+        int deepest = ctx.maxDepth.load(std::memory_order_relaxed);
+        while (depth > deepest && !ctx.maxDepth.compare_exchange_weak(deepest, depth, std::memory_order_relaxed)) {
+        }
+    };
+    if (count <= 2) {
+        makeLeaf();
+        return;
+    }
+
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = kInf;
+    for (int axis = 0; axis < 3; ++axis) {
+        float lo = centroidBounds.bmin[axis];
+        float extent = centroidBounds.bmax[axis] - lo;
+        if (extent <= 0.0f) continue;
+        float binScale = kBinCount / extent;
+
+        Aabb binBounds[kBinCount];
+        uint32_t binCounts[kBinCount] = {};
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t t = ctx.prims[i];
+            int bin = std::min(kBinCount - 1, int((ctx.centroids[t * 3 + axis] - lo) * binScale));
+            binCounts[bin]++;
+            binBounds[bin].grow(&ctx.boundsMin[t * 3], &ctx.boundsMax[t * 3]);
+        }
+
+        // 从右向左累计右侧面积，再从左向右扫描求代价
+        float rightArea[kBinCount];
+        uint32_t rightCount[kBinCount];
+        Aabb acc;
+        uint32_t accCount = 0;
+        for (int b = kBinCount - 1; b > 0; --b) {
+            acc.grow(binBounds[b].bmin, binBounds[b].bmax);
+            accCount += binCounts[b];
+            rightArea[b] = acc.area();
+            rightCount[b] = accCount;
+        }
+        acc = Aabb();
+        accCount = 0;
+        for (int b = 0; b < kBinCount - 1; ++b) {
+            acc.grow(binBounds[b].bmin, binBounds[b].bmax);
+            accCount += binCounts[b];
+            if (accCount == 0 || rightCount[b + 1] == 0) continue;
+            float cost = acc.area() * accCount + rightArea[b + 1] * rightCount[b + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b + 1;
+            }
+        }
+    }
+
+    // 叶子代价：相交测试次数 × 节点面积；小节点在划分不划算时直接成为叶子
+    float leafCost = bounds.area() * count;
+    if (count <= kMaxLeafSize && (bestAxis < 0 || bestCost >= leafCost)) {
+        makeLeaf();
+        return;
+    }
+
+    uint32_t mid;
+    if (bestAxis < 0) {
+        // 所有重心重合，按序号对半分
+        mid = begin + count / 2;
+    } else {
+        float lo = centroidBounds.bmin[bestAxis];
+        float binScale = kBinCount / (centroidBounds.bmax[bestAxis] - lo);
+        auto it = std::partition(ctx.prims.begin() + begin, ctx.prims.begin() + end, [&](uint32_t t) {
+            int bin = std::min(kBinCount - 1, int((ctx.centroids[t * 3 + bestAxis] - lo) * binScale));
+            return bin < bestSplit;
+        });
+        mid = static_cast<uint32_t>(it - ctx.prims.begin());
+        if (mid == begin || mid == end) {
+            mid = begin + count / 2;
+        }
+    }
+
+    uint32_t left = ctx.nodeCount.fetch_add(2);
+    node.leftOrFirst = left;
+    node.count = 0;
+
+    if (count > kParallelThreshold && depth < ctx.maxParallelDepth) {
+        parallel::parallelInvoke(
+            [&]() { buildNode(ctx, left, begin, mid, depth + 1); },
+            [&]() { buildNode(ctx, left + 1, mid, end, depth + 1); });
+    } else {
+        buildNode(ctx, left, begin, mid, depth + 1);
+        buildNode(ctx, left + 1, mid, end, depth + 1);
+    }
+}
+
+// Möller-Trumbore，一次测试包中的4个三角形
+void MeshBVH::intersectPacket(const TriPacket& packet, const BvhRay& ray, float& tBest,
+                              int& triBest, float& uBest, float& vBest) const {
+#ifdef MESH_BVH_SSE
+    const __m128 ox = _mm_set1_ps(ray.origin[0]), oy = _mm_set1_ps(ray.origin[1]), oz = _mm_set1_ps(ray.origin[2]);
+    const __m128 dx = _mm_set1_ps(ray.direction[0]), dy = _mm_set1_ps(ray.direction[1]), dz = _mm_set1_ps(ray.direction[2]);
+    const __m128 e1x = _mm_load_ps(packet.e1[0]), e1y = _mm_load_ps(packet.e1[1]), e1z = _mm_load_ps(packet.e1[2]);
+    const __m128 e2x = _mm_load_ps(packet.e2[0]), e2y = _mm_load_ps(packet.e2[1]), e2z = _mm_load_ps(packet.e2[2]);
+
+    // pvec = dir × e2
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    __m128 mask = _mm_cmpgt_ps(absDet, _mm_set1_ps(1e-12f));
+    if (_mm_movemask_ps(mask) == 0) return;
+    // 无效槽的det为0，用1代替避免产生无穷
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_or_ps(_mm_and_ps(mask, det), _mm_andnot_ps(mask, _mm_set1_ps(1.0f))));
+
+    __m128 tx = _mm_sub_ps(ox, _mm_load_ps(packet.v0[0]));
+    __m128 ty = _mm_sub_ps(oy, _mm_load_ps(packet.v0[1]));
+    __m128 tz = _mm_sub_ps(oz, _mm_load_ps(packet.v0[2]));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+
+    // qvec = tvec × e1
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+    const __m128 zero = _mm_setzero_ps();
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+    mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(tBest)));
+    int bits = _mm_movemask_ps(mask);
+    if (bits == 0) return;
+
+    alignas(16) float ts[4], us[4], vs[4];
+    _mm_store_ps(ts, t);
+    _mm_store_ps(us, u);
+    _mm_store_ps(vs, v);
+    for (int lane = 0; lane < 4; ++lane) {
+        if ((bits & (1 << lane)) && ts[lane] < tBest) {
+            tBest = ts[lane];
+            uBest = us[lane];
+            vBest = vs[lane];
+            triBest = static_cast<int>(packet.triangle[lane]);
+        }
+    }
+#else
+    for (int lane = 0; lane < 4; ++lane) {
+        float e1[3] = { packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane] };
+        float e2[3] = { packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane] };
+        const OpenMesh::Vec3f& d = ray.direction;
+        float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+        float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (std::fabs(det) <= 1e-12f) continue;
+        float invDet = 1.0f / det;
+        float tv[3] = { ray.origin[0] - packet.v0[0][lane], ray.origin[1] - packet.v0[1][lane],
+                        ray.origin[2] - packet.v0[2][lane] };
+        float u = (tv[0] * p[0] + tv[1] * p[1] + tv[2] * p[2]) * invDet;
+        if (u < 0.0f) continue;
+        float q[3] = { tv[1] * e1[2] - tv[2] * e1[1], tv[2] * e1[0] - tv[0] * e1[2], tv[0] * e1[1] - tv[1] * e1[0] };
+        float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * invDet;
+        if (v < 0.0f || u + v > 1.0f) continue;
+        float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+        if (t > 0.0f && t < tBest) {
+            tBest = t;
+            uBest = u;
+            vBest = v;
+            triBest = static_cast<int>(packet.triangle[lane]);
+        }
+    }
+#endif
+}
+
+bool MeshBVH::intersect(const BvhRay& ray, BvhHit& hit) const {
+    hit = BvhHit();
+    if (nodes.empty()) return false;
+
+    float invDir[3];
+    for (int k = 0; k < 3; ++k) {
+        invDir[k] = 1.0f / ray.direction[k];   // 分量为0时得到±inf，slab测试仍然正确
+    }
+
+    // 返回光线进入包围盒的t，未相交返回inf
+    auto slab = [&](const Node& node, float tMax) {
+        float tNear = 0.0f;
+        float tFar = tMax;
+        for (int k = 0; k < 3; ++k) {
+            float t0 = (node.bmin[k] - ray.origin[k]) * invDir[k];
+            float t1 = (node.bmax[k] - ray.origin[k]) * invDir[k];
+            if (t0 > t1) std::swap(t0, t1);
+            tNear = std::max(tNear, t0);
+            tFar = std::min(tFar, t1);
+        }
+        return tNear <= tFar ? tNear : kInf;
+    };
+
+    float tBest = kInf;
+    int triBest = -1;
+    float uBest = 0.0f, vBest = 0.0f;
+
+    // 栈中节点的深度自底向上严格递增，最多maxDepth+1项；SAH不限制树深，
+    // 三角形密度极不均匀时可能超过固定大小的栈，此时改用堆上的栈
+    const int kStackSize = 64;
+    uint32_t localStack[kStackSize];
+    std::vector<uint32_t> heapStack;
+    uint32_t* stack = localStack;
+    if (maxDepth + 1 > kStackSize) {
+        heapStack.resize(size_t(maxDepth) + 1);
+        stack = heapStack.data();
+    }
+    int stackSize = 0;
+    if (slab(nodes[0], tBest) == kInf) return false;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+        if (node.count > 0) {
+            intersectPacket(packets[node.leftOrFirst], ray, tBest, triBest, uBest, vBest);
+            continue;
+        }
+
+        // 先访问较近的子节点，较远的压栈
+        uint32_t left = node.leftOrFirst;
+        uint32_t right = left + 1;
+        float tLeft = slab(nodes[left], tBest);
+        float tRight = slab(nodes[right], tBest);
+        if (tLeft > tRight) {
+            std::swap(tLeft, tRight);
+            std::swap(left, right);
+        }
+        if (tRight != kInf) stack[stackSize++] = right;
+        if (tLeft != kInf) stack[stackSize++] = left;
+    }
+
+    if (triBest < 0) return false;
+
+    hit.triangle = triBest;
+    hit.face = triBest < static_cast<int>(faceOfTriangle.size()) ? faceOfTriangle[triBest] : -1;
+    hit.t = tBest;
+    hit.u = uBest;
+    hit.v = vBest;
+    hit.point = ray.origin + ray.direction * tBest;
+
+    // 三个顶点中离交点最近的一个
+    float bestDist = kInf;
+    for (int corner = 0; corner < 3; ++corner) {
+        unsigned int vi = indices[triBest * 3 + corner];
+        float dist = (positions[vi] - hit.point).sqrnorm();
+        if (dist < bestDist) {
+            bestDist = dist;
+            hit.nearestVertex = static_cast<int>(vi);
+        }
+    }
+    return true;
+}
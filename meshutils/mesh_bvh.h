@@ -0,0 +1,74 @@
+// mesh_bvh.h
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cstdint>
+#include <vector>
+#include "my_traits.h"
+
+// 网格三角形的CPU包围体层次（BVH）
+// 采用分箱SAH构建，顶层子树并行构建；叶子最多4个三角形，按SoA排布，
+// 光线-三角形求交使用SSE一次测试4个三角形。用于拾取，不需要GL上下文。
+
+struct BvhRay {
+    OpenMesh::Vec3f origin;
+    OpenMesh::Vec3f direction;   // 不要求单位长度，t以direction为单位
+};
+
+struct BvhHit {
+    int triangle = -1;       // 三角化后的三角形序号
+    int face = -1;           // 原始面索引
+    int nearestVertex = -1;  // 三角形中离交点最近的顶点
+    float t = 0.0f;
+    float u = 0.0f;          // 重心坐标：交点 = (1-u-v)*v0 + u*v1 + v*v2
+    float v = 0.0f;
+    OpenMesh::Vec3f point;
+
+    bool valid() const { return triangle >= 0; }
+};
+
+class MeshBVH
+{
+public:
+    // triangles为三角化后的顶点索引（每3个一组），triangleToFace为每个三角形对应的原始面
+    void build(const Mesh& mesh, const std::vector<unsigned int>& triangles,
+               const std::vector<int>& triangleToFace);
+    void clear();
+
+    bool empty() const { return nodes.empty(); }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    // 求最近交点，未命中返回false
+    bool intersect(const BvhRay& ray, BvhHit& hit) const;
+
+private:
+    struct Node {
+        float bmin[3];
+        uint32_t leftOrFirst;   // 内部节点：左子节点（右子节点紧随其后）；叶子：三角形包序号
+        float bmax[3];
+        uint32_t count;         // 0表示内部节点，否则为叶子中的三角形数
+    };
+
+    // 4个三角形的SoA包，空槽的边向量为0，求交时行列式为0自动被剔除
+    struct alignas(16) TriPacket {
+        float v0[3][4];
+        float e1[3][4];
+        float e2[3][4];
+        uint32_t triangle[4];
+    };
+
+    struct BuildContext;
+    void buildNode(BuildContext& ctx, uint32_t nodeIndex, uint32_t begin, uint32_t end, int depth);
+    void intersectPacket(const TriPacket& packet, const BvhRay& ray, float& tBest,
+                         int& triBest, float& uBest, float& vBest) const;
+
+    std::vector<Node> nodes;
+    std::vector<TriPacket> packets;
+    std::vector<unsigned int> indices;
+    std::vector<int> faceOfTriangle;
+    std::vector<OpenMesh::Vec3f> positions;
+    int maxDepth = 0;           // 最深叶子的深度（根为0），遍历栈的大小由它决定
+};
+
+#endif // MESH_BVH_H
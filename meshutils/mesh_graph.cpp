@@ -0,0 +1,49 @@
+// mesh_graph.cpp
+#include "mesh_graph.h"
+#include "parallel_utils.h"
+
+void MeshGraph::clear() {
+    offsets.clear();
+    neighbors.clear();
+    weights.clear();
+    px.clear();
+    py.clear();
+    pz.clear();
+}
+
+void MeshGraph::build(const Mesh& mesh) {
+    clear();
+    const size_t vertexCount = mesh.n_vertices();
+    if (vertexCount == 0) return;
+
+    // 度数 -> 前缀和得到每行起点（行内顺序与vv环绕顺序一致）
+    offsets.assign(vertexCount + 1, 0);
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        offsets[v + 1] = static_cast<uint32_t>(mesh.valence(Mesh::VertexHandle(static_cast<int>(v))));
+    });
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    neighbors.resize(offsets[vertexCount]);
+    weights.resize(offsets[vertexCount]);
+    px.resize(vertexCount);
+    py.resize(vertexCount);
+    pz.resize(vertexCount);
+
+    // 各行互不重叠，按顶点并行填充；边长用双精度求出后再存为float
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        Mesh::VertexHandle vh(static_cast<int>(v));
+        const Mesh::Point& p = mesh.point(vh);
+        px[v] = static_cast<float>(p[0]);
+        py[v] = static_cast<float>(p[1]);
+        pz[v] = static_cast<float>(p[2]);
+
+        uint32_t slot = offsets[v];
+        for (auto vv : mesh.vv_range(vh)) {
+            neighbors[slot] = static_cast<uint32_t>(vv.idx());
+            weights[slot] = static_cast<float>((mesh.point(vv) - p).norm());
+            ++slot;
+        }
+    });
+}
@@ -0,0 +1,41 @@
+// mesh_graph.h
+#ifndef MESH_GRAPH_H
+#define MESH_GRAPH_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "my_traits.h"
+
+// 网格顶点邻接图的CSR（压缩稀疏行）快照，供最短路径算法使用
+// 顶点v的邻居为neighbors[offsets[v] .. offsets[v+1])，边长预先算好存在weights的相同下标处；
+// 顶点坐标另存一份SoA的float数组，启发式函数直接读取，不再构造句柄、访问网格属性。
+// 每个几何版本并行构建一次，之后的查询不再经过OpenMesh的环绕迭代器。
+class MeshGraph
+{
+public:
+    void build(const Mesh& mesh);
+    void clear();
+
+    bool empty() const { return offsets.size() < 2; }
+    size_t vertexCount() const { return empty() ? 0 : offsets.size() - 1; }
+    size_t arcCount() const { return neighbors.size(); }   // 有向弧数（每条边两次）
+
+    uint32_t begin(uint32_t v) const { return offsets[v]; }
+    uint32_t end(uint32_t v) const { return offsets[v + 1]; }
+
+    // 两顶点间的欧氏距离（A*启发式）
+    float distance(uint32_t a, uint32_t b) const {
+        float dx = px[a] - px[b];
+        float dy = py[a] - py[b];
+        float dz = pz[a] - pz[b];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+    std::vector<float> weights;
+    std::vector<float> px, py, pz;
+};
+
+#endif // MESH_GRAPH_H
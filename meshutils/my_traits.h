@@ -17,9 +17,6 @@ struct MyTraits : public OpenMesh::DefaultTraits {
 	FaceAttributes(OpenMesh::Attributes::Status);
 	EdgeAttributes(OpenMesh::Attributes::Status);
 	HalfedgeAttributes(OpenMesh::Attributes::Status);
-    VertexTraits {
-        float curvature;
-    };
 };
 
 typedef OpenMesh::PolyMesh_ArrayKernelT<MyTraits> Mesh;
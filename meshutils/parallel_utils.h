@@ -0,0 +1,65 @@
+// parallel_utils.h
+#ifndef PARALLEL_UTILS_H
+#define PARALLEL_UTILS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+// 基于std::thread的简单并行工具，用于网格预处理（BVH构建、曲率等）
+namespace parallel {
+
+// 可用的工作线程数（至少为1）
+inline unsigned int threadCount() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// 把[begin, end)按块均分给各线程，fn(chunkBegin, chunkEnd)在各线程中执行
+// 元素数少于minChunk时直接在调用线程中执行，避免线程创建开销
+template <typename Fn>
+void parallelForRange(size_t begin, size_t end, Fn&& fn, size_t minChunk = 4096) {
+    if (end <= begin) return;
+    size_t total = end - begin;
+    size_t chunks = std::min<size_t>(threadCount(), (total + minChunk - 1) / minChunk);
+    if (chunks <= 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    size_t chunkSize = (total + chunks - 1) / chunks;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t b = begin + c * chunkSize;
+        size_t e = std::min(end, b + chunkSize);
+        if (b >= e) break;
+        workers.emplace_back([&fn, b, e]() { fn(b, e); });
+    }
+    fn(begin, std::min(end, begin + chunkSize));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// 逐元素版本：fn(i)
+template <typename Fn>
+void parallelFor(size_t begin, size_t end, Fn&& fn, size_t minChunk = 4096) {
+    parallelForRange(begin, end, [&fn](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) fn(i);
+    }, minChunk);
+}
+
+// 并行执行两个任务，第二个任务在调用线程中执行
+template <typename FnA, typename FnB>
+void parallelInvoke(FnA&& a, FnB&& b) {
+    auto future = std::async(std::launch::async, std::forward<FnA>(a));
+    b();
+    future.get();
+}
+
+}
+
+#endif // PARALLEL_UTILS_H
@@ -0,0 +1,232 @@
+// principal_curvature.cpp
+#include "principal_curvature.h"
+#include "parallel_utils.h"
+#include <Eigen/Dense>
+#include <cmath>
+
+namespace {
+
+typedef Eigen::Vector3d Vec3;
+
+inline Vec3 loadVec3(const double* data, int index) {
+    return Vec3(data[index * 3], data[index * 3 + 1], data[index * 3 + 2]);
+}
+
+// 面的曲率张量：在面坐标系(t, b)下的第二基本形式 [[ku, kuv], [kuv, kv]]
+struct FaceTensor {
+    Vec3 t = Vec3::Zero();
+    Vec3 b = Vec3::Zero();
+    Vec3 n = Vec3::Zero();
+    double ku = 0.0, kuv = 0.0, kv = 0.0;
+    double area = 0.0;
+    int valence = 0;
+};
+
+// 与法线垂直的任意单位切向量
+Vec3 anyTangent(const Vec3& n) {
+    Vec3 axis = std::abs(n.x()) < 0.9 ? Vec3::UnitX() : Vec3::UnitY();
+    return n.cross(axis).normalized();
+}
+
+// 旋转坐标系(u, v)，使其法线与newNorm一致（最小旋转）
+void rotateCoordSystem(const Vec3& u, const Vec3& v, const Vec3& newNorm, Vec3& newU, Vec3& newV) {
+    newU = u;
+    newV = v;
+    Vec3 oldNorm = u.cross(v);
+    double ndot = oldNorm.dot(newNorm);
+    if (ndot <= -1.0) {
+        newU = -newU;
+        newV = -newV;
+        return;
+    }
+    Vec3 perpOld = newNorm - ndot * oldNorm;
+    Vec3 dperp = (oldNorm + newNorm) / (1.0 + ndot);
+    newU -= dperp * newU.dot(perpOld);
+    newV -= dperp * newV.dot(perpOld);
+}
+
+void fitFaceTensor(const double* points, const double* normals, const int* verts, int count, FaceTensor& face) {
+    face.valence = count;
+    if (count < 3) return;
+
+    // Newell法线，同时得到多边形面积
+    Vec3 newell = Vec3::Zero();
+    for (int i = 0; i < count; ++i) {
+        Vec3 p = loadVec3(points, verts[i]);
+        Vec3 q = loadVec3(points, verts[(i + 1) % count]);
+        newell += p.cross(q);
+    }
+    double norm = newell.norm();
+    if (norm <= 0.0) return;
+    face.area = 0.5 * norm;
+    face.n = newell / norm;
+
+    Vec3 e0 = loadVec3(points, verts[1]) - loadVec3(points, verts[0]);
+    face.t = (e0 - face.n * face.n.dot(e0)).normalized();
+    face.b = face.n.cross(face.t);
+
+    // 每条边给出两个方程：II * [e·t, e·b]^T = [dn·t, dn·b]^T，未知数为(ku, kuv, kv)
+    Eigen::Matrix3d AtA = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d Atb = Eigen::Vector3d::Zero();
+    for (int i = 0; i < count; ++i) {
+        int a = verts[i];
+        int c = verts[(i + 1) % count];
+        Vec3 e = loadVec3(points, c) - loadVec3(points, a);
+        Vec3 dn = loadVec3(normals, c) - loadVec3(normals, a);
+        double eu = e.dot(face.t);
+        double ev = e.dot(face.b);
+        double dnu = dn.dot(face.t);
+        double dnv = dn.dot(face.b);
+
+        Eigen::Vector3d row1(eu, ev, 0.0);
+        Eigen::Vector3d row2(0.0, eu, ev);
+        AtA += row1 * row1.transpose() + row2 * row2.transpose();
+        Atb += row1 * dnu + row2 * dnv;
+    }
+
+    Eigen::Vector3d x = AtA.ldlt().solve(Atb);
+    if (!x.allFinite()) return;
+    face.ku = x[0];
+    face.kuv = x[1];
+    face.kv = x[2];
+}
+
+// 把相邻面的张量旋转到顶点切平面坐标系后按面积加权平均，再特征分解
+// forEachFace(add)对每个相邻面调用add(const FaceTensor&)
+template <typename ForEachFace>
+PrincipalCurvature gatherVertexTensor(Vec3 n, ForEachFace&& forEachFace) {
+    PrincipalCurvature pc;
+    if (n.squaredNorm() <= 0.0) return pc;
+    n.normalize();
+    Vec3 u = anyTangent(n);
+    Vec3 w = n.cross(u);
+
+    double ku = 0.0, kuv = 0.0, kv = 0.0, weightSum = 0.0;
+    forEachFace([&](const FaceTensor& face) {
+        if (face.area <= 0.0) return;
+
+        // 把顶点坐标系旋转到面所在平面，再把面张量投影到该坐标系
+        Vec3 ru, rv;
+        rotateCoordSystem(u, w, face.n, ru, rv);
+        double u1 = ru.dot(face.t), v1 = ru.dot(face.b);
+        double u2 = rv.dot(face.t), v2 = rv.dot(face.b);
+
+        double weight = face.area / face.valence;
+        ku += weight * (face.ku * u1 * u1 + face.kuv * (2.0 * u1 * v1) + face.kv * v1 * v1);
+        kuv += weight * (face.ku * u1 * u2 + face.kuv * (u1 * v2 + u2 * v1) + face.kv * v1 * v2);
+        kv += weight * (face.ku * u2 * u2 + face.kuv * (2.0 * u2 * v2) + face.kv * v2 * v2);
+        weightSum += weight;
+    });
+    if (weightSum <= 0.0) return pc;
+
+    Eigen::Matrix2d tensor;
+    tensor << ku / weightSum, kuv / weightSum,
+              kuv / weightSum, kv / weightSum;
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> solver;
+    solver.computeDirect(tensor);
+
+    // 特征值升序：第二个为k1（最大），第一个为k2（最小）
+    Eigen::Vector2d e1 = solver.eigenvectors().col(1);
+    Eigen::Vector2d e2 = solver.eigenvectors().col(0);
+    Vec3 d1 = (e1.x() * u + e1.y() * w).normalized();
+    Vec3 d2 = (e2.x() * u + e2.y() * w).normalized();
+
+    pc.k1 = static_cast<float>(solver.eigenvalues()[1]);
+    pc.k2 = static_cast<float>(solver.eigenvalues()[0]);
+    for (int k = 0; k < 3; ++k) {
+        pc.dir1[k] = static_cast<float>(d1[k]);
+        pc.dir2[k] = static_cast<float>(d2[k]);
+    }
+    return pc;
+}
+
+}
+
+void estimatePrincipalCurvatures(const double* points, const double* normals, size_t vertexCount,
+                                 const std::vector<int>& faceOffsets, const std::vector<int>& faceVertices,
+                                 std::vector<PrincipalCurvature>& out) {
+    out.assign(vertexCount, PrincipalCurvature());
+    if (faceOffsets.size() < 2) return;
+    const size_t faceCount = faceOffsets.size() - 1;
+
+    // 第一步：逐面拟合
+    std::vector<FaceTensor> faceTensors(faceCount);
+    parallel::parallelFor(0, faceCount, [&](size_t f) {
+        fitFaceTensor(points, normals, faceVertices.data() + faceOffsets[f],
+                      faceOffsets[f + 1] - faceOffsets[f], faceTensors[f]);
+    }, 4096);
+
+    // 顶点 -> 相邻面的CSR邻接表
+    std::vector<int> vertexFaceOffsets(vertexCount + 1, 0);
+    for (int v : faceVertices) {
+        vertexFaceOffsets[v + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexFaceOffsets[v + 1] += vertexFaceOffsets[v];
+    }
+    std::vector<int> vertexFaces(faceVertices.size());
+    std::vector<int> cursor(vertexFaceOffsets.begin(), vertexFaceOffsets.end() - 1);
+    for (size_t f = 0; f < faceCount; ++f) {
+        for (int i = faceOffsets[f]; i < faceOffsets[f + 1]; ++i) {
+            vertexFaces[cursor[faceVertices[i]]++] = static_cast<int>(f);
+        }
+    }
+
+    // 第二步：逐顶点收集相邻面的张量，旋转到顶点切平面坐标系后加权平均
+    parallel::parallelFor(0, vertexCount, [&](size_t v) {
+        out[v] = gatherVertexTensor(loadVec3(normals, static_cast<int>(v)), [&](auto&& add) {
+            for (int i = vertexFaceOffsets[v]; i < vertexFaceOffsets[v + 1]; ++i) {
+                add(faceTensors[vertexFaces[i]]);
+            }
+        });
+    }, 4096);
+}
+
+void estimatePrincipalCurvatures(const Mesh& mesh, std::vector<PrincipalCurvature>& out) {
+    if (!mesh.has_vertex_normals() || mesh.n_vertices() == 0) {
+        out.assign(mesh.n_vertices(), PrincipalCurvature());
+        return;
+    }
+
+    std::vector<int> faceOffsets;
+    std::vector<int> faceVertices;
+    faceOffsets.reserve(mesh.n_faces() + 1);
+    faceVertices.reserve(mesh.n_faces() * 3);
+    faceOffsets.push_back(0);
+    for (auto fh : mesh.faces()) {
+        for (auto vh : mesh.fv_range(fh)) {
+            faceVertices.push_back(vh.idx());
+        }
+        faceOffsets.push_back(static_cast<int>(faceVertices.size()));
+    }
+
+    estimatePrincipalCurvatures(mesh.points()->data(), mesh.vertex_normals()->data(), mesh.n_vertices(),
+                                faceOffsets, faceVertices, out);
+}
+
+void updatePrincipalCurvatures(const Mesh& mesh, const std::vector<Mesh::VertexHandle>& vertices,
+                               std::vector<PrincipalCurvature>& out) {
+    if (!mesh.has_vertex_normals() || out.size() != mesh.n_vertices()) {
+        estimatePrincipalCurvatures(mesh, out);
+        return;
+    }
+
+    const double* points = mesh.points()->data();
+    const double* normals = mesh.vertex_normals()->data();
+    parallel::parallelFor(0, vertices.size(), [&](size_t i) {
+        Mesh::VertexHandle vh = vertices[i];
+        std::vector<int> faceVerts;
+        out[vh.idx()] = gatherVertexTensor(loadVec3(normals, vh.idx()), [&](auto&& add) {
+            // 相邻面的张量就地重新拟合，局部编辑时面数很少
+            for (auto fh : mesh.vf_range(vh)) {
+                faceVerts.clear();
+                for (auto fv : mesh.fv_range(fh)) {
+                    faceVerts.push_back(fv.idx());
+                }
+                FaceTensor face;
+                fitFaceTensor(points, normals, faceVerts.data(), static_cast<int>(faceVerts.size()), face);
+                add(face);
+            }
+        });
+    }, 256);
+}
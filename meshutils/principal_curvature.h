@@ -0,0 +1,34 @@
+// principal_curvature.h
+#ifndef PRINCIPAL_CURVATURE_H
+#define PRINCIPAL_CURVATURE_H
+
+#include <cstddef>
+#include <vector>
+#include "my_traits.h"
+
+// 主曲率与主方向估计（Rusinkiewicz 2004，逐面拟合曲率张量）：
+// 1. 每个面用边向量与法线差做最小二乘，拟合面局部坐标系下的第二基本形式（3×3正规方程）；
+// 2. 每个顶点把相邻面的张量旋转到自身切平面坐标系，按面积加权平均；
+// 3. 对2×2张量做特征分解，得到k1 >= k2及对应主方向。
+// 两步都按面/顶点并行，使用Eigen定长矩阵，无动态分配。
+struct PrincipalCurvature {
+    float k1 = 0.0f;                // 最大主曲率
+    float k2 = 0.0f;                // 最小主曲率
+    float dir1[3] = { 0, 0, 0 };    // k1对应的主方向（单位向量）
+    float dir2[3] = { 0, 0, 0 };    // k2对应的主方向
+};
+
+// 多边形面以CSR形式给出：第f个面的顶点为faceVertices[faceOffsets[f] .. faceOffsets[f+1])
+// points/normals为连续存放的xyz，法线需为单位向量
+void estimatePrincipalCurvatures(const double* points, const double* normals, size_t vertexCount,
+                                 const std::vector<int>& faceOffsets, const std::vector<int>& faceVertices,
+                                 std::vector<PrincipalCurvature>& out);
+
+// OpenMesh入口，要求网格已有顶点法线
+void estimatePrincipalCurvatures(const Mesh& mesh, std::vector<PrincipalCurvature>& out);
+
+// 局部编辑后只重新估计给定顶点，out须已按顶点数分配（否则退回全量估计）
+void updatePrincipalCurvatures(const Mesh& mesh, const std::vector<Mesh::VertexHandle>& vertices,
+                               std::vector<PrincipalCurvature>& out);
+
+#endif // PRINCIPAL_CURVATURE_H
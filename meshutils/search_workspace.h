@@ -0,0 +1,92 @@
+// search_workspace.h
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// 可复用的最短路径搜索工作区（Dijkstra/A*）
+// 距离、前驱等数组带代号戳：每次查询只把代号加一，未被本次查询写过的条目视为初值，
+// 不需要O(n)的清零；二叉堆的存储也在查询之间复用。单次查询的开销只与探索区域成正比。
+class SearchWorkspace
+{
+public:
+    typedef std::pair<double, uint32_t> HeapEntry;   // (键值, 顶点)
+
+    // 开始新的查询，顶点数变化时重新分配
+    void reset(size_t vertexCount) {
+        if (stamp.size() != vertexCount) {
+            stamp.assign(vertexCount, 0);
+            dist.resize(vertexCount);
+            score.resize(vertexCount);
+            prev.resize(vertexCount);
+            generation = 0;
+        }
+        // 代号回绕时才整体清零一次
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        heap.clear();
+        touched = 0;
+    }
+
+    bool visited(uint32_t v) const { return stamp[v] == generation; }
+    double distance(uint32_t v) const { return visited(v) ? dist[v] : std::numeric_limits<double>::max(); }
+    double key(uint32_t v) const { return visited(v) ? score[v] : std::numeric_limits<double>::max(); }
+    int parent(uint32_t v) const { return visited(v) ? prev[v] : -1; }
+
+    // 写入顶点的距离、键值（Dijkstra中与距离相同，A*中为f值）和前驱
+    void set(uint32_t v, double d, double k, int p) {
+        if (!visited(v)) {
+            stamp[v] = generation;
+            ++touched;
+        }
+        dist[v] = d;
+        score[v] = k;
+        prev[v] = p;
+    }
+
+    // 最小堆
+    void push(double k, uint32_t v) {
+        heap.emplace_back(k, v);
+        std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+    }
+    HeapEntry pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        HeapEntry top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+    bool heapEmpty() const { return heap.empty(); }
+    // 堆顶键值（可能是已过期的条目，不大于真实最小值），双向搜索的停止判据使用
+    double topKey() const { return heap.empty() ? std::numeric_limits<double>::max() : heap.front().first; }
+
+    // 本次查询写过的顶点数
+    size_t touchedCount() const { return touched; }
+
+    // 沿前驱从end回溯到起点
+    std::vector<unsigned int> tracePath(uint32_t end) const {
+        std::vector<unsigned int> path;
+        for (int current = static_cast<int>(end); current != -1; current = parent(current)) {
+            path.push_back(current);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    std::vector<uint32_t> stamp;
+    std::vector<double> dist;
+    std::vector<double> score;
+    std::vector<int> prev;
+    std::vector<HeapEntry> heap;
+    uint32_t generation = 0;
+    size_t touched = 0;
+};
+
+#endif // SEARCH_WORKSPACE_H
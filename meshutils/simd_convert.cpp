@@ -0,0 +1,341 @@
+// simd_convert.cpp
+#include "simd_convert.h"
+#include <cstring>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SIMD_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+// 标量参考实现，也用于处理SIMD循环剩余的尾部元素
+namespace {
+
+void convertScalar(const double* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+}
+
+void convertScaleScalar(const double* src, float* dst, size_t count, double scale, double bias) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i] * scale + bias);
+    }
+}
+
+void packScalar(const double* points, const double* normals, const float* curvatures,
+                size_t count, const PackingBounds& bounds, PackedVertex* out) {
+    ::packVertices(points, normals, curvatures, count, bounds, out);
+}
+
+}
+
+#ifdef SIMD_CONVERT_X86
+
+namespace {
+
+// ---------------- SSE2 ----------------
+
+void convertSSE2(const double* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+    convertScalar(src + i, dst + i, count - i);
+}
+
+void convertScaleSSE2(const double* src, float* dst, size_t count, double scale, double bias) {
+    const __m128d s = _mm_set1_pd(scale);
+    const __m128d b = _mm_set1_pd(bias);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a0 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(src + i), s), b);
+        __m128d a1 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(src + i + 2), s), b);
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(_mm_cvtpd_ps(a0), _mm_cvtpd_ps(a1)));
+    }
+    convertScaleScalar(src + i, dst + i, count - i, scale, bias);
+}
+
+// 八面体编码，2个法线（双精度）并行；返回量化前的float值 (x0, y0, x1, y1)
+inline __m128 octahedralSSE2(__m128d nx, __m128d ny, __m128d nz) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d zero = _mm_setzero_pd();
+
+    __m128d ax = _mm_andnot_pd(signMask, nx);
+    __m128d ay = _mm_andnot_pd(signMask, ny);
+    __m128d az = _mm_andnot_pd(signMask, nz);
+    __m128d l1 = _mm_add_pd(_mm_add_pd(ax, ay), az);
+    __m128d valid = _mm_cmpgt_pd(l1, zero);   // NaN和零长度均为false
+
+    __m128d x = _mm_div_pd(nx, l1);
+    __m128d y = _mm_div_pd(ny, l1);
+
+    // 下半球折叠：(1 - |y|) * sign(x), (1 - |x|) * sign(y)，sign(0) = +1
+    __m128d signX = _mm_or_pd(_mm_and_pd(_mm_cmplt_pd(x, zero), signMask), one);
+    __m128d signY = _mm_or_pd(_mm_and_pd(_mm_cmplt_pd(y, zero), signMask), one);
+    __m128d fx = _mm_mul_pd(_mm_sub_pd(one, _mm_andnot_pd(signMask, y)), signX);
+    __m128d fy = _mm_mul_pd(_mm_sub_pd(one, _mm_andnot_pd(signMask, x)), signY);
+
+    __m128d lower = _mm_cmplt_pd(nz, zero);
+    x = _mm_or_pd(_mm_and_pd(lower, fx), _mm_andnot_pd(lower, x));
+    y = _mm_or_pd(_mm_and_pd(lower, fy), _mm_andnot_pd(lower, y));
+    x = _mm_and_pd(valid, x);
+    y = _mm_and_pd(valid, y);
+
+    __m128 xf = _mm_cvtpd_ps(x);
+    __m128 yf = _mm_cvtpd_ps(y);
+    return _mm_unpacklo_ps(xf, yf);
+}
+
+// 与quantizeSnorm16一致：clamp到[-1,1]后四舍五入（远离零）
+inline __m128i quantizeSnormSSE2(__m128 v) {
+    v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    v = _mm_mul_ps(v, _mm_set1_ps(32767.0f));
+    __m128 half = _mm_or_ps(_mm_and_ps(v, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f));
+    return _mm_cvttps_epi32(_mm_add_ps(v, half));
+}
+
+// 与quantizeUnorm16一致：clamp到[0,1]，乘65535加0.5后截断；非有限值为0
+inline __m128i quantizeUnormSSE2(__m128 v) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 finite = _mm_cmplt_ps(_mm_and_ps(v, absMask), _mm_set1_ps(INFINITY));
+    v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    v = _mm_and_ps(v, finite);
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f)));
+}
+
+void packSSE2(const double* points, const double* normals, const float* curvatures,
+              size_t count, const PackingBounds& bounds, PackedVertex* out) {
+    const __m128 offset = _mm_setr_ps(bounds.offset[0], bounds.offset[1], bounds.offset[2], 0.0f);
+    const __m128 invScale = _mm_setr_ps(1.0f / bounds.scale[0], 1.0f / bounds.scale[1], 1.0f / bounds.scale[2], 0.0f);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        alignas(16) int32_t pos[8];
+        alignas(16) int32_t nrm[4] = {0, 0, 0, 0};
+        alignas(16) int32_t crv[4] = {0, 0, 0, 0};
+
+        // 位置：每个顶点一个xyz0向量（float，与标量实现相同的运算顺序）
+        for (int k = 0; k < 2; ++k) {
+            const double* p = points + (i + k) * 3;
+            __m128 xy = _mm_cvtpd_ps(_mm_loadu_pd(p));
+            __m128 z = _mm_cvtpd_ps(_mm_load_sd(p + 2));
+            __m128 v = _mm_movelh_ps(xy, z);
+            _mm_store_si128(reinterpret_cast<__m128i*>(pos + k * 4),
+                            quantizeUnormSSE2(_mm_mul_ps(_mm_sub_ps(v, offset), invScale)));
+        }
+
+        if (normals) {
+            const double* n = normals + i * 3;
+            __m128d nx = _mm_setr_pd(n[0], n[3]);
+            __m128d ny = _mm_setr_pd(n[1], n[4]);
+            __m128d nz = _mm_setr_pd(n[2], n[5]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(nrm), quantizeSnormSSE2(octahedralSSE2(nx, ny, nz)));
+        }
+
+        if (curvatures) {
+            __m128 c = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(curvatures + i)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(crv), quantizeUnormSSE2(c));
+        }
+
+        PackedVertex block[2];
+        for (int k = 0; k < 2; ++k) {
+            block[k].pos[0] = static_cast<uint16_t>(pos[k * 4]);
+            block[k].pos[1] = static_cast<uint16_t>(pos[k * 4 + 1]);
+            block[k].pos[2] = static_cast<uint16_t>(pos[k * 4 + 2]);
+            block[k].normal[0] = static_cast<int16_t>(nrm[k * 2]);
+            block[k].normal[1] = static_cast<int16_t>(nrm[k * 2 + 1]);
+            block[k].curvature = static_cast<uint16_t>(crv[k]);
+        }
+        std::memcpy(out + i, block, sizeof(block));
+    }
+    packScalar(points + i * 3, normals ? normals + i * 3 : nullptr,
+               curvatures ? curvatures + i : nullptr, count - i, bounds, out + i);
+}
+
+// ---------------- AVX2 ----------------
+
+__attribute__((target("avx2")))
+void convertAVX2(const double* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+        _mm256_storeu_ps(dst + i, _mm256_set_m128(hi, lo));
+    }
+    convertScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void convertScaleAVX2(const double* src, float* dst, size_t count, double scale, double bias) {
+    const __m256d s = _mm256_set1_pd(scale);
+    const __m256d b = _mm256_set1_pd(bias);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 lo = _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(src + i), s), b));
+        __m128 hi = _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(src + i + 4), s), b));
+        _mm256_storeu_ps(dst + i, _mm256_set_m128(hi, lo));
+    }
+    convertScaleScalar(src + i, dst + i, count - i, scale, bias);
+}
+
+// 带全1掩码的gather，避免_mm256_i32gather_pd未初始化源操作数的告警
+__attribute__((target("avx2")))
+inline __m256d gatherStride3(const double* base, __m128i stride) {
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, stride, all, 8);
+}
+
+__attribute__((target("avx2")))
+inline __m256d blendMask(__m256d mask, __m256d a, __m256d b) {
+    return _mm256_blendv_pd(b, a, mask);
+}
+
+__attribute__((target("avx2")))
+void packAVX2(const double* points, const double* normals, const float* curvatures,
+              size_t count, const PackingBounds& bounds, PackedVertex* out) {
+    // 每次处理4个顶点，按xyz步长3从AoS数组中gather成SoA
+    const __m128i stride = _mm_setr_epi32(0, 3, 6, 9);
+    const __m128 offX = _mm_set1_ps(bounds.offset[0]);
+    const __m128 offY = _mm_set1_ps(bounds.offset[1]);
+    const __m128 offZ = _mm_set1_ps(bounds.offset[2]);
+    const __m128 invX = _mm_set1_ps(1.0f / bounds.scale[0]);
+    const __m128 invY = _mm_set1_ps(1.0f / bounds.scale[1]);
+    const __m128 invZ = _mm_set1_ps(1.0f / bounds.scale[2]);
+
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const double* p = points + i * 3;
+        __m128 px = _mm256_cvtpd_ps(gatherStride3(p, stride));
+        __m128 py = _mm256_cvtpd_ps(gatherStride3(p + 1, stride));
+        __m128 pz = _mm256_cvtpd_ps(gatherStride3(p + 2, stride));
+        __m128i qx = quantizeUnormSSE2(_mm_mul_ps(_mm_sub_ps(px, offX), invX));
+        __m128i qy = quantizeUnormSSE2(_mm_mul_ps(_mm_sub_ps(py, offY), invY));
+        __m128i qz = quantizeUnormSSE2(_mm_mul_ps(_mm_sub_ps(pz, offZ), invZ));
+
+        __m128i ox = _mm_setzero_si128();
+        __m128i oy = _mm_setzero_si128();
+        if (normals) {
+            const double* n = normals + i * 3;
+            __m256d nx = gatherStride3(n, stride);
+            __m256d ny = gatherStride3(n + 1, stride);
+            __m256d nz = gatherStride3(n + 2, stride);
+
+            __m256d l1 = _mm256_add_pd(_mm256_add_pd(_mm256_andnot_pd(signMask, nx),
+                                                     _mm256_andnot_pd(signMask, ny)),
+                                       _mm256_andnot_pd(signMask, nz));
+            __m256d valid = _mm256_cmp_pd(l1, zero, _CMP_GT_OQ);
+            __m256d x = _mm256_div_pd(nx, l1);
+            __m256d y = _mm256_div_pd(ny, l1);
+
+            __m256d signX = _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ), signMask), one);
+            __m256d signY = _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(y, zero, _CMP_LT_OQ), signMask), one);
+            __m256d fx = _mm256_mul_pd(_mm256_sub_pd(one, _mm256_andnot_pd(signMask, y)), signX);
+            __m256d fy = _mm256_mul_pd(_mm256_sub_pd(one, _mm256_andnot_pd(signMask, x)), signY);
+
+            __m256d lower = _mm256_cmp_pd(nz, zero, _CMP_LT_OQ);
+            x = _mm256_and_pd(valid, blendMask(lower, fx, x));
+            y = _mm256_and_pd(valid, blendMask(lower, fy, y));
+
+            ox = quantizeSnormSSE2(_mm256_cvtpd_ps(x));
+            oy = quantizeSnormSSE2(_mm256_cvtpd_ps(y));
+        }
+
+        __m128i qc = _mm_setzero_si128();
+        if (curvatures) {
+            qc = quantizeUnormSSE2(_mm_loadu_ps(curvatures + i));
+        }
+
+        // 32位结果收窄为16位后按PackedVertex布局交错：x y z nx ny c
+        __m128i pxy = _mm_unpacklo_epi16(_mm_packus_epi32(qx, qx), _mm_packus_epi32(qy, qy));   // x0 y0 x1 y1 ...
+        __m128i pzn = _mm_unpacklo_epi16(_mm_packus_epi32(qz, qz), _mm_packs_epi32(ox, ox));    // z0 nx0 z1 nx1 ...
+        __m128i pnc = _mm_unpacklo_epi16(_mm_packs_epi32(oy, oy), _mm_packus_epi32(qc, qc));    // ny0 c0 ny1 c1 ...
+
+        alignas(16) uint32_t xy[4], zn[4], nc[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(xy), pxy);
+        _mm_store_si128(reinterpret_cast<__m128i*>(zn), pzn);
+        _mm_store_si128(reinterpret_cast<__m128i*>(nc), pnc);
+
+        // 组装48字节后一次写出，适合写合并的映射内存
+        alignas(16) uint32_t block[12];
+        for (int k = 0; k < 4; ++k) {
+            block[k * 3] = xy[k];
+            block[k * 3 + 1] = zn[k];
+            block[k * 3 + 2] = nc[k];
+        }
+        std::memcpy(out + i, block, sizeof(block));
+    }
+    packScalar(points + i * 3, normals ? normals + i * 3 : nullptr,
+               curvatures ? curvatures + i : nullptr, count - i, bounds, out + i);
+}
+
+}
+
+#endif // SIMD_CONVERT_X86
+
+Level detectedLevel() {
+#ifdef SIMD_CONVERT_X86
+    static const Level level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+        if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+        return Level::Scalar;
+    }();
+    return level;
+#else
+    return Level::Scalar;
+#endif
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+    case Level::AVX2: return "AVX2";
+    case Level::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+void convertDoubleToFloat(const double* src, float* dst, size_t count) {
+#ifdef SIMD_CONVERT_X86
+    switch (detectedLevel()) {
+    case Level::AVX2: convertAVX2(src, dst, count); return;
+    case Level::SSE2: convertSSE2(src, dst, count); return;
+    default: break;
+    }
+#endif
+    convertScalar(src, dst, count);
+}
+
+void convertScaleDoubleToFloat(const double* src, float* dst, size_t count, double scale, double bias) {
+#ifdef SIMD_CONVERT_X86
+    switch (detectedLevel()) {
+    case Level::AVX2: convertScaleAVX2(src, dst, count, scale, bias); return;
+    case Level::SSE2: convertScaleSSE2(src, dst, count, scale, bias); return;
+    default: break;
+    }
+#endif
+    convertScaleScalar(src, dst, count, scale, bias);
+}
+
+void packVertices(const double* points, const double* normals, const float* curvatures,
+                  size_t count, const PackingBounds& bounds, PackedVertex* out) {
+#ifdef SIMD_CONVERT_X86
+    switch (detectedLevel()) {
+    case Level::AVX2: packAVX2(points, normals, curvatures, count, bounds, out); return;
+    case Level::SSE2: packSSE2(points, normals, curvatures, count, bounds, out); return;
+    default: break;
+    }
+#endif
+    packScalar(points, normals, curvatures, count, bounds, out);
+}
+
+}
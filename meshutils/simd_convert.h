@@ -0,0 +1,33 @@
+// simd_convert.h
+#ifndef SIMD_CONVERT_H
+#define SIMD_CONVERT_H
+
+#include <cstddef>
+#include "vertex_packing.h"
+
+// GPU上传前的向量化转换/打包内核
+// 运行时检测CPU特性，依次选择AVX2、SSE2或标量实现；结果与标量实现一致
+namespace simd {
+
+enum class Level {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// 当前CPU可用的最高指令集（首次调用时检测）
+Level detectedLevel();
+const char* levelName(Level level);
+
+// dst[i] = float(src[i])
+void convertDoubleToFloat(const double* src, float* dst, size_t count);
+// dst[i] = float(src[i] * scale + bias)，计算在双精度下进行
+void convertScaleDoubleToFloat(const double* src, float* dst, size_t count, double scale, double bias);
+
+// 打包顶点，语义同packVertices；out可以直接指向映射的GPU缓冲区
+void packVertices(const double* points, const double* normals, const float* curvatures,
+                  size_t count, const PackingBounds& bounds, PackedVertex* out);
+
+}
+
+#endif // SIMD_CONVERT_H
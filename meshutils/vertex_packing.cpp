@@ -0,0 +1,91 @@
+// vertex_packing.cpp
+#include "vertex_packing.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+inline uint16_t quantizeUnorm16(float v) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return static_cast<uint16_t>(v * 65535.0f + 0.5f);
+}
+
+inline int16_t quantizeSnorm16(float v) {
+    v = std::min(std::max(v, -1.0f), 1.0f);
+    return static_cast<int16_t>(std::lround(v * 32767.0f));
+}
+
+}
+
+PackingBounds packingBoundsFromBox(const double min[3], const double max[3]) {
+    PackingBounds bounds;
+    for (int i = 0; i < 3; ++i) {
+        double extent = max[i] - min[i];
+        bounds.offset[i] = static_cast<float>(min[i]);
+        // 退化方向（如平面网格）保持非零缩放，量化值恒为0
+        bounds.scale[i] = extent > 0.0 ? static_cast<float>(extent) : 1.0f;
+    }
+    return bounds;
+}
+
+PackingBounds computePackingBounds(const double* points, size_t count) {
+    if (count == 0) return PackingBounds();
+
+    double min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+    for (size_t i = 0; i < count; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            min[k] = std::min(min[k], points[i * 3 + k]);
+            max[k] = std::max(max[k], points[i * 3 + k]);
+        }
+    }
+    return packingBoundsFromBox(min, max);
+}
+
+void encodeOctahedral(const double n[3], int16_t out[2]) {
+    double l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+    if (!(l1 > 0.0)) {
+        // 零法线或NaN，编码为+Z
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    double x = n[0] / l1;
+    double y = n[1] / l1;
+    if (n[2] < 0.0) {
+        // 下半球折叠到外侧三角形
+        double fx = (1.0 - std::abs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+        double fy = (1.0 - std::abs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+        x = fx;
+        y = fy;
+    }
+    out[0] = quantizeSnorm16(static_cast<float>(x));
+    out[1] = quantizeSnorm16(static_cast<float>(y));
+}
+
+void packVertices(const double* points, const double* normals, const float* curvatures,
+                  size_t count, const PackingBounds& bounds, PackedVertex* out) {
+    const float invScale[3] = {
+        1.0f / bounds.scale[0], 1.0f / bounds.scale[1], 1.0f / bounds.scale[2]
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        PackedVertex& v = out[i];
+        for (int k = 0; k < 3; ++k) {
+            float p = static_cast<float>(points[i * 3 + k]);
+            v.pos[k] = quantizeUnorm16((p - bounds.offset[k]) * invScale[k]);
+        }
+
+        if (normals) {
+            encodeOctahedral(normals + i * 3, v.normal);
+        } else {
+            v.normal[0] = 0;
+            v.normal[1] = 0;
+        }
+
+        float c = curvatures ? curvatures[i] : 0.0f;
+        v.curvature = std::isfinite(c) ? quantizeUnorm16(c) : 0;
+    }
+}
@@ -0,0 +1,37 @@
+// vertex_packing.h
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include <cstdint>
+#include <cstddef>
+
+// 压缩顶点格式（12字节，原格式为28字节）
+// pos:       相对包围盒量化的16位无符号归一化坐标，着色器中 aPos = posOffset + aPos * posScale
+// normal:    八面体编码的法线，16位有符号归一化
+// curvature: [0,1]标量通道，16位无符号归一化（曲率已改用独立的顶点属性缓冲，此处保留以维持12字节对齐）
+struct PackedVertex {
+    uint16_t pos[3];
+    int16_t normal[2];
+    uint16_t curvature;
+};
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex must be 12 bytes");
+
+// 位置反量化参数，对应着色器中的posOffset/posScale
+struct PackingBounds {
+    float offset[3] = {0.0f, 0.0f, 0.0f};
+    float scale[3] = {1.0f, 1.0f, 1.0f};
+};
+
+// 由包围盒计算反量化参数
+PackingBounds packingBoundsFromBox(const double min[3], const double max[3]);
+// 由连续存放的xyz坐标计算包围盒及反量化参数
+PackingBounds computePackingBounds(const double* points, size_t count);
+
+// 八面体编码单个法线
+void encodeOctahedral(const double n[3], int16_t out[2]);
+
+// 打包顶点，points/normals为连续存放的xyz（normals可为空），curvatures可为空
+void packVertices(const double* points, const double* normals, const float* curvatures,
+                  size_t count, const PackingBounds& bounds, PackedVertex* out);
+
+#endif // VERTEX_PACKING_H
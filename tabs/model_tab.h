@@ -14,6 +14,7 @@
 #include <QSlider>
 #include <QRadioButton>
 #include <QCheckBox>
+#include <QButtonGroup>
 
 // 创建模型标签页
 QWidget* createModelTab(ModelGLWidget* glWidget) {
@@ -60,6 +61,8 @@ QGroupBox* createRenderingModeGroup(ModelGLWidget* glWidget) {
     QRadioButton *gaussianRadio = new QRadioButton("Gaussian Curvature");
     QRadioButton *meanRadio = new QRadioButton("Mean Curvature");
     QRadioButton *maxRadio = new QRadioButton("Max Curvature");
+    QRadioButton *principalMaxRadio = new QRadioButton("Principal k1 (max)");
+    QRadioButton *principalMinRadio = new QRadioButton("Principal k2 (min)");
     
     solidRadio->setChecked(true);
     
@@ -68,6 +71,8 @@ QGroupBox* createRenderingModeGroup(ModelGLWidget* glWidget) {
     layout->addWidget(gaussianRadio);
     layout->addWidget(meanRadio);
     layout->addWidget(maxRadio);
+    layout->addWidget(principalMaxRadio);
+    layout->addWidget(principalMinRadio);
     
     // 连接渲染模式信号
     auto connectMode = [glWidget](QRadioButton* radio, ModelGLWidget::RenderMode mode) {
@@ -81,6 +86,8 @@ QGroupBox* createRenderingModeGroup(ModelGLWidget* glWidget) {
     connectMode(gaussianRadio, ModelGLWidget::GaussianCurvature);
     connectMode(meanRadio, ModelGLWidget::MeanCurvature);
     connectMode(maxRadio, ModelGLWidget::MaxCurvature);
+    connectMode(principalMaxRadio, ModelGLWidget::PrincipalMaxCurvature);
+    connectMode(principalMinRadio, ModelGLWidget::PrincipalMinCurvature);
     
     return group;
 }
@@ -102,8 +109,42 @@ QGroupBox* createDisplayOptionsGroup(ModelGLWidget* glWidget) {
         glWidget->setHideFaces(state == Qt::Checked);
     });
     
+    // 主方向线段：k1红色、k2蓝色
+    QCheckBox *principalCheckbox = new QCheckBox("Show Principal Directions");
+    principalCheckbox->setStyleSheet("color: white;");
+    QObject::connect(principalCheckbox, &QCheckBox::stateChanged, [glWidget](int state) {
+        glWidget->setShowPrincipalDirections(state == Qt::Checked);
+    });
+    
     layout->addWidget(wireframeCheckbox);
     layout->addWidget(faceCheckbox);
+    layout->addWidget(principalCheckbox);
+    return group;
+}
+
+// 创建编辑工具组：选中编辑工具时左键用于编辑，方向键和视图按钮仍可调整视角
+QGroupBox* createEditToolGroup(ModelGLWidget* glWidget) {
+    QGroupBox *group = new QGroupBox("Editing");
+    QVBoxLayout *layout = new QVBoxLayout(group);
+    
+    QRadioButton *viewRadio = new QRadioButton("Rotate View");
+    QRadioButton *moveRadio = new QRadioButton("Drag Vertex");
+    QRadioButton *flipRadio = new QRadioButton("Flip Edge");
+    viewRadio->setChecked(true);
+    
+    QButtonGroup *toolGroup = new QButtonGroup(group);
+    toolGroup->addButton(viewRadio, ModelGLWidget::NoEditTool);
+    toolGroup->addButton(moveRadio, ModelGLWidget::MoveVertexTool);
+    toolGroup->addButton(flipRadio, ModelGLWidget::FlipEdgeTool);
+    
+    layout->addWidget(viewRadio);
+    layout->addWidget(moveRadio);
+    layout->addWidget(flipRadio);
+    
+    QObject::connect(toolGroup, QOverload<QAbstractButton *>::of(&QButtonGroup::buttonClicked),
+        [glWidget, toolGroup](QAbstractButton *button) {
+            glWidget->setEditTool(static_cast<ModelGLWidget::EditTool>(toolGroup->id(button)));
+        });
     return group;
 }
 
@@ -156,6 +197,7 @@ QWidget* createModelControlPanel(ModelGLWidget* glWidget, QLabel* infoLabel, QWi
     layout->addWidget(createModelLoadButton(glWidget, infoLabel, mainWindow));
     layout->addWidget(createRenderingModeGroup(glWidget));
     layout->addWidget(createDisplayOptionsGroup(glWidget));
+    layout->addWidget(createEditToolGroup(glWidget));
     layout->addWidget(createViewResetButton(glWidget));
     layout->addWidget(createCenterViewButton(glWidget));
 
@@ -94,6 +94,65 @@ QWidget* createClearSelectionButton(ShortestPathGLWidget* glWidget) {
     return button;
 }
 
+// 创建区域选择工具组（双击选点/套索/笔刷）
+QWidget* createSelectionToolGroup(ShortestPathGLWidget* glWidget) {
+    QGroupBox *group = new QGroupBox("Selection Tool");
+    QVBoxLayout *groupLayout = new QVBoxLayout(group);
+    
+    QRadioButton *pointRadio = new QRadioButton("Point (double-click)");
+    pointRadio->setChecked(true);
+    QRadioButton *lassoRadio = new QRadioButton("Lasso");
+    QRadioButton *brushRadio = new QRadioButton("Brush");
+    
+    QButtonGroup *toolGroup = new QButtonGroup(group);
+    toolGroup->addButton(pointRadio, ShortestPathGLWidget::PointTool);
+    toolGroup->addButton(lassoRadio, ShortestPathGLWidget::LassoTool);
+    toolGroup->addButton(brushRadio, ShortestPathGLWidget::BrushTool);
+    
+    groupLayout->addWidget(pointRadio);
+    groupLayout->addWidget(lassoRadio);
+    groupLayout->addWidget(brushRadio);
+    
+    // 套索/笔刷作用于顶点或面元
+    QCheckBox *facesCheckbox = new QCheckBox("Select Faces");
+    facesCheckbox->setStyleSheet("color: white;");
+    groupLayout->addWidget(facesCheckbox);
+    
+    QLabel *radiusLabel = new QLabel("Brush Radius: 20");
+    QSlider *radiusSlider = new QSlider(Qt::Horizontal);
+    radiusSlider->setRange(2, 100);
+    radiusSlider->setValue(20);
+    groupLayout->addWidget(radiusLabel);
+    groupLayout->addWidget(radiusSlider);
+    
+    QLabel *countLabel = new QLabel("Selected: 0 vertices, 0 faces");
+    countLabel->setWordWrap(true);
+    groupLayout->addWidget(countLabel);
+    
+    QLabel *hintLabel = new QLabel("Drag to select, Ctrl+drag to deselect");
+    hintLabel->setWordWrap(true);
+    groupLayout->addWidget(hintLabel);
+    
+    QObject::connect(toolGroup, QOverload<QAbstractButton *>::of(&QButtonGroup::buttonClicked),
+        [glWidget, toolGroup](QAbstractButton *button) {
+            glWidget->setSelectionTool(static_cast<ShortestPathGLWidget::SelectionTool>(toolGroup->id(button)));
+        });
+    QObject::connect(facesCheckbox, &QCheckBox::stateChanged, [glWidget](int state) {
+        glWidget->setSelectionTarget(state == Qt::Checked ? ShortestPathGLWidget::SelectFaces
+                                                          : ShortestPathGLWidget::SelectVertices);
+    });
+    QObject::connect(radiusSlider, &QSlider::valueChanged, [glWidget, radiusLabel](int value) {
+        radiusLabel->setText(QString("Brush Radius: %1").arg(value));
+        glWidget->setBrushRadius(value);
+    });
+    QObject::connect(glWidget, &ShortestPathGLWidget::regionSelectionChanged,
+        [countLabel](int vertexCount, int faceCount) {
+            countLabel->setText(QString("Selected: %1 vertices, %2 faces").arg(vertexCount).arg(faceCount));
+        });
+    
+    return group;
+}
+
 // 创建保存拾取图像按钮
 QWidget* createSavePickingImageButton(ShortestPathGLWidget* glWidget) {
     QPushButton *button = new QPushButton("Save Picking Image");
@@ -126,6 +185,103 @@ QWidget* createSavePickingImageButton(ShortestPathGLWidget* glWidget) {
     return button;
 }
 
+// 创建距离场控制组：以所有选中点为源点计算测地距离场
+QWidget* createDistanceFieldGroup(ShortestPathGLWidget* glWidget) {
+    QGroupBox *group = new QGroupBox("Distance Field");
+    QVBoxLayout *groupLayout = new QVBoxLayout(group);
+    
+    QRadioButton *heatRadio = new QRadioButton("Heat method");
+    heatRadio->setChecked(true);
+    QRadioButton *marchingRadio = new QRadioButton("Fast marching");
+    QButtonGroup *methodGroup = new QButtonGroup(group);
+    methodGroup->addButton(heatRadio, ShortestPathGLWidget::HeatMethod);
+    methodGroup->addButton(marchingRadio, ShortestPathGLWidget::FastMarchingMethod);
+    groupLayout->addWidget(heatRadio);
+    groupLayout->addWidget(marchingRadio);
+    
+    // 快速行进法的提前终止距离，按包围盒对角线的百分比，100%为不限制
+    QLabel *limitLabel = new QLabel("Marching Limit: off");
+    QSlider *limitSlider = new QSlider(Qt::Horizontal);
+    limitSlider->setRange(5, 100);
+    limitSlider->setValue(100);
+    limitLabel->setEnabled(false);
+    limitSlider->setEnabled(false);
+    groupLayout->addWidget(limitLabel);
+    groupLayout->addWidget(limitSlider);
+    
+    QPushButton *computeButton = new QPushButton("Compute Distance Field");
+    QPushButton *clearButton = new QPushButton("Clear Distance Field");
+    QLabel *statsLabel = new QLabel("Sources: -, - ms");
+    statsLabel->setWordWrap(true);
+    
+    groupLayout->addWidget(computeButton);
+    groupLayout->addWidget(clearButton);
+    groupLayout->addWidget(statsLabel);
+    
+    QObject::connect(methodGroup, QOverload<QAbstractButton *>::of(&QButtonGroup::buttonClicked),
+        [glWidget, methodGroup, limitLabel, limitSlider](QAbstractButton *button) {
+            const int id = methodGroup->id(button);
+            glWidget->setDistanceMethod(static_cast<ShortestPathGLWidget::DistanceMethod>(id));
+            limitLabel->setEnabled(id == ShortestPathGLWidget::FastMarchingMethod);
+            limitSlider->setEnabled(id == ShortestPathGLWidget::FastMarchingMethod);
+        });
+    QObject::connect(limitSlider, &QSlider::valueChanged, [glWidget, limitLabel](int value) {
+        limitLabel->setText(value >= 100 ? QString("Marching Limit: off")
+                                         : QString("Marching Limit: %1%").arg(value));
+        glWidget->setDistanceLimit(value / 100.0);
+    });
+    QObject::connect(computeButton, &QPushButton::clicked, [glWidget]() {
+        glWidget->computeDistanceField();
+    });
+    QObject::connect(clearButton, &QPushButton::clicked, [glWidget]() {
+        glWidget->clearDistanceField();
+    });
+    QObject::connect(glWidget, &ShortestPathGLWidget::distanceFieldComputed,
+        [statsLabel](int sourceCount, double milliseconds) {
+            statsLabel->setText(QString("Sources: %1, %2 ms").arg(sourceCount).arg(milliseconds, 0, 'f', 2));
+        });
+    
+    return group;
+}
+
+// 测地Voronoi：最远点采样的样本数和计算/清除按钮
+QWidget* createVoronoiGroup(ShortestPathGLWidget* glWidget) {
+    QGroupBox *group = new QGroupBox("Geodesic Voronoi");
+    QVBoxLayout *groupLayout = new QVBoxLayout(group);
+    
+    QLabel *countLabel = new QLabel("Samples: 64");
+    QSlider *countSlider = new QSlider(Qt::Horizontal);
+    countSlider->setRange(2, 2000);
+    countSlider->setValue(64);
+    groupLayout->addWidget(countLabel);
+    groupLayout->addWidget(countSlider);
+    
+    QPushButton *computeButton = new QPushButton("Compute Voronoi Cells");
+    QPushButton *clearButton = new QPushButton("Clear Voronoi Cells");
+    QLabel *statsLabel = new QLabel("Cells: -, - ms");
+    statsLabel->setWordWrap(true);
+    
+    groupLayout->addWidget(computeButton);
+    groupLayout->addWidget(clearButton);
+    groupLayout->addWidget(statsLabel);
+    
+    QObject::connect(countSlider, &QSlider::valueChanged, [countLabel](int value) {
+        countLabel->setText(QString("Samples: %1").arg(value));
+    });
+    QObject::connect(computeButton, &QPushButton::clicked, [glWidget, countSlider]() {
+        glWidget->computeVoronoi(countSlider->value());
+    });
+    QObject::connect(clearButton, &QPushButton::clicked, [glWidget]() {
+        glWidget->clearVoronoi();
+    });
+    QObject::connect(glWidget, &ShortestPathGLWidget::voronoiComputed,
+        [statsLabel](int sampleCount, double milliseconds) {
+            statsLabel->setText(QString("Cells: %1, %2 ms").arg(sampleCount).arg(milliseconds, 0, 'f', 2));
+        });
+    
+    return group;
+}
+
 // 创建最短路径控制面板
 QWidget* createShortestPathControlPanel(ShortestPathGLWidget* glWidget, QLabel* infoLabel, QWidget* mainWindow) {
     QWidget *panel = new QWidget;
@@ -134,6 +290,7 @@ QWidget* createShortestPathControlPanel(ShortestPathGLWidget* glWidget, QLabel*
     // 添加控件组
     layout->addWidget(createShortestPathModelLoadButton(glWidget, infoLabel, mainWindow));
     layout->addWidget(createClearSelectionButton(glWidget));
+    layout->addWidget(createSelectionToolGroup(glWidget));
     
     // 添加算法选择组
     QGroupBox *algorithmGroup = new QGroupBox("Algorithm");
@@ -143,28 +300,61 @@ QWidget* createShortestPathControlPanel(ShortestPathGLWidget* glWidget, QLabel*
     dijkstraRadio->setChecked(true); // 默认选择Dijkstra
     
     QRadioButton *astarRadio = new QRadioButton("A star");
+    QRadioButton *biDijkstraRadio = new QRadioButton("Bidirectional Dijkstra");
+    QRadioButton *biAstarRadio = new QRadioButton("Bidirectional A star");
+    QRadioButton *exactRadio = new QRadioButton("Exact geodesic (ICH)");
+    QRadioButton *flipOutRadio = new QRadioButton("Geodesic (FlipOut)");
     
     QButtonGroup *algorithmGroupBtn = new QButtonGroup(algorithmGroup);
-    algorithmGroupBtn->addButton(dijkstraRadio, 0);
-    algorithmGroupBtn->addButton(astarRadio, 1);
+    algorithmGroupBtn->addButton(dijkstraRadio, ShortestPathGLWidget::Dijkstra);
+    algorithmGroupBtn->addButton(astarRadio, ShortestPathGLWidget::AStar);
+    algorithmGroupBtn->addButton(biDijkstraRadio, ShortestPathGLWidget::BidirectionalDijkstra);
+    algorithmGroupBtn->addButton(biAstarRadio, ShortestPathGLWidget::BidirectionalAStar);
+    algorithmGroupBtn->addButton(exactRadio, ShortestPathGLWidget::ExactGeodesic);
+    algorithmGroupBtn->addButton(flipOutRadio, ShortestPathGLWidget::FlipOutGeodesic);
     
     algorithmLayout->addWidget(dijkstraRadio);
     algorithmLayout->addWidget(astarRadio);
+    algorithmLayout->addWidget(biDijkstraRadio);
+    algorithmLayout->addWidget(biAstarRadio);
+    algorithmLayout->addWidget(exactRadio);
+    algorithmLayout->addWidget(flipOutRadio);
+    
+    // A*的地标（ALT）下界：模型加载后在后台预处理，就绪前沿用欧氏距离
+    QCheckBox *landmarksCheckbox = new QCheckBox("Landmark heuristic (ALT)");
+    landmarksCheckbox->setChecked(true);
+    algorithmLayout->addWidget(landmarksCheckbox);
+    QLabel *landmarksLabel = new QLabel("Landmarks: pending");
+    algorithmLayout->addWidget(landmarksLabel);
+    
+    // 查询统计：确定的顶点数和耗时
+    QLabel *queryStatsLabel = new QLabel("Settled: - nodes, - ms");
+    queryStatsLabel->setWordWrap(true);
+    algorithmLayout->addWidget(queryStatsLabel);
     
     layout->addWidget(algorithmGroup);
     
     // 连接算法选择信号
-    QObject::connect(algorithmGroupBtn, QOverload<QAbstractButton *>::of(&QButtonGroup::buttonClicked), 
-        [glWidget](QAbstractButton *button) {
-            if (button->text() == "Dijkstra") {
-                glWidget->setAlgorithm(ShortestPathGLWidget::Dijkstra);
-            } else if (button->text() == "A star") {
-                glWidget->setAlgorithm(ShortestPathGLWidget::AStar);
-            }
+    QObject::connect(algorithmGroupBtn, QOverload<QAbstractButton *>::of(&QButtonGroup::buttonClicked),
+        [glWidget, algorithmGroupBtn](QAbstractButton *button) {
+            glWidget->setAlgorithm(static_cast<ShortestPathGLWidget::Algorithm>(algorithmGroupBtn->id(button)));
+        });
+    QObject::connect(landmarksCheckbox, &QCheckBox::stateChanged, [glWidget, landmarksLabel](int state) {
+        glWidget->setUseLandmarks(state == Qt::Checked);
+        landmarksLabel->setText(state == Qt::Checked ? "Landmarks: pending" : "Landmarks: off");
+    });
+    QObject::connect(glWidget, &ShortestPathGLWidget::landmarksReadyChanged, [landmarksLabel](bool ready) {
+        if (ready) landmarksLabel->setText("Landmarks: ready");
+    });
+    QObject::connect(glWidget, &ShortestPathGLWidget::pathQueryFinished,
+        [queryStatsLabel](int settledVertices, double milliseconds) {
+            queryStatsLabel->setText(QString("Settled: %1 nodes, %2 ms").arg(settledVertices).arg(milliseconds, 0, 'f', 2));
         });
     
     layout->addWidget(createShortestPathCalculateButton(glWidget));
     layout->addWidget(createSavePickingImageButton(glWidget));
+    layout->addWidget(createDistanceFieldGroup(glWidget));
+    layout->addWidget(createVoronoiGroup(glWidget));
     
     // 添加基本渲染模式组
     QGroupBox *renderingGroup = new QGroupBox("Rendering Mode");